@@ -0,0 +1,140 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "ChordEngine.hpp"
+#include "Trace.hpp"
+
+namespace
+{
+    enum class ActivationMode : unsigned char
+    {
+        Hook,   // low-level keyboard hook and ChordEngine: sees every keystroke on the machine
+        HotKey, // RegisterHotKey: the system matches the chords, nothing of ours runs for other keys
+    };
+
+    // How chord presses reach the app. A backend recognizes the chords and reports a press as the index of
+    // its binding; what happens then (the foreground check and the copy request) is the same for all of them.
+    class ActivationBackend
+    {
+    public:
+        virtual ~ActivationBackend() = default;
+
+        // Starts recognizing chords; chords[i] is reported as binding i. False if the backend cannot serve them.
+        virtual bool start(const std::vector<Chord>& chords) = 0;
+        virtual void stop() noexcept = 0;
+
+        // A target window came to the foreground, or the last one left it. False if the backend can no longer
+        // serve the chords; the caller replaces it.
+        virtual bool onTargetChanged(bool /*hasTarget*/) noexcept { return true; }
+
+        // WM_HOTKEY: the binding of hotkey id, or ChordEngine::noBinding.
+        [[nodiscard]] virtual int onHotKey(int /*id*/) const noexcept { return ChordEngine::noBinding; }
+    };
+
+    // Registered hotkeys are taken away from every other application, so the chords are only registered while
+    // a target window is in the foreground; elsewhere the same keys still reach the application they were meant for.
+    // Api provides bool registerHotKey(int id, const Chord&) and void unregisterHotKey(int id).
+    // A chord is registered once: like ChordEngine::bind(), a later binding with the same chord is ignored, since
+    // registering it again would fail and take every chord down with it.
+    template <class Api>
+    class HotKeyActivation final : public ActivationBackend
+    {
+        Api m_api;
+        // Distinct chords; hotkey id i registers m_chords[i] and reports binding m_bindings[i].
+        std::vector<Chord> m_chords;
+        std::vector<int> m_bindings;
+        bool m_started{};
+        bool m_armed{};
+
+        // Registers every chord, or none.
+        bool arm() noexcept
+        {
+            for (std::size_t i = 0; i < m_chords.size(); i++)
+            {
+                if (!m_api.registerHotKey(static_cast<int>(i), m_chords[i]))
+                {
+                    while (i-- > 0)
+                    {
+                        m_api.unregisterHotKey(static_cast<int>(i));
+                    }
+                    return false;
+                }
+            }
+            m_armed = true;
+            return true;
+        }
+
+        void disarm() noexcept
+        {
+            if (!m_armed)
+                return;
+            for (std::size_t i = 0; i < m_chords.size(); i++)
+            {
+                m_api.unregisterHotKey(static_cast<int>(i));
+            }
+            m_armed = false;
+        }
+
+    public:
+        explicit HotKeyActivation(Api api) noexcept : m_api(std::move(api)) {}
+        ~HotKeyActivation() override { stop(); }
+
+        HotKeyActivation(const HotKeyActivation&) = delete;
+        HotKeyActivation& operator=(const HotKeyActivation&) = delete;
+
+        // Registers the chords once to find out whether another application holds one of them.
+        bool start(const std::vector<Chord>& chords) override
+        {
+            stop();
+            m_chords.clear();
+            m_bindings.clear();
+            for (std::size_t i = 0; i < chords.size(); i++)
+            {
+                auto same = [&](const Chord& chord) {
+                    return chord.vk == chords[i].vk && (chord.modifiers & 0xF) == (chords[i].modifiers & 0xF);
+                };
+                if (auto first = std::find_if(m_chords.begin(), m_chords.end(), same); first != m_chords.end())
+                {
+                    DBGPRINTLN("hotkey binding {} repeats the chord of binding {}, ignored", i, m_bindings[first - m_chords.begin()]);
+                    continue;
+                }
+                m_chords.push_back(chords[i]);
+                m_bindings.push_back(static_cast<int>(i));
+            }
+            if (!arm())
+                return false;
+            disarm();
+            m_started = true;
+            return true;
+        }
+
+        void stop() noexcept override
+        {
+            disarm();
+            m_started = false;
+        }
+
+        // Fails when another application registered one of the chords since start().
+        bool onTargetChanged(bool hasTarget) noexcept override
+        {
+            if (!m_started)
+                return true;
+            if (hasTarget && !m_armed)
+                return arm();
+            if (!hasTarget)
+                disarm();
+            return true;
+        }
+
+        [[nodiscard]]
+        int onHotKey(int id) const noexcept override
+        {
+            if (!m_armed || id < 0 || static_cast<std::size_t>(id) >= m_bindings.size())
+                return ChordEngine::noBinding;
+            return m_bindings[id];
+        }
+    };
+}
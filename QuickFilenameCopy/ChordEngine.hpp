@@ -0,0 +1,332 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    using namespace std::string_view_literals;
+
+    enum ChordModifierFlags : std::uint8_t
+    {
+        CHM_CONTROL = 0x1,
+        CHM_SHIFT = 0x2,
+        CHM_ALT = 0x4,
+        CHM_WIN = 0x8,
+    };
+
+    // A key with the modifiers that must be held, for example Ctrl+Shift+C.
+    struct Chord
+    {
+        std::uint8_t modifiers{}; // combination of ChordModifierFlags
+        std::uint8_t vk{};        // virtual-key code
+    };
+
+    namespace chord_detail
+    {
+        // Virtual-key codes, spelled out so that the engine does not depend on windows.h.
+        enum : std::uint8_t
+        {
+            vkShift = 0x10,
+            vkControl = 0x11,
+            vkMenu = 0x12,
+            vkLWin = 0x5B,
+            vkRWin = 0x5C,
+            vkF1 = 0x70,
+            vkLShift = 0xA0,
+            vkRShift = 0xA1,
+            vkLControl = 0xA2,
+            vkRControl = 0xA3,
+            vkLMenu = 0xA4,
+            vkRMenu = 0xA5,
+        };
+
+        constexpr bool equalsIgnoreCase(std::wstring_view a, std::wstring_view b) noexcept
+        {
+            if (a.size() != b.size())
+                return false;
+            for (std::size_t i = 0; i < a.size(); i++)
+            {
+                auto x = a[i] >= L'a' && a[i] <= L'z' ? a[i] - (L'a' - L'A') : a[i];
+                auto y = b[i] >= L'a' && b[i] <= L'z' ? b[i] - (L'a' - L'A') : b[i];
+                if (x != y)
+                    return false;
+            }
+            return true;
+        }
+
+        struct NamedKey
+        {
+            std::wstring_view name;
+            std::uint8_t vk;
+        };
+
+        constexpr NamedKey namedKeys[] = {
+            { L"Space"sv, 0x20 }, { L"PageUp"sv, 0x21 }, { L"PageDown"sv, 0x22 }, { L"End"sv, 0x23 },
+            { L"Home"sv, 0x24 }, { L"Insert"sv, 0x2D }, { L"Delete"sv, 0x2E },
+        };
+    }
+
+    // Parses "Ctrl+Shift+C": modifiers (Ctrl, Shift, Alt, Win) and one key, a letter, a digit,
+    // F1 to F24 or one of Space, PageUp, PageDown, End, Home, Insert and Delete. Case does not matter.
+    inline std::optional<Chord> parseChord(std::wstring_view text) noexcept
+    {
+        using namespace chord_detail;
+
+        Chord chord;
+        bool hasKey = false;
+        while (!text.empty())
+        {
+            auto plus = text.find(L'+');
+            auto part = text.substr(0, plus);
+            text = plus == std::wstring_view::npos ? std::wstring_view{} : text.substr(plus + 1);
+            while (!part.empty() && part.front() == L' ')
+                part.remove_prefix(1);
+            while (!part.empty() && part.back() == L' ')
+                part.remove_suffix(1);
+
+            if (equalsIgnoreCase(part, L"Ctrl"sv) || equalsIgnoreCase(part, L"Control"sv))
+                chord.modifiers |= CHM_CONTROL;
+            else if (equalsIgnoreCase(part, L"Shift"sv))
+                chord.modifiers |= CHM_SHIFT;
+            else if (equalsIgnoreCase(part, L"Alt"sv))
+                chord.modifiers |= CHM_ALT;
+            else if (equalsIgnoreCase(part, L"Win"sv))
+                chord.modifiers |= CHM_WIN;
+            else if (hasKey || part.empty())
+                return std::nullopt;
+            else
+            {
+                hasKey = true;
+                auto c = part[0];
+                if (part.size() == 1 && ((c >= L'0' && c <= L'9') || (c >= L'A' && c <= L'Z')))
+                    chord.vk = static_cast<std::uint8_t>(c);
+                else if (part.size() == 1 && c >= L'a' && c <= L'z')
+                    chord.vk = static_cast<std::uint8_t>(c - (L'a' - L'A'));
+                else if ((c == L'F' || c == L'f') && part.size() <= 3 && part.size() >= 2)
+                {
+                    unsigned n = 0;
+                    for (auto d : part.substr(1))
+                    {
+                        if (d < L'0' || d > L'9')
+                            return std::nullopt;
+                        n = n * 10 + (d - L'0');
+                    }
+                    if (n < 1 || n > 24)
+                        return std::nullopt;
+                    chord.vk = static_cast<std::uint8_t>(vkF1 + n - 1);
+                }
+                else
+                {
+                    hasKey = false;
+                    for (const auto& key : namedKeys)
+                    {
+                        if (equalsIgnoreCase(part, key.name))
+                        {
+                            chord.vk = key.vk;
+                            hasKey = true;
+                        }
+                    }
+                    if (!hasKey)
+                        return std::nullopt;
+                }
+            }
+        }
+        if (!hasKey)
+            return std::nullopt;
+        return chord;
+    }
+
+    // Matches the key events of a low-level keyboard hook against a set of chords.
+    // The engine follows the modifier keys itself from the same events, so most keystrokes are classified
+    // without asking the system for key state. Everything it needs per key sits in one 32-bit entry
+    // of a 256-entry table: which modifier combinations have a binding on that key, and which
+    // modifier, if any, the key is. A key that is neither is rejected by the first test.
+    // The hook does not see every event, though: nothing reaches it while the secure desktop is up, and
+    // Windows drops hooks that time out. The engine asks the caller to resync() with the system only when its
+    // state is likely to be stale: at the first key-down of a bound key after a gap in the event timestamps or
+    // after invalidate(), and when the modifiers it holds match no binding of a bound key but contain one that
+    // does, as after a lost modifier key-up. Matching a chord, and every other keystroke, goes without a call
+    // into the system.
+    class ChordEngine
+    {
+        // Per virtual-key code: bits 0-15 are the modifier combinations bound on the key,
+        // bits 16-23 the side bit of a modifier key.
+        std::array<std::uint32_t, 256> m_keys{};
+        // Binding of (vk, modifiers), plus one; 0 where nothing is bound.
+        std::array<std::uint8_t, 256 * 16> m_bindings{};
+        // Per virtual-key code: the modifier combinations that are not bound on the key but contain one that is.
+        // Holding one of them when the key goes down may mean that a modifier's key-up was lost.
+        std::array<std::uint16_t, 256> m_supersets{};
+        // Modifier keys held down, one bit per side: left and right are tracked separately.
+        std::uint8_t m_held{};
+        std::uint8_t m_modifiers{};
+        // The key of the last chord reported, while it is held; a key-down of it before its key-up is an autorepeat.
+        std::uint8_t m_chordKey{};
+        bool m_repeat{};
+        // Set by resync() for the event fed next.
+        bool m_confirmed{};
+        // Events may have been lost since the state was last confirmed; see invalidate().
+        bool m_stale{ true };
+        std::uint32_t m_lastTime{};
+
+        enum : std::uint8_t
+        {
+            sideLControl = 0x01,
+            sideRControl = 0x02,
+            sideLShift = 0x04,
+            sideRShift = 0x08,
+            sideLAlt = 0x10,
+            sideRAlt = 0x20,
+            sideLWin = 0x40,
+            sideRWin = 0x80,
+        };
+
+        static constexpr std::uint8_t modifiersOf(std::uint8_t held) noexcept
+        {
+            return static_cast<std::uint8_t>(((held & (sideLControl | sideRControl)) ? CHM_CONTROL : 0)
+                | ((held & (sideLShift | sideRShift)) ? CHM_SHIFT : 0)
+                | ((held & (sideLAlt | sideRAlt)) ? CHM_ALT : 0)
+                | ((held & (sideLWin | sideRWin)) ? CHM_WIN : 0));
+        }
+
+        void setSide(std::uint8_t vk, std::uint8_t side) noexcept
+        {
+            m_keys[vk] |= static_cast<std::uint32_t>(side) << 16;
+        }
+
+    public:
+        static constexpr int noBinding = -1;
+        // The event cannot be classified from the events seen so far: a key that has bindings went down while the
+        // tracked state may be stale. The caller resync()s and feeds the event again.
+        static constexpr int needsResync = -2;
+        // A pause between two events longer than this, in milliseconds, may hide events the hook did not see.
+        static constexpr std::uint32_t staleAfterMs = 1000;
+
+        ChordEngine() noexcept
+        {
+            using namespace chord_detail;
+
+            setSide(vkLControl, sideLControl);
+            setSide(vkRControl, sideRControl);
+            setSide(vkLShift, sideLShift);
+            setSide(vkRShift, sideRShift);
+            setSide(vkLMenu, sideLAlt);
+            setSide(vkRMenu, sideRAlt);
+            setSide(vkLWin, sideLWin);
+            setSide(vkRWin, sideRWin);
+            // Side-less codes only come from injected input; count them as the left key.
+            setSide(vkControl, sideLControl);
+            setSide(vkShift, sideLShift);
+            setSide(vkMenu, sideLAlt);
+        }
+
+        // Compiles the chords into the table; chords[i] reports binding i. A later duplicate is ignored.
+        // At most 255 bindings; chords on modifier keys are ignored.
+        void bind(const std::vector<Chord>& chords) noexcept
+        {
+            for (auto& key : m_keys)
+            {
+                key &= 0xFFFF0000;
+            }
+            m_bindings.fill(0);
+            m_supersets.fill(0);
+
+            for (std::size_t i = 0; i < chords.size() && i < 255; i++)
+            {
+                const auto& chord = chords[i];
+                auto& slot = m_bindings[chord.vk * 16 + (chord.modifiers & 0xF)];
+                if ((m_keys[chord.vk] >> 16) != 0 || slot != 0)
+                    continue;
+                slot = static_cast<std::uint8_t>(i + 1);
+                m_keys[chord.vk] |= 1u << (chord.modifiers & 0xF);
+            }
+
+            for (std::size_t vk = 0; vk < m_keys.size(); vk++)
+            {
+                const auto bound = m_keys[vk] & 0xFFFF;
+                for (unsigned held = 0; held < 16 && bound != 0; held++)
+                {
+                    for (unsigned subset = 0; subset < 16; subset++)
+                    {
+                        if ((bound & (1u << held)) == 0 && (bound & (1u << subset)) != 0 && (subset & held) == subset)
+                            m_supersets[vk] |= static_cast<std::uint16_t>(1u << held);
+                    }
+                }
+            }
+        }
+
+        // Feeds one key event; time is its timestamp in milliseconds (KBDLLHOOKSTRUCT::time), which may wrap.
+        // Returns the binding a key-down completes, noBinding or needsResync.
+        int onKey(std::uint8_t vk, bool down, std::uint32_t time) noexcept
+        {
+            m_stale |= time - m_lastTime > staleAfterMs;
+            m_lastTime = time;
+            const auto key = m_keys[vk];
+            if (key == 0)
+                return noBinding;
+
+            const bool confirmed = m_confirmed;
+            m_confirmed = false;
+            if (const auto side = static_cast<std::uint8_t>(key >> 16))
+            {
+                m_held = static_cast<std::uint8_t>(down ? (m_held | side) : (m_held & ~side));
+                m_modifiers = modifiersOf(m_held);
+                return noBinding;
+            }
+
+            if (!down)
+            {
+                if (vk == m_chordKey)
+                    m_chordKey = 0;
+                return noBinding;
+            }
+            if (m_stale && !confirmed)
+                return needsResync;
+            if ((key & (1u << m_modifiers)) == 0)
+                return (m_supersets[vk] & (1u << m_modifiers)) != 0 && !confirmed ? needsResync : noBinding;
+
+            m_repeat = vk == m_chordKey;
+            m_chordKey = vk;
+            return m_bindings[vk * 16 + m_modifiers] - 1;
+        }
+
+        // Whether the last binding onKey() reported was an autorepeat of a held chord.
+        [[nodiscard]] bool repeated() const noexcept { return m_repeat; }
+
+        // Modifiers currently held, as the engine has seen them.
+        [[nodiscard]] std::uint8_t modifiers() const noexcept { return m_modifiers; }
+
+        // Events may have been lost, for example on a desktop or session switch: the next key-down of a bound key
+        // asks for a resync.
+        void invalidate() noexcept
+        {
+            m_stale = true;
+        }
+
+        // Replaces the tracked key state with what the system reports, isDown(vk) being whether a key is down
+        // before the event that asked for it (GetAsyncKeyState in a low-level hook), and confirms that event.
+        template <class IsDown>
+        void resync(IsDown&& isDown) noexcept
+        {
+            using namespace chord_detail;
+
+            m_held = static_cast<std::uint8_t>((isDown(vkLControl) ? sideLControl : 0)
+                | (isDown(vkRControl) ? sideRControl : 0)
+                | (isDown(vkLShift) ? sideLShift : 0)
+                | (isDown(vkRShift) ? sideRShift : 0)
+                | (isDown(vkLMenu) ? sideLAlt : 0)
+                | (isDown(vkRMenu) ? sideRAlt : 0)
+                | (isDown(vkLWin) ? sideLWin : 0)
+                | (isDown(vkRWin) ? sideRWin : 0));
+            m_modifiers = modifiersOf(m_held);
+            if (m_chordKey != 0 && !isDown(m_chordKey))
+                m_chordKey = 0;
+            m_confirmed = true;
+            m_stale = false;
+        }
+    };
+}
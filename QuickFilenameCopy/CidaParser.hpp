@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    // A CFSTR_SHELLIDLIST block (CIDA): a 32-bit count, count + 1 offsets from the start of the block,
+    // and at each offset an ID list: items that start with their 16-bit size, ended by a zero size.
+    // The first ID list is the folder, absolute; the others are the selected items, relative to it.
+    // ID lists are views of the block including their terminator, ready to be cast to ITEMIDLIST.
+    struct Cida
+    {
+        std::string_view folder;
+        std::vector<std::string_view> children;
+    };
+
+    namespace cida_detail
+    {
+        // Reads unaligned: offsets and item sizes have no alignment guarantee in a block from another process.
+        template <class T>
+        T load(const char* p) noexcept
+        {
+            T value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        // The ID list at offset, or an empty view if it runs past the end of the block.
+        inline std::string_view idListAt(const char* data, std::size_t size, std::size_t offset) noexcept
+        {
+            auto end = offset;
+            for (;;)
+            {
+                if (end > size || size - end < sizeof(std::uint16_t))
+                    return {};
+
+                const auto cb = load<std::uint16_t>(data + end);
+                if (cb == 0)
+                    break;
+                if (cb < sizeof(std::uint16_t) || size - end < cb)
+                    return {};
+                end += cb;
+            }
+            return { data + offset, end + sizeof(std::uint16_t) - offset };
+        }
+    }
+
+    // Splits a CIDA block into views without copying any ID list. Every offset and item size is checked
+    // against size, so a truncated or malformed block is rejected instead of read past its end.
+    // cida is overwritten; reusing it keeps the capacity of children.
+    inline bool parseCida(const void* block, std::size_t size, Cida& cida)
+    {
+        using namespace cida_detail;
+
+        const auto data = static_cast<const char*>(block);
+        cida.folder = {};
+        cida.children.clear();
+
+        if (data == nullptr || size < sizeof(std::uint32_t))
+            return false;
+        const auto count = load<std::uint32_t>(data);
+        // The offsets must fit, which also bounds count by the size of the block.
+        if ((size - sizeof(std::uint32_t)) / sizeof(std::uint32_t) < static_cast<std::size_t>(count) + 1)
+            return false;
+
+        const auto offsets = data + sizeof(std::uint32_t);
+        cida.folder = idListAt(data, size, load<std::uint32_t>(offsets));
+        if (cida.folder.empty())
+            return false;
+
+        cida.children.resize(count);
+        for (std::uint32_t i = 0; i < count; i++)
+        {
+            auto child = idListAt(data, size, load<std::uint32_t>(offsets + (i + 1) * sizeof(std::uint32_t)));
+            if (child.empty())
+            {
+                cida.folder = {};
+                cida.children.clear();
+                return false;
+            }
+            cida.children[i] = child;
+        }
+        return true;
+    }
+
+    // The absolute ID list of a child of cida, for SHGetNameFromIDList: the items of the folder followed by
+    // those of the child and its terminator. Built in buffer, whose capacity is reused from item to item;
+    // the view is valid until the next call.
+    inline std::string_view absoluteIdList(const Cida& cida, std::string_view child, std::vector<char>& buffer)
+    {
+        const auto folderItems = cida.folder.substr(0, cida.folder.size() - sizeof(std::uint16_t));
+        buffer.assign(folderItems.begin(), folderItems.end());
+        buffer.insert(buffer.end(), child.begin(), child.end());
+        return { buffer.data(), buffer.size() };
+    }
+}
@@ -0,0 +1,284 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <string_view>
+
+#include "OutputFormat.hpp"
+#include "SelectionSnapshot.hpp"
+#include "Utf8Transcode.hpp"
+
+namespace
+{
+    using namespace std::string_view_literals;
+
+    // Extra clipboard formats published next to the text.
+    enum ClipboardFormatFlags : unsigned
+    {
+        CBF_HDROP = 0x1,       // CF_HDROP: the paths as a file drop, for pasting files into Explorer or mail clients
+        CBF_HTML = 0x2,        // "HTML Format": the names as a bulleted list, for rich text editors
+        CBF_SHELLIDLIST = 0x4, // CFSTR_SHELLIDLIST: the items as Explorer describes them
+        CBF_UTF8 = 0x8,        // "UTF8_STRING": the text again, encoded as UTF-8
+        CBF_MARKDOWN = 0x10,   // "text/markdown": the names as a Markdown list, UTF-8
+    };
+
+    // Item fields the encoders of the given formats read. CBF_SHELLIDLIST and CBF_UTF8 do not come from the items.
+    constexpr unsigned requiredFieldsOf(unsigned formats) noexcept
+    {
+        return ((formats & CBF_HDROP) ? IFF_PATH | IFF_FILESYSPATH : 0) | ((formats & (CBF_HTML | CBF_MARKDOWN)) ? IFF_NAME : 0);
+    }
+
+    namespace clipboard_detail
+    {
+        inline std::string_view htmlEntityOf(wchar_t c) noexcept
+        {
+            switch (c)
+            {
+            case L'&': return "&amp;"sv;
+            case L'<': return "&lt;"sv;
+            case L'>': return "&gt;"sv;
+            case L'"': return "&quot;"sv;
+            default: return {};
+            }
+        }
+
+        // UTF-8 length of s with &, <, > and " replaced by entities.
+        inline std::size_t htmlLength(std::wstring_view s) noexcept
+        {
+            std::size_t extra = 0;
+            for (auto c : s)
+            {
+                auto entity = htmlEntityOf(c);
+                if (!entity.empty())
+                    extra += entity.size() - 1;
+            }
+            return utf8Length(s) + extra;
+        }
+
+        inline char* writeHtml(std::wstring_view s, char* dest) noexcept
+        {
+            std::size_t run = 0;
+            for (std::size_t i = 0; i < s.size(); i++)
+            {
+                auto entity = htmlEntityOf(s[i]);
+                if (entity.empty())
+                    continue;
+
+                dest = writeUtf8(s.substr(run, i - run), dest);
+                std::memcpy(dest, entity.data(), entity.size());
+                dest += entity.size();
+                run = i + 1;
+            }
+            return writeUtf8(s.substr(run), dest);
+        }
+
+        // Whether s[i] has a meaning in Markdown and is written backslash-escaped: inline markup anywhere,
+        // and at the start of a list item whatever would open a heading, a nested list or a numbered list.
+        constexpr bool isMarkdownSpecial(std::wstring_view s, std::size_t i) noexcept
+        {
+            switch (s[i])
+            {
+            case L'\\': case L'`': case L'*': case L'_': case L'[': case L']': case L'<': case L'>': case L'&': case L'~':
+                return true;
+            case L'#': case L'-': case L'+':
+                return i == 0;
+            case L'.': case L')':
+                if (i == 0 || i > 9) // a list number has one to nine digits
+                    return false;
+                for (std::size_t j = 0; j < i; j++)
+                {
+                    if (s[j] < L'0' || s[j] > L'9')
+                        return false;
+                }
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        inline std::size_t markdownLength(std::wstring_view s) noexcept
+        {
+            std::size_t extra = 0;
+            for (std::size_t i = 0; i < s.size(); i++)
+            {
+                extra += isMarkdownSpecial(s, i);
+            }
+            return utf8Length(s) + extra;
+        }
+
+        inline char* writeMarkdown(std::wstring_view s, char* dest) noexcept
+        {
+            std::size_t run = 0;
+            for (std::size_t i = 0; i < s.size(); i++)
+            {
+                if (!isMarkdownSpecial(s, i))
+                    continue;
+
+                dest = writeUtf8(s.substr(run, i - run), dest);
+                *dest++ = '\\';
+                run = i;
+            }
+            return writeUtf8(s.substr(run), dest);
+        }
+
+        // CF_HDROP lists files: items without a file system path, such as Control Panel entries, are left out.
+        template <class Items>
+        bool isDroppable(const Items& items, std::size_t i) noexcept
+        {
+            if (!(items.flags(i) & SIF_FILESYSTEM))
+                return false;
+            auto [prefix, leaf] = format_detail::pathPartsOf(items, i);
+            return !prefix.empty() || !leaf.empty();
+        }
+
+        inline char* append(char* dest, std::string_view s) noexcept
+        {
+            std::memcpy(dest, s.data(), s.size());
+            return dest + s.size();
+        }
+
+        inline void putUint32(std::byte* dest, std::uint32_t v) noexcept
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                dest[i] = static_cast<std::byte>(v >> (8 * i));
+            }
+        }
+
+        // CF_HTML header with fixed-width offsets, so its length does not depend on them.
+        constexpr std::string_view htmlHeaderTemplate =
+            "Version:0.9\r\nStartHTML:0000000000\r\nEndHTML:0000000000\r\nStartFragment:0000000000\r\nEndFragment:0000000000\r\n"sv;
+        constexpr std::string_view htmlPrefix = "<html><body>\r\n<!--StartFragment--><ul>\r\n"sv;
+        constexpr std::string_view htmlSuffix = "</ul><!--EndFragment-->\r\n</body></html>"sv;
+        constexpr std::string_view htmlItemPrefix = "<li>"sv;
+        constexpr std::string_view htmlItemSuffix = "</li>\r\n"sv;
+        constexpr std::string_view markdownItemPrefix = "- "sv;
+        constexpr std::string_view markdownItemSuffix = "\r\n"sv;
+        constexpr std::size_t dropFilesSize = 20; // DROPFILES: pFiles, pt.x, pt.y, fNC, fWide
+    }
+
+    // Sizes of the extra clipboard formats, measured in one pass over the items.
+    // Each size includes the terminators the format requires.
+    // Items needs flags(i) besides the Items interface of OutputFormat. CBF_HDROP is dropped from formats
+    // when no item has a file system path.
+    struct ClipboardEncodingPlan
+    {
+        unsigned formats{};
+        std::size_t hdropBytes{};
+        std::size_t htmlBytes{};
+        std::size_t markdownBytes{};
+
+        template <class Items>
+        static ClipboardEncodingPlan measure(const Items& items, unsigned formats) noexcept
+        {
+            using namespace clipboard_detail;
+
+            ClipboardEncodingPlan plan{ formats };
+            std::size_t pathChars = 0;
+            std::size_t files = 0;
+            std::size_t htmlItems = 0;
+            std::size_t markdownItems = 0;
+            for (std::size_t i = 0; i < items.size(); i++)
+            {
+                if ((formats & CBF_HDROP) && isDroppable(items, i))
+                {
+                    auto [prefix, leaf] = format_detail::pathPartsOf(items, i);
+                    pathChars += prefix.size() + leaf.size() + 1;
+                    files++;
+                }
+                if (formats & CBF_HTML)
+                    htmlItems += htmlLength(items.name(i));
+                if (formats & CBF_MARKDOWN)
+                    markdownItems += markdownLength(items.name(i));
+            }
+            if (files == 0)
+                plan.formats &= ~CBF_HDROP;
+            if (plan.formats & CBF_HDROP)
+                plan.hdropBytes = dropFilesSize + (pathChars + 1) * sizeof(wchar_t);
+            if (formats & CBF_HTML)
+                plan.htmlBytes = htmlHeaderTemplate.size() + htmlPrefix.size()
+                    + items.size() * (htmlItemPrefix.size() + htmlItemSuffix.size()) + htmlItems + htmlSuffix.size() + 1;
+            if (formats & CBF_MARKDOWN)
+                plan.markdownBytes = items.size() * (markdownItemPrefix.size() + markdownItemSuffix.size()) + markdownItems + 1;
+            return plan;
+        }
+
+        // Fills the blocks of the planned formats in one pass over the items.
+        // hdrop must hold hdropBytes and be suitably aligned for wchar_t, html htmlBytes and markdown markdownBytes.
+        template <class Items>
+        void write(const Items& items, std::byte* hdrop, char* html, char* markdown) const noexcept
+        {
+            using namespace clipboard_detail;
+
+            wchar_t* files{};
+            if (formats & CBF_HDROP)
+            {
+                putUint32(hdrop, static_cast<std::uint32_t>(dropFilesSize));
+                std::memset(hdrop + 4, 0, 12);
+                putUint32(hdrop + 16, 1);
+                files = reinterpret_cast<wchar_t*>(hdrop + dropFilesSize);
+            }
+
+            char* htmlBegin = html;
+            char* fragmentBegin{};
+            if (formats & CBF_HTML)
+            {
+                html = append(html, htmlHeaderTemplate);
+                fragmentBegin = html + htmlPrefix.find("<ul>"sv);
+                html = append(html, htmlPrefix);
+            }
+
+            for (std::size_t i = 0; i < items.size(); i++)
+            {
+                if ((formats & CBF_HDROP) && isDroppable(items, i))
+                {
+                    auto [prefix, leaf] = format_detail::pathPartsOf(items, i);
+                    std::wmemcpy(files, prefix.data(), prefix.size());
+                    files += prefix.size();
+                    std::wmemcpy(files, leaf.data(), leaf.size());
+                    files += leaf.size();
+                    *files++ = L'\0';
+                }
+                if (formats & CBF_HTML)
+                {
+                    html = append(html, htmlItemPrefix);
+                    html = writeHtml(items.name(i), html);
+                    html = append(html, htmlItemSuffix);
+                }
+                if (formats & CBF_MARKDOWN)
+                {
+                    markdown = append(markdown, markdownItemPrefix);
+                    markdown = writeMarkdown(items.name(i), markdown);
+                    markdown = append(markdown, markdownItemSuffix);
+                }
+            }
+
+            if (formats & CBF_HDROP)
+                *files = L'\0';
+            if (formats & CBF_MARKDOWN)
+                *markdown = '\0';
+
+            if (formats & CBF_HTML)
+            {
+                auto fragmentEnd = html + htmlSuffix.find("<!--EndFragment-->"sv);
+                html = append(html, htmlSuffix);
+                *html = '\0';
+
+                char offsets[4][11];
+                std::snprintf(offsets[0], sizeof(offsets[0]), "%010zu", htmlHeaderTemplate.size());
+                std::snprintf(offsets[1], sizeof(offsets[1]), "%010zu", static_cast<std::size_t>(html - htmlBegin));
+                std::snprintf(offsets[2], sizeof(offsets[2]), "%010zu", static_cast<std::size_t>(fragmentBegin - htmlBegin));
+                std::snprintf(offsets[3], sizeof(offsets[3]), "%010zu", static_cast<std::size_t>(fragmentEnd - htmlBegin));
+
+                constexpr std::string_view keys[] = { "StartHTML:"sv, "EndHTML:"sv, "StartFragment:"sv, "EndFragment:"sv };
+                for (int k = 0; k < 4; k++)
+                {
+                    auto pos = htmlHeaderTemplate.find(keys[k]) + keys[k].size();
+                    std::memcpy(htmlBegin + pos, offsets[k], 10);
+                }
+            }
+        }
+    };
+}
@@ -0,0 +1,329 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ItemNameSource.hpp"
+#include "LatencyHistogram.hpp"
+#include "OutputFormat.hpp"
+#include "RenderPlan.hpp"
+#include "SelectionDiffCache.hpp"
+#include "SelectionSnapshot.hpp"
+#include "SimulatedShell.hpp"
+#include "SortOrder.hpp"
+#include "Trace.hpp"
+#include "StdFormat.hpp"
+
+namespace
+{
+    // Benchmarks of single components, each against the approach it replaced, that make up the second half
+    // of a /benchmark report. Every one returns its section of the report.
+    namespace component_benchmark_detail
+    {
+        using namespace std::string_view_literals;
+
+        // The fastest of runs timings of f in nanoseconds, the one least disturbed by the rest of the system.
+        template <class F>
+        std::int64_t fastestOf(std::uint32_t runs, F&& f)
+        {
+            auto fastest = std::numeric_limits<std::int64_t>::max();
+            for (std::uint32_t i = 0; i < std::max<std::uint32_t>(runs, 1); i++)
+            {
+                const auto started = LatencyStats::now();
+                f();
+                fastest = std::min(fastest, LatencyStats::now() - started);
+            }
+            return fastest;
+        }
+
+        inline double perItem(std::int64_t ns, std::size_t items) noexcept
+        {
+            return static_cast<double>(ns) / static_cast<double>(std::max<std::size_t>(items, 1));
+        }
+
+        // How many times faster than baseline a timing is.
+        inline double speedup(std::int64_t baseline, std::int64_t ns) noexcept
+        {
+            return static_cast<double>(baseline) / static_cast<double>(std::max<std::int64_t>(ns, 1));
+        }
+
+        // count simulated items with their names and paths, as the pipeline would have read them.
+        inline SelectionSnapshot simulatedSnapshot(const BenchmarkOptions& options, std::uint32_t count)
+        {
+            auto sized = options;
+            sized.items = count;
+            sized.chunkLatencyUs = 0;
+            SimulatedNameSource source{ sized, IFF_NAME | IFF_PATH };
+            return readAllItems(source, 4096);
+        }
+    }
+
+    // SelectionSnapshot against the std::vector<std::wstring> of names, and of paths when they were read, that
+    // the selection used to be held in: heap bytes of the strings (without allocator overhead, and leaving out
+    // strings short enough to be stored inline) and the time to read every character once, per item.
+    // Part of the main report, next to the size of the snapshot.
+    struct StringVectorComparison
+    {
+        std::size_t bytes;
+        double snapshotNs;
+        double vectorNs;
+    };
+
+    inline StringVectorComparison compareWithStringVectors(const SelectionSnapshot& items)
+    {
+        using namespace component_benchmark_detail;
+
+        auto heapBytes = [](const std::vector<std::wstring>& strings) {
+            auto bytes = strings.capacity() * sizeof(std::wstring);
+            for (const auto& s : strings)
+            {
+                const auto* data = reinterpret_cast<const char*>(s.data());
+                const auto* self = reinterpret_cast<const char*>(&s);
+                if (data < self || data >= self + sizeof(s))
+                    bytes += (s.capacity() + 1) * sizeof(wchar_t);
+            }
+            return bytes;
+        };
+        auto sum = [](std::wstring_view text, std::uint64_t& checksum) {
+            for (auto c : text)
+            {
+                checksum += static_cast<std::uint64_t>(c);
+            }
+        };
+
+        std::vector<std::wstring> names;
+        std::vector<std::wstring> paths;
+        names.reserve(items.size());
+        const bool withPaths = items.size() > 0 && !items.pathParts(0).second.empty();
+        if (withPaths)
+            paths.reserve(items.size());
+        for (std::size_t i = 0; i < items.size(); i++)
+        {
+            names.emplace_back(items.name(i));
+            if (withPaths)
+            {
+                auto [folder, leaf] = items.pathParts(i);
+                paths.emplace_back(std::wstring{ folder }.append(leaf));
+            }
+        }
+
+        std::uint64_t snapshotSum{};
+        const auto snapshotNs = fastestOf(5, [&] {
+            snapshotSum = 0;
+            for (std::size_t i = 0; i < items.size(); i++)
+            {
+                sum(items.name(i), snapshotSum);
+                if (withPaths)
+                {
+                    auto [folder, leaf] = items.pathParts(i);
+                    sum(folder, snapshotSum);
+                    sum(leaf, snapshotSum);
+                }
+            }
+        });
+        std::uint64_t vectorSum{};
+        const auto vectorNs = fastestOf(5, [&] {
+            vectorSum = 0;
+            for (std::size_t i = 0; i < names.size(); i++)
+            {
+                sum(names[i], vectorSum);
+                if (withPaths)
+                    sum(paths[i], vectorSum);
+            }
+        });
+
+        // The sums keep the loops from being optimized away; they agree unless a string was built wrong.
+        return { heapBytes(names) + heapBytes(paths), perItem(snapshotNs, items.size()),
+            snapshotSum == vectorSum ? perItem(vectorNs, items.size()) : -1.0 };
+    }
+
+    // The two-pass render (measure, allocate once, write in place) against what copySelectedItems did before it:
+    // append every name to a growing std::wstring, then copy that into the clipboard block.
+    inline std::wstring renderBenchmarkReport(const BenchmarkOptions& options)
+    {
+        using namespace component_benchmark_detail;
+
+        const OutputFormat format{ BuiltinFormat::Names };
+        std::wstring report = L"render names, two-pass vs append and copy:\r\n";
+        for (std::uint32_t count : { 1000u, 100000u, 1000000u })
+        {
+            const auto items = simulatedSnapshot(options, count);
+            std::size_t twoPassChars{};
+            const auto twoPass = fastestOf(5, [&] {
+                std::vector<wchar_t> block(format.measure(items, 0, items.size()) + 1);
+                *format.write(items, 0, items.size(), block.data()) = L'\0';
+                twoPassChars = block.size();
+            });
+            std::size_t appendChars{};
+            const auto append = fastestOf(5, [&] {
+                std::wstring text;
+                for (std::size_t i = 0; i < items.size(); i++)
+                {
+                    if (i > 0)
+                        text.append(L"\n");
+                    text.append(items.name(i));
+                }
+                std::vector<wchar_t> block(text.size() + 1);
+                std::copy(text.c_str(), text.c_str() + text.size() + 1, block.data());
+                appendChars = block.size();
+            });
+            report += std::format(L"  {:>8} items: two-pass {:.2f} ns/item, append {:.2f} ns/item, {:.2f}x{}\r\n"sv,
+                count, perItem(twoPass, count), perItem(append, count),
+                speedup(append, twoPass),
+                twoPassChars == appendChars ? L""sv : L" (texts differ)"sv);
+        }
+        return report;
+    }
+
+    // RenderPlan and sortedOrder over 1M names split into 1, 2, 4, ... chunks, up to twice the hardware threads.
+    // The parallel algorithms pick their own thread count, so the chunk count is what the sweep controls;
+    // each step reports its throughput and its speedup over the single chunk (the sequential path).
+    inline std::wstring scalingBenchmarkReport(const BenchmarkOptions& options)
+    {
+        using namespace component_benchmark_detail;
+
+        constexpr std::uint32_t count = 1000000;
+        const auto items = simulatedSnapshot(options, count);
+        const OutputFormat format{ BuiltinFormat::Paths };
+        const auto maxChunks = std::max(2 * std::thread::hardware_concurrency(), 2u);
+
+        std::wstring report = std::format(L"render and sort {} paths by chunk count ({} hardware threads):\r\n"sv,
+            count, std::thread::hardware_concurrency());
+        std::int64_t serialRender{};
+        std::int64_t serialSort{};
+        for (std::uint32_t chunks = 1; chunks <= maxChunks; chunks *= 2)
+        {
+            const auto itemsPerChunk = (items.size() + chunks - 1) / chunks;
+            const auto render = fastestOf(5, [&] {
+                RenderPlan plan{ format, items, itemsPerChunk };
+                std::vector<wchar_t> block(plan.size() + 1);
+                *plan.write(block.data()) = L'\0';
+            });
+            const auto sort = fastestOf(5, [&] {
+                sortedOrder(items.size(), itemsPerChunk, [&](std::size_t i, std::vector<wchar_t>& key) {
+                    appendSortKey(SortMode::Natural, sortTextOf(items, i), key);
+                });
+            });
+            if (chunks == 1)
+            {
+                serialRender = render;
+                serialSort = sort;
+            }
+            report += std::format(
+                L"  {:>3} chunks: render {:.1f} M items/s ({:.2f}x), sort {:.1f} M items/s ({:.2f}x)\r\n"sv,
+                chunks, 1e3 / perItem(render, count), speedup(serialRender, render),
+                1e3 / perItem(sort, count), speedup(serialSort, sort));
+        }
+        return report;
+    }
+
+    // A trace record (a clock read and a store into the thread's ring) against what DBGPRINTLN did before it:
+    // std::format the message, with its file and line, into a new string for OutputDebugString, here left out.
+    // Records are written in batches that fit the ring, with the flusher started and stopped around each batch,
+    // so none is dropped; only the record calls are timed.
+    inline std::wstring traceBenchmarkReport()
+    {
+        using namespace component_benchmark_detail;
+
+        constexpr std::uint32_t batches = 200;
+        constexpr std::uint32_t perBatch = 1000;
+        constexpr std::uint32_t count = batches * perBatch;
+
+        auto& log = TraceLog::instance();
+        TraceLog::prepareThread();
+        std::size_t flushed{};
+        std::size_t flushedBytes{};
+        std::int64_t recordNs = std::numeric_limits<std::int64_t>::max();
+        for (std::uint32_t batch = 0; batch < batches; batch++)
+        {
+            log.start([&](const std::string& line) {
+                flushed++;
+                flushedBytes += line.size();
+            });
+            recordNs = std::min(recordNs, fastestOf(1, [&] {
+                for (std::uint32_t i = 0; i < perBatch; i++)
+                {
+                    QFC_TRACE_RECORD("key {:#x} flags {:#x}", i, batch);
+                }
+            }));
+            log.stop();
+        }
+
+        std::size_t formattedBytes{}; // over all five runs
+        const auto formatNs = fastestOf(5, [&] {
+            for (std::uint32_t i = 0; i < perBatch; i++)
+            {
+                const auto line = std::format("{}({}): {}: key {:#x} flags {:#x}\n", __FILE__, __LINE__, __func__, i, 0u);
+                formattedBytes += line.size();
+            }
+        });
+
+        return std::format(L"trace, record vs format per event:\r\n"
+                           L"  record {:.1f} ns, format {:.1f} ns ({:.0f} bytes), {:.1f}x; {} of {} records flushed ({} bytes)\r\n"sv,
+            perItem(recordNs, perBatch), perItem(formatNs, perBatch), static_cast<double>(formattedBytes) / (5.0 * perBatch),
+            speedup(formatNs, recordNs), flushed, count, flushedBytes);
+    }
+
+    // A copy of a 100k-item selection of which 1% changed since the last copy: SelectionDiffCache resolves only
+    // the changed items, where the copy used to re-read the name of every item. Keys stand in for child PIDLs.
+    // Each timed update flips between the two selections, so every one of them sees a 1% change.
+    // Reports both times, the number of resolves of each and the resolve cost above which the diff wins.
+    inline std::wstring selectionDiffBenchmarkReport(const BenchmarkOptions& options)
+    {
+        using namespace component_benchmark_detail;
+
+        constexpr std::uint32_t count = 100000;
+        constexpr std::uint32_t changeEvery = 100;
+        const auto items = simulatedSnapshot(options, 2 * count);
+        auto pidl = [](std::size_t i) { return std::format("pidl{:016x}", i * 0x9E3779B97F4A7C15ull); };
+
+        // Item i of the changed selection is item count + i where i is a multiple of changeEvery.
+        std::vector<std::string> before(count);
+        std::vector<std::string> after(count);
+        std::vector<std::size_t> afterItems(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            afterItems[i] = i % changeEvery == 0 ? count + i : i;
+            before[i] = pidl(i);
+            after[i] = pidl(afterItems[i]);
+        }
+
+        SelectionDiffCache<std::wstring> cache;
+        cache.update(before, [&](std::size_t i) { return std::wstring{ items.name(i) }; });
+        std::size_t resolved{};
+        bool flipped{};
+        const auto diff = fastestOf(6, [&] {
+            flipped = !flipped;
+            const auto stats = flipped
+                ? cache.update(after, [&](std::size_t i) { return std::wstring{ items.name(afterItems[i]) }; })
+                : cache.update(before, [&](std::size_t i) { return std::wstring{ items.name(i) }; });
+            resolved = stats.resolved;
+        });
+
+        std::size_t reread{};
+        const auto full = fastestOf(5, [&] {
+            std::vector<std::wstring> names;
+            names.reserve(count);
+            for (std::size_t i = 0; i < count; i++)
+            {
+                names.emplace_back(items.name(afterItems[i]));
+            }
+            reread = names.size();
+        });
+
+        // Here a name is resolved from memory; in Explorer each one is a call into the shell namespace. The diff
+        // is ahead once a resolve costs more than the bookkeeping it adds, spread over the resolves it saves.
+        const auto breakEven = static_cast<double>(std::max<std::int64_t>(diff - full, 0))
+            / static_cast<double>(std::max<std::size_t>(reread - std::min(resolved, reread), 1));
+        return std::format(L"selection of {} items, 1% changed, diff cache vs full re-read:\r\n"
+                           L"  diff {:.1f} us ({} resolved), re-read {:.1f} us ({} resolved), {:.2f}x; "
+                           L"the diff is ahead when a resolve costs more than {:.0f} ns\r\n"sv,
+            count, static_cast<double>(diff) / 1000.0, resolved, static_cast<double>(full) / 1000.0, reread,
+            speedup(full, diff), breakEven);
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace
+{
+    // Decides which copy requests run, in the order they arrive; never more than one copy at a time.
+    //  - An autorepeat of a held chord is dropped, so holding the chord copies once.
+    //  - A request for the same window and binding as the one waiting to run is dropped: that copy
+    //    has not read the selection yet, so it will copy what the newer request would.
+    //  - So is one for the same window and binding as the running copy while nothing waits, as long as that
+    //    copy has not read the selection yet (see readingSelection()): it too will copy what the request would.
+    //  - Any other request takes the place of the waiting one and supersedes the running copy,
+    //    which notices at its next check of superseded() and stops early. That includes the same copy again
+    //    once the running one has read the selection, which may have changed since.
+    // Request needs hWnd, binding and repeat members. Not thread safe: the worker feeds it and runs the copies.
+    template <class Request>
+    class CopyScheduler
+    {
+        std::optional<Request> m_pending;
+        std::optional<Request> m_running;    // the copy in progress
+        std::uint64_t m_generation{};        // incremented for every accepted request
+        std::uint64_t m_runningGeneration{}; // the generation of the copy in progress
+        bool m_selectionRead{};              // the copy in progress has started reading the selection
+
+        static bool sameCopy(const Request& a, const Request& b) noexcept
+        {
+            return a.hWnd == b.hWnd && a.binding == b.binding;
+        }
+
+    public:
+        // Returns false if the request was folded into another one.
+        bool submit(const Request& request)
+        {
+            if (request.repeat)
+                return false;
+            if (m_pending ? sameCopy(*m_pending, request) : m_running && !m_selectionRead && sameCopy(*m_running, request))
+                return false;
+
+            m_pending = request;
+            m_generation++;
+            return true;
+        }
+
+        // Takes the request to run next, if any; it counts as running until finished().
+        std::optional<Request> next()
+        {
+            if (!m_pending)
+                return std::nullopt;
+
+            m_running = std::exchange(m_pending, std::nullopt);
+            m_runningGeneration = m_generation;
+            m_selectionRead = false;
+            return m_running;
+        }
+
+        // The running copy starts reading the selection; a request for the same copy from now on may see a
+        // different one.
+        void readingSelection() noexcept
+        {
+            m_selectionRead = true;
+        }
+
+        void finished() noexcept
+        {
+            m_running.reset();
+        }
+
+        // Whether a request accepted after the running copy started makes it pointless to finish it.
+        [[nodiscard]] bool superseded() const noexcept
+        {
+            return m_running.has_value() && m_generation != m_runningGeneration;
+        }
+    };
+}
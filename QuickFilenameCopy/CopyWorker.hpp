@@ -0,0 +1,129 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <windows.h>
+#include <wil/resource.h>
+#include <wil/result.h>
+
+#include "CopyScheduler.hpp"
+#include "SpscQueue.hpp"
+
+namespace
+{
+    // What the keyboard hook hands over to the worker. Keep it small and trivially copyable.
+    struct CopyRequest
+    {
+        HWND hWnd;
+        std::int64_t queuedAt; // LatencyStats::now() when the hook saw the chord
+        std::uint8_t binding;  // index into Settings::hotkeys of the chord that was pressed
+        bool repeat;           // an autorepeat of a chord that is held down
+    };
+
+    // Runs the shell/clipboard work on its own MTA thread so that the low-level keyboard hook
+    // only has to classify the keystroke and enqueue a request. Requests go through a CopyScheduler,
+    // which folds repeats and lets the copy in progress give way to a newer request.
+    class CopyWorker
+    {
+        SpscQueue<CopyRequest, 16> m_queue;
+        CopyScheduler<CopyRequest> m_scheduler;
+        wil::unique_event m_wake;
+        std::atomic<bool> m_stopping{ false };
+        std::thread m_thread;
+        std::function<void(const CopyRequest&)> m_handler;
+
+        void drain() noexcept
+        {
+            CopyRequest request{};
+            while (m_queue.try_pop(request))
+            {
+                m_scheduler.submit(request);
+            }
+        }
+
+        void run() noexcept
+        {
+            auto hr{ CoInitializeEx(nullptr, COINIT_MULTITHREADED | COINIT_DISABLE_OLE1DDE) };
+            if (FAILED(hr))
+                return;
+            auto initialized = wil::scope_exit([] { CoUninitialize(); });
+
+            for (;;)
+            {
+                m_wake.wait();
+                if (m_stopping.load(std::memory_order_acquire))
+                    break;
+
+                drain();
+                while (auto request = m_scheduler.next())
+                {
+                    try
+                    {
+                        m_handler(*request);
+                    }
+                    catch (...)
+                    {
+                        LOG_CAUGHT_EXCEPTION();
+                    }
+                    m_scheduler.finished();
+                    if (m_stopping.load(std::memory_order_acquire))
+                        return;
+                    drain();
+                }
+            }
+        }
+
+    public:
+        ~CopyWorker() noexcept
+        {
+            stop();
+        }
+
+        void start(std::function<void(const CopyRequest&)> handler)
+        {
+            m_handler = std::move(handler);
+            m_wake.create(wil::EventOptions::None);
+            m_stopping = false;
+            m_thread = std::thread([this] { run(); });
+        }
+
+        void stop() noexcept
+        {
+            if (!m_thread.joinable())
+                return;
+
+            m_stopping.store(true, std::memory_order_release);
+            m_wake.SetEvent();
+            m_thread.join();
+        }
+
+        // Called by the handler, on the worker thread, between steps of a copy: whether to stop the copy
+        // because a newer request has arrived or the worker is stopping.
+        bool superseded()
+        {
+            if (m_stopping.load(std::memory_order_acquire))
+                return true;
+            drain();
+            return m_scheduler.superseded();
+        }
+
+        // Called by the handler, on the worker thread, before it reads the selection of the window. Requests
+        // queued until then are folded into the copy; a request for the same copy after it supersedes it.
+        void readingSelection()
+        {
+            drain();
+            m_scheduler.readingSelection();
+        }
+
+        // Called from the keyboard hook. Never blocks; returns false if the queue is full.
+        bool post(const CopyRequest& request) noexcept
+        {
+            if (!m_queue.try_push(request))
+                return false;
+
+            m_wake.SetEvent();
+            return true;
+        }
+    };
+}
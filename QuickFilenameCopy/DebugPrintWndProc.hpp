@@ -1,291 +1,342 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <string>
-#include <format>
+#include <string_view>
 #include <windows.h>
 
+#include "StdFormat.hpp"
+
 namespace {
     using namespace std::string_literals;
     using namespace std::string_view_literals;
 
-    inline std::wstring DebugPrintWndProc(UINT message, WPARAM wParam, LPARAM lParam)
+    struct WindowMessageName
+    {
+        UINT message;
+        std::wstring_view name;
+    };
+
+    template <std::size_t N>
+    constexpr std::array<WindowMessageName, N> sortByMessage(std::array<WindowMessageName, N> table) noexcept
     {
-        std::wstring_view messageName;
-        std::wstring s;
-        switch (message)
+        for (std::size_t i = 1; i < N; i++)
         {
-        case WM_CREATE:
+            for (std::size_t j = i; j > 0 && table[j].message < table[j - 1].message; j--)
+            {
+                auto t = table[j];
+                table[j] = table[j - 1];
+                table[j - 1] = t;
+            }
+        }
+        return table;
+    }
+
+    template <std::size_t N>
+    constexpr bool isStrictlyIncreasing(const std::array<WindowMessageName, N>& table) noexcept
+    {
+        for (std::size_t i = 1; i < N; i++)
         {
-            auto lpcs = reinterpret_cast<LPCREATESTRUCT>(lParam);
-            return std::format(
-                L"message=WM_CREATE, wParam={:x}, lParam=CREATESTRUCT{{lpCreateParams={:p}, hInstance={:p},hMenu={:p},hwndParent={:p},cy={},cx={},x={},y={}}}"sv,
-                wParam, lpcs->lpCreateParams, (void*)lpcs->hInstance, (void*)lpcs->hMenu, (void*)lpcs->hwndParent, lpcs->cy, lpcs->cx, lpcs->x, lpcs->y);
+            if (!(table[i - 1].message < table[i].message))
+                return false;
         }
-        case WM_NULL: messageName = L"WM_NULL"; break;
-        case WM_DESTROY: messageName = L"WM_DESTROY"sv; break;
-        case WM_MOVE: messageName = L"WM_MOVE"sv; break;
-        case WM_SIZE: messageName = L"WM_SIZE"sv; break;
-        case WM_ACTIVATE: messageName = L"WM_ACTIVATE"sv; break;
-        case WM_SETFOCUS: messageName = L"WM_SETFOCUS"sv; break;
-        case WM_KILLFOCUS: messageName = L"WM_KILLFOCUS"sv; break;
-        case WM_ENABLE: messageName = L"WM_ENABLE"sv; break;
-        case WM_SETREDRAW: messageName = L"WM_SETREDRAW"sv; break;
-        case WM_SETTEXT: messageName = L"WM_SETTEXT"sv; break;
-        case WM_GETTEXT: messageName = L"WM_GETTEXT"sv; break;
-        case WM_GETTEXTLENGTH: messageName = L"WM_GETTEXTLENGTH"sv; break;
-        case WM_PAINT: messageName = L"WM_PAINT"sv; break;
-        case WM_CLOSE: messageName = L"WM_CLOSE"sv; break;
-        case WM_QUERYENDSESSION: messageName = L"WM_QUERYENDSESSION"sv; break;
-        case WM_QUERYOPEN: messageName = L"WM_QUERYOPEN"sv; break;
-        case WM_ENDSESSION: messageName = L"WM_ENDSESSION"sv; break;
-        case WM_QUIT: messageName = L"WM_QUIT"sv; break;
-        case WM_ERASEBKGND: messageName = L"WM_ERASEBKGND"sv; break;
-        case WM_SYSCOLORCHANGE: messageName = L"WM_SYSCOLORCHANGE"sv; break;
-        case WM_SHOWWINDOW: messageName = L"WM_SHOWWINDOW"sv; break;
-        case WM_WININICHANGE: messageName = L"WM_WININICHANGE"sv; break;
-        case WM_DEVMODECHANGE: messageName = L"WM_DEVMODECHANGE"sv; break;
-        case WM_ACTIVATEAPP: messageName = L"WM_ACTIVATEAPP"sv; break;
-        case WM_FONTCHANGE: messageName = L"WM_FONTCHANGE"sv; break;
-        case WM_TIMECHANGE: messageName = L"WM_TIMECHANGE"sv; break;
-        case WM_CANCELMODE: messageName = L"WM_CANCELMODE"sv; break;
-        case WM_SETCURSOR: messageName = L"WM_SETCURSOR"sv; break;
-        case WM_MOUSEACTIVATE: messageName = L"WM_MOUSEACTIVATE"sv; break;
-        case WM_CHILDACTIVATE: messageName = L"WM_CHILDACTIVATE"sv; break;
-        case WM_QUEUESYNC: messageName = L"WM_QUEUESYNC"sv; break;
-        case WM_GETMINMAXINFO: messageName = L"WM_GETMINMAXINFO"sv; break;
-        case WM_PAINTICON: messageName = L"WM_PAINTICON"sv; break;
-        case WM_ICONERASEBKGND: messageName = L"WM_ICONERASEBKGND"sv; break;
-        case WM_NEXTDLGCTL: messageName = L"WM_NEXTDLGCTL"sv; break;
-        case WM_SPOOLERSTATUS: messageName = L"WM_SPOOLERSTATUS"sv; break;
-        case WM_DRAWITEM: messageName = L"WM_DRAWITEM"sv; break;
-        case WM_MEASUREITEM: messageName = L"WM_MEASUREITEM"sv; break;
-        case WM_DELETEITEM: messageName = L"WM_DELETEITEM"sv; break;
-        case WM_VKEYTOITEM: messageName = L"WM_VKEYTOITEM"sv; break;
-        case WM_CHARTOITEM: messageName = L"WM_CHARTOITEM"sv; break;
-        case WM_SETFONT: messageName = L"WM_SETFONT"sv; break;
-        case WM_GETFONT: messageName = L"WM_GETFONT"sv; break;
-        case WM_SETHOTKEY: messageName = L"WM_SETHOTKEY"sv; break;
-        case WM_GETHOTKEY: messageName = L"WM_GETHOTKEY"sv; break;
-        case WM_QUERYDRAGICON: messageName = L"WM_QUERYDRAGICON"sv; break;
-        case WM_COMPAREITEM: messageName = L"WM_COMPAREITEM"sv; break;
-        case WM_GETOBJECT: messageName = L"WM_GETOBJECT"sv; break;
-        case WM_COMPACTING: messageName = L"WM_COMPACTING"sv; break;
-        case WM_COMMNOTIFY: messageName = L"WM_COMMNOTIFY"sv; break;
-        case WM_WINDOWPOSCHANGING: messageName = L"WM_WINDOWPOSCHANGING"sv; break;
-        case WM_WINDOWPOSCHANGED: messageName = L"WM_WINDOWPOSCHANGED"sv; break;
-        case WM_POWER: messageName = L"WM_POWER"sv; break;
-        case WM_COPYDATA: messageName = L"WM_COPYDATA"sv; break;
-        case WM_CANCELJOURNAL: messageName = L"WM_CANCELJOURNAL"sv; break;
-        case WM_NOTIFY: messageName = L"WM_NOTIFY"sv; break;
-        case WM_INPUTLANGCHANGEREQUEST: messageName = L"WM_INPUTLANGCHANGEREQUEST"sv; break;
-        case WM_INPUTLANGCHANGE: messageName = L"WM_INPUTLANGCHANGE"sv; break;
-        case WM_TCARD: messageName = L"WM_TCARD"sv; break;
-        case WM_HELP: messageName = L"WM_HELP"sv; break;
-        case WM_USERCHANGED: messageName = L"WM_USERCHANGED"sv; break;
-        case WM_NOTIFYFORMAT: messageName = L"WM_NOTIFYFORMAT"sv; break;
-        case WM_CONTEXTMENU: messageName = L"WM_CONTEXTMENU"sv; break;
-        case WM_STYLECHANGING: messageName = L"WM_STYLECHANGING"sv; break;
-        case WM_STYLECHANGED: messageName = L"WM_STYLECHANGED"sv; break;
-        case WM_DISPLAYCHANGE: messageName = L"WM_DISPLAYCHANGE"sv; break;
-        case WM_GETICON: messageName = L"WM_GETICON"sv; break;
-        case WM_SETICON: messageName = L"WM_SETICON"sv; break;
-        case WM_NCCREATE: messageName = L"WM_NCCREATE"sv; break;
-        case WM_NCDESTROY: messageName = L"WM_NCDESTROY"sv; break;
-        case WM_NCCALCSIZE: messageName = L"WM_NCCALCSIZE"sv; break;
-        case WM_NCHITTEST: messageName = L"WM_NCHITTEST"sv; break;
-        case WM_NCPAINT: messageName = L"WM_NCPAINT"sv; break;
-        case WM_NCACTIVATE: messageName = L"WM_NCACTIVATE"sv; break;
-        case WM_GETDLGCODE: messageName = L"WM_GETDLGCODE"sv; break;
-        case WM_SYNCPAINT: messageName = L"WM_SYNCPAINT"sv; break;
-        case WM_NCMOUSEMOVE: messageName = L"WM_NCMOUSEMOVE"sv; break;
-        case WM_NCLBUTTONDOWN: messageName = L"WM_NCLBUTTONDOWN"sv; break;
-        case WM_NCLBUTTONUP: messageName = L"WM_NCLBUTTONUP"sv; break;
-        case WM_NCLBUTTONDBLCLK: messageName = L"WM_NCLBUTTONDBLCLK"sv; break;
-        case WM_NCRBUTTONDOWN: messageName = L"WM_NCRBUTTONDOWN"sv; break;
-        case WM_NCRBUTTONUP: messageName = L"WM_NCRBUTTONUP"sv; break;
-        case WM_NCRBUTTONDBLCLK: messageName = L"WM_NCRBUTTONDBLCLK"sv; break;
-        case WM_NCMBUTTONDOWN: messageName = L"WM_NCMBUTTONDOWN"sv; break;
-        case WM_NCMBUTTONUP: messageName = L"WM_NCMBUTTONUP"sv; break;
-        case WM_NCMBUTTONDBLCLK: messageName = L"WM_NCMBUTTONDBLCLK"sv; break;
-        case WM_NCXBUTTONDOWN: messageName = L"WM_NCXBUTTONDOWN"sv; break;
-        case WM_NCXBUTTONUP: messageName = L"WM_NCXBUTTONUP"sv; break;
-        case WM_NCXBUTTONDBLCLK: messageName = L"WM_NCXBUTTONDBLCLK"sv; break;
-        case WM_INPUT_DEVICE_CHANGE: messageName = L"WM_INPUT_DEVICE_CHANGE"sv; break;
-        case WM_INPUT: messageName = L"WM_INPUT"sv; break;
-        case WM_KEYDOWN: messageName = L"WM_KEYDOWN"sv; break;
-        case WM_KEYUP: messageName = L"WM_KEYUP"sv; break;
-        case WM_CHAR: messageName = L"WM_CHAR"sv; break;
-        case WM_DEADCHAR: messageName = L"WM_DEADCHAR"sv; break;
-        case WM_SYSKEYDOWN: messageName = L"WM_SYSKEYDOWN"sv; break;
-        case WM_SYSKEYUP: messageName = L"WM_SYSKEYUP"sv; break;
-        case WM_SYSCHAR: messageName = L"WM_SYSCHAR"sv; break;
-        case WM_SYSDEADCHAR: messageName = L"WM_SYSDEADCHAR"sv; break;
-        case WM_UNICHAR: messageName = L"WM_UNICHAR"sv; break;
-        case WM_IME_STARTCOMPOSITION: messageName = L"WM_IME_STARTCOMPOSITION"sv; break;
-        case WM_IME_ENDCOMPOSITION: messageName = L"WM_IME_ENDCOMPOSITION"sv; break;
-        case WM_IME_COMPOSITION: messageName = L"WM_IME_COMPOSITION"sv; break;
-        case WM_INITDIALOG: messageName = L"WM_INITDIALOG"sv; break;
-        case WM_COMMAND: messageName = L"WM_COMMAND"sv; break;
-        case WM_SYSCOMMAND: messageName = L"WM_SYSCOMMAND"sv; break;
-        case WM_TIMER: messageName = L"WM_TIMER"sv; break;
-        case WM_HSCROLL: messageName = L"WM_HSCROLL"sv; break;
-        case WM_VSCROLL: messageName = L"WM_VSCROLL"sv; break;
-        case WM_INITMENU: messageName = L"WM_INITMENU"sv; break;
-        case WM_INITMENUPOPUP: messageName = L"WM_INITMENUPOPUP"sv; break;
-        case WM_GESTURE: messageName = L"WM_GESTURE"sv; break;
-        case WM_GESTURENOTIFY: messageName = L"WM_GESTURENOTIFY"sv; break;
-        case WM_MENUSELECT: messageName = L"WM_MENUSELECT"sv; break;
-        case WM_MENUCHAR: messageName = L"WM_MENUCHAR"sv; break;
-        case WM_ENTERIDLE: messageName = L"WM_ENTERIDLE"sv; break;
-        case WM_MENURBUTTONUP: messageName = L"WM_MENURBUTTONUP"sv; break;
-        case WM_MENUDRAG: messageName = L"WM_MENUDRAG"sv; break;
-        case WM_MENUGETOBJECT: messageName = L"WM_MENUGETOBJECT"sv; break;
-        case WM_UNINITMENUPOPUP: messageName = L"WM_UNINITMENUPOPUP"sv; break;
-        case WM_MENUCOMMAND: messageName = L"WM_MENUCOMMAND"sv; break;
-        case WM_CHANGEUISTATE: messageName = L"WM_CHANGEUISTATE"sv; break;
-        case WM_UPDATEUISTATE: messageName = L"WM_UPDATEUISTATE"sv; break;
-        case WM_QUERYUISTATE: messageName = L"WM_QUERYUISTATE"sv; break;
-        case WM_CTLCOLORMSGBOX: messageName = L"WM_CTLCOLORMSGBOX"sv; break;
-        case WM_CTLCOLOREDIT: messageName = L"WM_CTLCOLOREDIT"sv; break;
-        case WM_CTLCOLORLISTBOX: messageName = L"WM_CTLCOLORLISTBOX"sv; break;
-        case WM_CTLCOLORBTN: messageName = L"WM_CTLCOLORBTN"sv; break;
-        case WM_CTLCOLORDLG: messageName = L"WM_CTLCOLORDLG"sv; break;
-        case WM_CTLCOLORSCROLLBAR: messageName = L"WM_CTLCOLORSCROLLBAR"sv; break;
-        case WM_CTLCOLORSTATIC: messageName = L"WM_CTLCOLORSTATIC"sv; break;
-        case WM_MOUSEMOVE: messageName = L"WM_MOUSEMOVE"sv; break;
-        case WM_LBUTTONDOWN: messageName = L"WM_LBUTTONDOWN"sv; break;
-        case WM_LBUTTONUP: messageName = L"WM_LBUTTONUP"sv; break;
-        case WM_LBUTTONDBLCLK: messageName = L"WM_LBUTTONDBLCLK"sv; break;
-        case WM_RBUTTONDOWN: messageName = L"WM_RBUTTONDOWN"sv; break;
-        case WM_RBUTTONUP: messageName = L"WM_RBUTTONUP"sv; break;
-        case WM_RBUTTONDBLCLK: messageName = L"WM_RBUTTONDBLCLK"sv; break;
-        case WM_MBUTTONDOWN: messageName = L"WM_MBUTTONDOWN"sv; break;
-        case WM_MBUTTONUP: messageName = L"WM_MBUTTONUP"sv; break;
-        case WM_MBUTTONDBLCLK: messageName = L"WM_MBUTTONDBLCLK"sv; break;
-        case WM_MOUSEWHEEL: messageName = L"WM_MOUSEWHEEL"sv; break;
-        case WM_XBUTTONDOWN: messageName = L"WM_XBUTTONDOWN"sv; break;
-        case WM_XBUTTONUP: messageName = L"WM_XBUTTONUP"sv; break;
-        case WM_XBUTTONDBLCLK: messageName = L"WM_XBUTTONDBLCLK"sv; break;
-        case WM_MOUSEHWHEEL: messageName = L"WM_MOUSEHWHEEL"sv; break;
-        case WM_PARENTNOTIFY: messageName = L"WM_PARENTNOTIFY"sv; break;
-        case WM_ENTERMENULOOP: messageName = L"WM_ENTERMENULOOP"sv; break;
-        case WM_EXITMENULOOP: messageName = L"WM_EXITMENULOOP"sv; break;
-        case WM_NEXTMENU: messageName = L"WM_NEXTMENU"sv; break;
-        case WM_SIZING: messageName = L"WM_SIZING"sv; break;
-        case WM_CAPTURECHANGED: messageName = L"WM_CAPTURECHANGED"sv; break;
-        case WM_MOVING: messageName = L"WM_MOVING"sv; break;
-        case WM_POWERBROADCAST: messageName = L"WM_POWERBROADCAST"sv; break;
-        case WM_DEVICECHANGE: messageName = L"WM_DEVICECHANGE"sv; break;
-        case WM_MDICREATE: messageName = L"WM_MDICREATE"sv; break;
-        case WM_MDIDESTROY: messageName = L"WM_MDIDESTROY"sv; break;
-        case WM_MDIACTIVATE: messageName = L"WM_MDIACTIVATE"sv; break;
-        case WM_MDIRESTORE: messageName = L"WM_MDIRESTORE"sv; break;
-        case WM_MDINEXT: messageName = L"WM_MDINEXT"sv; break;
-        case WM_MDIMAXIMIZE: messageName = L"WM_MDIMAXIMIZE"sv; break;
-        case WM_MDITILE: messageName = L"WM_MDITILE"sv; break;
-        case WM_MDICASCADE: messageName = L"WM_MDICASCADE"sv; break;
-        case WM_MDIICONARRANGE: messageName = L"WM_MDIICONARRANGE"sv; break;
-        case WM_MDIGETACTIVE: messageName = L"WM_MDIGETACTIVE"sv; break;
-        case WM_MDISETMENU: messageName = L"WM_MDISETMENU"sv; break;
-        case WM_ENTERSIZEMOVE: messageName = L"WM_ENTERSIZEMOVE"sv; break;
-        case WM_EXITSIZEMOVE: messageName = L"WM_EXITSIZEMOVE"sv; break;
-        case WM_DROPFILES: messageName = L"WM_DROPFILES"sv; break;
-        case WM_MDIREFRESHMENU: messageName = L"WM_MDIREFRESHMENU"sv; break;
-        case WM_POINTERDEVICECHANGE: messageName = L"WM_POINTERDEVICECHANGE"sv; break;
-        case WM_POINTERDEVICEINRANGE: messageName = L"WM_POINTERDEVICEINRANGE"sv; break;
-        case WM_POINTERDEVICEOUTOFRANGE: messageName = L"WM_POINTERDEVICEOUTOFRANGE"sv; break;
-        case WM_TOUCH: messageName = L"WM_TOUCH"sv; break;
-        case WM_NCPOINTERUPDATE: messageName = L"WM_NCPOINTERUPDATE"sv; break;
-        case WM_NCPOINTERDOWN: messageName = L"WM_NCPOINTERDOWN"sv; break;
-        case WM_NCPOINTERUP: messageName = L"WM_NCPOINTERUP"sv; break;
-        case WM_POINTERUPDATE: messageName = L"WM_POINTERUPDATE"sv; break;
-        case WM_POINTERDOWN: messageName = L"WM_POINTERDOWN"sv; break;
-        case WM_POINTERUP: messageName = L"WM_POINTERUP"sv; break;
-        case WM_POINTERENTER: messageName = L"WM_POINTERENTER"sv; break;
-        case WM_POINTERLEAVE: messageName = L"WM_POINTERLEAVE"sv; break;
-        case WM_POINTERACTIVATE: messageName = L"WM_POINTERACTIVATE"sv; break;
-        case WM_POINTERCAPTURECHANGED: messageName = L"WM_POINTERCAPTURECHANGED"sv; break;
-        case WM_TOUCHHITTESTING: messageName = L"WM_TOUCHHITTESTING"sv; break;
-        case WM_POINTERWHEEL: messageName = L"WM_POINTERWHEEL"sv; break;
-        case WM_POINTERHWHEEL: messageName = L"WM_POINTERHWHEEL"sv; break;
-        case WM_POINTERROUTEDTO: messageName = L"WM_POINTERROUTEDTO"sv; break;
-        case WM_POINTERROUTEDAWAY: messageName = L"WM_POINTERROUTEDAWAY"sv; break;
-        case WM_POINTERROUTEDRELEASED: messageName = L"WM_POINTERROUTEDRELEASED"sv; break;
-        case WM_IME_SETCONTEXT: messageName = L"WM_IME_SETCONTEXT"sv; break;
-        case WM_IME_NOTIFY: messageName = L"WM_IME_NOTIFY"sv; break;
-        case WM_IME_CONTROL: messageName = L"WM_IME_CONTROL"sv; break;
-        case WM_IME_COMPOSITIONFULL: messageName = L"WM_IME_COMPOSITIONFULL"sv; break;
-        case WM_IME_SELECT: messageName = L"WM_IME_SELECT"sv; break;
-        case WM_IME_CHAR: messageName = L"WM_IME_CHAR"sv; break;
-        case WM_IME_REQUEST: messageName = L"WM_IME_REQUEST"sv; break;
-        case WM_IME_KEYDOWN: messageName = L"WM_IME_KEYDOWN"sv; break;
-        case WM_IME_KEYUP: messageName = L"WM_IME_KEYUP"sv; break;
-        case WM_MOUSEHOVER: messageName = L"WM_MOUSEHOVER"sv; break;
-        case WM_MOUSELEAVE: messageName = L"WM_MOUSELEAVE"sv; break;
-        case WM_NCMOUSEHOVER: messageName = L"WM_NCMOUSEHOVER"sv; break;
-        case WM_NCMOUSELEAVE: messageName = L"WM_NCMOUSELEAVE"sv; break;
-        case WM_WTSSESSION_CHANGE: messageName = L"WM_WTSSESSION_CHANGE"sv; break;
-        case WM_TABLET_FIRST: messageName = L"WM_TABLET_FIRST"sv; break;
-        case WM_TABLET_LAST: messageName = L"WM_TABLET_LAST"sv; break;
-        case WM_DPICHANGED: messageName = L"WM_DPICHANGED"sv; break;
+        return true;
+    }
+
+#define WM_NAME(message) WindowMessageName{ message, std::wstring_view{ L ## #message } }
+
+    // Window message names sorted by value at compile time, looked up by binary search.
+    constexpr auto windowMessageNames = sortByMessage(std::array{
+            WM_NAME(WM_NULL),
+            WM_NAME(WM_DESTROY),
+            WM_NAME(WM_MOVE),
+            WM_NAME(WM_SIZE),
+            WM_NAME(WM_ACTIVATE),
+            WM_NAME(WM_SETFOCUS),
+            WM_NAME(WM_KILLFOCUS),
+            WM_NAME(WM_ENABLE),
+            WM_NAME(WM_SETREDRAW),
+            WM_NAME(WM_SETTEXT),
+            WM_NAME(WM_GETTEXT),
+            WM_NAME(WM_GETTEXTLENGTH),
+            WM_NAME(WM_PAINT),
+            WM_NAME(WM_CLOSE),
+            WM_NAME(WM_QUERYENDSESSION),
+            WM_NAME(WM_QUERYOPEN),
+            WM_NAME(WM_ENDSESSION),
+            WM_NAME(WM_QUIT),
+            WM_NAME(WM_ERASEBKGND),
+            WM_NAME(WM_SYSCOLORCHANGE),
+            WM_NAME(WM_SHOWWINDOW),
+            WM_NAME(WM_WININICHANGE),
+            WM_NAME(WM_DEVMODECHANGE),
+            WM_NAME(WM_ACTIVATEAPP),
+            WM_NAME(WM_FONTCHANGE),
+            WM_NAME(WM_TIMECHANGE),
+            WM_NAME(WM_CANCELMODE),
+            WM_NAME(WM_SETCURSOR),
+            WM_NAME(WM_MOUSEACTIVATE),
+            WM_NAME(WM_CHILDACTIVATE),
+            WM_NAME(WM_QUEUESYNC),
+            WM_NAME(WM_GETMINMAXINFO),
+            WM_NAME(WM_PAINTICON),
+            WM_NAME(WM_ICONERASEBKGND),
+            WM_NAME(WM_NEXTDLGCTL),
+            WM_NAME(WM_SPOOLERSTATUS),
+            WM_NAME(WM_DRAWITEM),
+            WM_NAME(WM_MEASUREITEM),
+            WM_NAME(WM_DELETEITEM),
+            WM_NAME(WM_VKEYTOITEM),
+            WM_NAME(WM_CHARTOITEM),
+            WM_NAME(WM_SETFONT),
+            WM_NAME(WM_GETFONT),
+            WM_NAME(WM_SETHOTKEY),
+            WM_NAME(WM_GETHOTKEY),
+            WM_NAME(WM_QUERYDRAGICON),
+            WM_NAME(WM_COMPAREITEM),
+            WM_NAME(WM_GETOBJECT),
+            WM_NAME(WM_COMPACTING),
+            WM_NAME(WM_COMMNOTIFY),
+            WM_NAME(WM_WINDOWPOSCHANGING),
+            WM_NAME(WM_WINDOWPOSCHANGED),
+            WM_NAME(WM_POWER),
+            WM_NAME(WM_COPYDATA),
+            WM_NAME(WM_CANCELJOURNAL),
+            WM_NAME(WM_NOTIFY),
+            WM_NAME(WM_INPUTLANGCHANGEREQUEST),
+            WM_NAME(WM_INPUTLANGCHANGE),
+            WM_NAME(WM_TCARD),
+            WM_NAME(WM_HELP),
+            WM_NAME(WM_USERCHANGED),
+            WM_NAME(WM_NOTIFYFORMAT),
+            WM_NAME(WM_CONTEXTMENU),
+            WM_NAME(WM_STYLECHANGING),
+            WM_NAME(WM_STYLECHANGED),
+            WM_NAME(WM_DISPLAYCHANGE),
+            WM_NAME(WM_GETICON),
+            WM_NAME(WM_SETICON),
+            WM_NAME(WM_NCCREATE),
+            WM_NAME(WM_NCDESTROY),
+            WM_NAME(WM_NCCALCSIZE),
+            WM_NAME(WM_NCHITTEST),
+            WM_NAME(WM_NCPAINT),
+            WM_NAME(WM_NCACTIVATE),
+            WM_NAME(WM_GETDLGCODE),
+            WM_NAME(WM_SYNCPAINT),
+            WM_NAME(WM_NCMOUSEMOVE),
+            WM_NAME(WM_NCLBUTTONDOWN),
+            WM_NAME(WM_NCLBUTTONUP),
+            WM_NAME(WM_NCLBUTTONDBLCLK),
+            WM_NAME(WM_NCRBUTTONDOWN),
+            WM_NAME(WM_NCRBUTTONUP),
+            WM_NAME(WM_NCRBUTTONDBLCLK),
+            WM_NAME(WM_NCMBUTTONDOWN),
+            WM_NAME(WM_NCMBUTTONUP),
+            WM_NAME(WM_NCMBUTTONDBLCLK),
+            WM_NAME(WM_NCXBUTTONDOWN),
+            WM_NAME(WM_NCXBUTTONUP),
+            WM_NAME(WM_NCXBUTTONDBLCLK),
+            WM_NAME(WM_INPUT_DEVICE_CHANGE),
+            WM_NAME(WM_INPUT),
+            WM_NAME(WM_KEYDOWN),
+            WM_NAME(WM_KEYUP),
+            WM_NAME(WM_CHAR),
+            WM_NAME(WM_DEADCHAR),
+            WM_NAME(WM_SYSKEYDOWN),
+            WM_NAME(WM_SYSKEYUP),
+            WM_NAME(WM_SYSCHAR),
+            WM_NAME(WM_SYSDEADCHAR),
+            WM_NAME(WM_UNICHAR),
+            WM_NAME(WM_IME_STARTCOMPOSITION),
+            WM_NAME(WM_IME_ENDCOMPOSITION),
+            WM_NAME(WM_IME_COMPOSITION),
+            WM_NAME(WM_INITDIALOG),
+            WM_NAME(WM_COMMAND),
+            WM_NAME(WM_SYSCOMMAND),
+            WM_NAME(WM_TIMER),
+            WM_NAME(WM_HSCROLL),
+            WM_NAME(WM_VSCROLL),
+            WM_NAME(WM_INITMENU),
+            WM_NAME(WM_INITMENUPOPUP),
+            WM_NAME(WM_GESTURE),
+            WM_NAME(WM_GESTURENOTIFY),
+            WM_NAME(WM_MENUSELECT),
+            WM_NAME(WM_MENUCHAR),
+            WM_NAME(WM_ENTERIDLE),
+            WM_NAME(WM_MENURBUTTONUP),
+            WM_NAME(WM_MENUDRAG),
+            WM_NAME(WM_MENUGETOBJECT),
+            WM_NAME(WM_UNINITMENUPOPUP),
+            WM_NAME(WM_MENUCOMMAND),
+            WM_NAME(WM_CHANGEUISTATE),
+            WM_NAME(WM_UPDATEUISTATE),
+            WM_NAME(WM_QUERYUISTATE),
+            WM_NAME(WM_CTLCOLORMSGBOX),
+            WM_NAME(WM_CTLCOLOREDIT),
+            WM_NAME(WM_CTLCOLORLISTBOX),
+            WM_NAME(WM_CTLCOLORBTN),
+            WM_NAME(WM_CTLCOLORDLG),
+            WM_NAME(WM_CTLCOLORSCROLLBAR),
+            WM_NAME(WM_CTLCOLORSTATIC),
+            WM_NAME(WM_MOUSEMOVE),
+            WM_NAME(WM_LBUTTONDOWN),
+            WM_NAME(WM_LBUTTONUP),
+            WM_NAME(WM_LBUTTONDBLCLK),
+            WM_NAME(WM_RBUTTONDOWN),
+            WM_NAME(WM_RBUTTONUP),
+            WM_NAME(WM_RBUTTONDBLCLK),
+            WM_NAME(WM_MBUTTONDOWN),
+            WM_NAME(WM_MBUTTONUP),
+            WM_NAME(WM_MBUTTONDBLCLK),
+            WM_NAME(WM_MOUSEWHEEL),
+            WM_NAME(WM_XBUTTONDOWN),
+            WM_NAME(WM_XBUTTONUP),
+            WM_NAME(WM_XBUTTONDBLCLK),
+            WM_NAME(WM_MOUSEHWHEEL),
+            WM_NAME(WM_PARENTNOTIFY),
+            WM_NAME(WM_ENTERMENULOOP),
+            WM_NAME(WM_EXITMENULOOP),
+            WM_NAME(WM_NEXTMENU),
+            WM_NAME(WM_SIZING),
+            WM_NAME(WM_CAPTURECHANGED),
+            WM_NAME(WM_MOVING),
+            WM_NAME(WM_POWERBROADCAST),
+            WM_NAME(WM_DEVICECHANGE),
+            WM_NAME(WM_MDICREATE),
+            WM_NAME(WM_MDIDESTROY),
+            WM_NAME(WM_MDIACTIVATE),
+            WM_NAME(WM_MDIRESTORE),
+            WM_NAME(WM_MDINEXT),
+            WM_NAME(WM_MDIMAXIMIZE),
+            WM_NAME(WM_MDITILE),
+            WM_NAME(WM_MDICASCADE),
+            WM_NAME(WM_MDIICONARRANGE),
+            WM_NAME(WM_MDIGETACTIVE),
+            WM_NAME(WM_MDISETMENU),
+            WM_NAME(WM_ENTERSIZEMOVE),
+            WM_NAME(WM_EXITSIZEMOVE),
+            WM_NAME(WM_DROPFILES),
+            WM_NAME(WM_MDIREFRESHMENU),
+            WM_NAME(WM_POINTERDEVICECHANGE),
+            WM_NAME(WM_POINTERDEVICEINRANGE),
+            WM_NAME(WM_POINTERDEVICEOUTOFRANGE),
+            WM_NAME(WM_TOUCH),
+            WM_NAME(WM_NCPOINTERUPDATE),
+            WM_NAME(WM_NCPOINTERDOWN),
+            WM_NAME(WM_NCPOINTERUP),
+            WM_NAME(WM_POINTERUPDATE),
+            WM_NAME(WM_POINTERDOWN),
+            WM_NAME(WM_POINTERUP),
+            WM_NAME(WM_POINTERENTER),
+            WM_NAME(WM_POINTERLEAVE),
+            WM_NAME(WM_POINTERACTIVATE),
+            WM_NAME(WM_POINTERCAPTURECHANGED),
+            WM_NAME(WM_TOUCHHITTESTING),
+            WM_NAME(WM_POINTERWHEEL),
+            WM_NAME(WM_POINTERHWHEEL),
+            WM_NAME(WM_POINTERROUTEDTO),
+            WM_NAME(WM_POINTERROUTEDAWAY),
+            WM_NAME(WM_POINTERROUTEDRELEASED),
+            WM_NAME(WM_IME_SETCONTEXT),
+            WM_NAME(WM_IME_NOTIFY),
+            WM_NAME(WM_IME_CONTROL),
+            WM_NAME(WM_IME_COMPOSITIONFULL),
+            WM_NAME(WM_IME_SELECT),
+            WM_NAME(WM_IME_CHAR),
+            WM_NAME(WM_IME_REQUEST),
+            WM_NAME(WM_IME_KEYDOWN),
+            WM_NAME(WM_IME_KEYUP),
+            WM_NAME(WM_MOUSEHOVER),
+            WM_NAME(WM_MOUSELEAVE),
+            WM_NAME(WM_NCMOUSEHOVER),
+            WM_NAME(WM_NCMOUSELEAVE),
+            WM_NAME(WM_WTSSESSION_CHANGE),
+            WM_NAME(WM_TABLET_FIRST),
+            WM_NAME(WM_TABLET_LAST),
+            WM_NAME(WM_DPICHANGED),
 #if(WINVER >= 0x0605)
-        case WM_DPICHANGED_BEFOREPARENT: messageName = L"WM_DPICHANGED_BEFOREPARENT"sv; break;
-        case WM_DPICHANGED_AFTERPARENT: messageName = L"WM_DPICHANGED_AFTERPARENT"sv; break;
-        case WM_GETDPISCALEDSIZE: messageName = L"WM_GETDPISCALEDSIZE"sv; break;
+            WM_NAME(WM_DPICHANGED_BEFOREPARENT),
+            WM_NAME(WM_DPICHANGED_AFTERPARENT),
+            WM_NAME(WM_GETDPISCALEDSIZE),
 #endif /* WINVER >= 0x0605 */
-        case WM_CUT: messageName = L"WM_CUT"sv; break;
-        case WM_COPY: messageName = L"WM_COPY"sv; break;
-        case WM_PASTE: messageName = L"WM_PASTE"sv; break;
-        case WM_CLEAR: messageName = L"WM_CLEAR"sv; break;
-        case WM_UNDO: messageName = L"WM_UNDO"sv; break;
-        case WM_RENDERFORMAT: messageName = L"WM_RENDERFORMAT"sv; break;
-        case WM_RENDERALLFORMATS: messageName = L"WM_RENDERALLFORMATS"sv; break;
-        case WM_DESTROYCLIPBOARD: messageName = L"WM_DESTROYCLIPBOARD"sv; break;
-        case WM_DRAWCLIPBOARD: messageName = L"WM_DRAWCLIPBOARD"sv; break;
-        case WM_PAINTCLIPBOARD: messageName = L"WM_PAINTCLIPBOARD"sv; break;
-        case WM_VSCROLLCLIPBOARD: messageName = L"WM_VSCROLLCLIPBOARD"sv; break;
-        case WM_SIZECLIPBOARD: messageName = L"WM_SIZECLIPBOARD"sv; break;
-        case WM_ASKCBFORMATNAME: messageName = L"WM_ASKCBFORMATNAME"sv; break;
-        case WM_CHANGECBCHAIN: messageName = L"WM_CHANGECBCHAIN"sv; break;
-        case WM_HSCROLLCLIPBOARD: messageName = L"WM_HSCROLLCLIPBOARD"sv; break;
-        case WM_QUERYNEWPALETTE: messageName = L"WM_QUERYNEWPALETTE"sv; break;
-        case WM_PALETTEISCHANGING: messageName = L"WM_PALETTEISCHANGING"sv; break;
-        case WM_PALETTECHANGED: messageName = L"WM_PALETTECHANGED"sv; break;
-        case WM_HOTKEY: messageName = L"WM_HOTKEY"sv; break;
-        case WM_PRINT: messageName = L"WM_PRINT"sv; break;
-        case WM_PRINTCLIENT: messageName = L"WM_PRINTCLIENT"sv; break;
-        case WM_APPCOMMAND: messageName = L"WM_APPCOMMAND"sv; break;
-        case WM_THEMECHANGED: messageName = L"WM_THEMECHANGED"sv; break;
-        case WM_CLIPBOARDUPDATE: messageName = L"WM_CLIPBOARDUPDATE"sv; break;
-        case WM_DWMCOMPOSITIONCHANGED: messageName = L"WM_DWMCOMPOSITIONCHANGED"sv; break;
-        case WM_DWMNCRENDERINGCHANGED: messageName = L"WM_DWMNCRENDERINGCHANGED"sv; break;
-        case WM_DWMCOLORIZATIONCOLORCHANGED: messageName = L"WM_DWMCOLORIZATIONCOLORCHANGED"sv; break;
-        case WM_DWMWINDOWMAXIMIZEDCHANGE: messageName = L"WM_DWMWINDOWMAXIMIZEDCHANGE"sv; break;
-        case WM_DWMSENDICONICTHUMBNAIL: messageName = L"WM_DWMSENDICONICTHUMBNAIL"sv; break;
-        case WM_DWMSENDICONICLIVEPREVIEWBITMAP: messageName = L"WM_DWMSENDICONICLIVEPREVIEWBITMAP"sv; break;
-        case WM_GETTITLEBARINFOEX: messageName = L"WM_GETTITLEBARINFOEX"sv; break;
-        case WM_HANDHELDFIRST: messageName = L"WM_HANDHELDFIRST"sv; break;
-        case WM_HANDHELDLAST: messageName = L"WM_HANDHELDLAST"sv; break;
-        case WM_AFXFIRST: messageName = L"WM_AFXFIRST"sv; break;
-        case WM_AFXLAST: messageName = L"WM_AFXLAST"sv; break;
-        case WM_PENWINFIRST: messageName = L"WM_PENWINFIRST"sv; break;
-        case WM_PENWINLAST: messageName = L"WM_PENWINLAST"sv; break;
-            //---------------------------------------------------------------------------------
-        case 0x0090: messageName = L"WM_UAHDESTROYWINDOW"sv; break;
-        case 0x0091: messageName = L"WM_UAHDRAWMENU"sv; break;
-        case 0x0092: messageName = L"WM_UAHDRAWMENUITEM"sv; break;
-        case 0x0093: messageName = L"WM_UAHINITMENU"sv; break;
-        case 0x0094: messageName = L"WM_UAHMEASUREMENUITEM"sv; break;
-        case 0x0095: messageName = L"WM_UAHNCPAINTMENUPOPUP"sv; break;
-        default:
-            if (WM_USER <= message && message <= 0x7FFF)
-                s = std::format(L"WM_USER+0x{:x}", message - WM_USER);
-            else if (WM_APP <= message && message <= 0xBFFF)
-                s = std::format(L"WM_APP+0x{:x}", message - WM_APP);
-            else
-                s = std::format(L"0x{:x}", message);
-            messageName = s;
-            break;
+            WM_NAME(WM_CUT),
+            WM_NAME(WM_COPY),
+            WM_NAME(WM_PASTE),
+            WM_NAME(WM_CLEAR),
+            WM_NAME(WM_UNDO),
+            WM_NAME(WM_RENDERFORMAT),
+            WM_NAME(WM_RENDERALLFORMATS),
+            WM_NAME(WM_DESTROYCLIPBOARD),
+            WM_NAME(WM_DRAWCLIPBOARD),
+            WM_NAME(WM_PAINTCLIPBOARD),
+            WM_NAME(WM_VSCROLLCLIPBOARD),
+            WM_NAME(WM_SIZECLIPBOARD),
+            WM_NAME(WM_ASKCBFORMATNAME),
+            WM_NAME(WM_CHANGECBCHAIN),
+            WM_NAME(WM_HSCROLLCLIPBOARD),
+            WM_NAME(WM_QUERYNEWPALETTE),
+            WM_NAME(WM_PALETTEISCHANGING),
+            WM_NAME(WM_PALETTECHANGED),
+            WM_NAME(WM_HOTKEY),
+            WM_NAME(WM_PRINT),
+            WM_NAME(WM_PRINTCLIENT),
+            WM_NAME(WM_APPCOMMAND),
+            WM_NAME(WM_THEMECHANGED),
+            WM_NAME(WM_CLIPBOARDUPDATE),
+            WM_NAME(WM_DWMCOMPOSITIONCHANGED),
+            WM_NAME(WM_DWMNCRENDERINGCHANGED),
+            WM_NAME(WM_DWMCOLORIZATIONCOLORCHANGED),
+            WM_NAME(WM_DWMWINDOWMAXIMIZEDCHANGE),
+            WM_NAME(WM_DWMSENDICONICTHUMBNAIL),
+            WM_NAME(WM_DWMSENDICONICLIVEPREVIEWBITMAP),
+            WM_NAME(WM_GETTITLEBARINFOEX),
+            WM_NAME(WM_HANDHELDFIRST),
+            WM_NAME(WM_HANDHELDLAST),
+            WM_NAME(WM_AFXFIRST),
+            WM_NAME(WM_AFXLAST),
+            WM_NAME(WM_PENWINFIRST),
+            WM_NAME(WM_PENWINLAST),
+            // undocumented
+            WindowMessageName{ 0x0090, L"WM_UAHDESTROYWINDOW"sv },
+            WindowMessageName{ 0x0091, L"WM_UAHDRAWMENU"sv },
+            WindowMessageName{ 0x0092, L"WM_UAHDRAWMENUITEM"sv },
+            WindowMessageName{ 0x0093, L"WM_UAHINITMENU"sv },
+            WindowMessageName{ 0x0094, L"WM_UAHMEASUREMENUITEM"sv },
+            WindowMessageName{ 0x0095, L"WM_UAHNCPAINTMENUPOPUP"sv },
+    });
+
+#undef WM_NAME
+
+    static_assert(isStrictlyIncreasing(windowMessageNames), "duplicate window message in windowMessageNames");
+
+    inline std::wstring_view windowMessageName(UINT message) noexcept
+    {
+        auto it = std::lower_bound(windowMessageNames.begin(), windowMessageNames.end(), message,
+            [](const WindowMessageName& entry, UINT value) { return entry.message < value; });
+        return it != windowMessageNames.end() && it->message == message ? it->name : std::wstring_view{};
+    }
+
+    // Describes a window message into buffer without allocating; the result is truncated to fit.
+    template <std::size_t N>
+    std::wstring_view DebugPrintWndProc(wchar_t (&buffer)[N], UINT message, WPARAM wParam, LPARAM lParam)
+    {
+        std::size_t size = 0;
+        if (message == WM_CREATE)
+        {
+            auto lpcs = reinterpret_cast<LPCREATESTRUCT>(lParam);
+            size = static_cast<std::size_t>(std::format_to_n(buffer, N,
+                L"message=WM_CREATE, wParam={:x}, lParam=CREATESTRUCT{{lpCreateParams={:p}, hInstance={:p},hMenu={:p},hwndParent={:p},cy={},cx={},x={},y={}}}"sv,
+                wParam, lpcs->lpCreateParams, (void*)lpcs->hInstance, (void*)lpcs->hMenu, (void*)lpcs->hwndParent, lpcs->cy, lpcs->cx, lpcs->x, lpcs->y).size);
         }
-        return std::format(L"message={}, wParam={:x}, lParam={:x}"sv, messageName, wParam, lParam);
+        else if (auto name = windowMessageName(message); !name.empty())
+            size = static_cast<std::size_t>(std::format_to_n(buffer, N, L"message={}, wParam={:x}, lParam={:x}"sv, name, wParam, lParam).size);
+        else if (WM_USER <= message && message <= 0x7FFF)
+            size = static_cast<std::size_t>(std::format_to_n(buffer, N, L"message=WM_USER+0x{:x}, wParam={:x}, lParam={:x}"sv, message - WM_USER, wParam, lParam).size);
+        else if (WM_APP <= message && message <= 0xBFFF)
+            size = static_cast<std::size_t>(std::format_to_n(buffer, N, L"message=WM_APP+0x{:x}, wParam={:x}, lParam={:x}"sv, message - WM_APP, wParam, lParam).size);
+        else
+            size = static_cast<std::size_t>(std::format_to_n(buffer, N, L"message=0x{:x}, wParam={:x}, lParam={:x}"sv, message, wParam, lParam).size);
+
+        return { buffer, std::min(size, N) };
     }
 }
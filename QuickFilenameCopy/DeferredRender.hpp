@@ -0,0 +1,48 @@
+#pragma once
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace
+{
+    // Owner side of clipboard delayed rendering: holds what is needed to render the data later
+    // (a compact item list rather than the text) between SetClipboardData(format, nullptr) and the
+    // WM_RENDERFORMAT/WM_RENDERALLFORMATS that asks for it, or the WM_DESTROYCLIPBOARD that makes it moot.
+    //
+    // The publisher must call offer() after EmptyClipboard: emptying the clipboard sends WM_DESTROYCLIPBOARD
+    // to the previous owner, which may be us, and that discards whatever was pending before.
+    // Offer and render happen on different threads, hence the lock.
+    template <class Payload>
+    class DeferredRender
+    {
+        mutable std::mutex m_mutex;
+        std::optional<Payload> m_pending;
+
+    public:
+        void offer(Payload payload)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending = std::move(payload);
+        }
+
+        // WM_RENDERFORMAT or WM_RENDERALLFORMATS: hands out the payload once; nullopt if nothing is pending.
+        std::optional<Payload> take()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return std::exchange(m_pending, std::nullopt);
+        }
+
+        // WM_DESTROYCLIPBOARD: the clipboard was emptied and the data will never be asked for.
+        void discard() noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending.reset();
+        }
+
+        [[nodiscard]] bool pending() const noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_pending.has_value();
+        }
+    };
+}
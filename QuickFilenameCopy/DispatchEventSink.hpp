@@ -0,0 +1,123 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <windows.h>
+#include <oaidl.h>
+#include <ocidl.h>
+#include <wil/com.h>
+#include <wil/result.h>
+
+namespace
+{
+    // Minimal IDispatch sink for dispinterface events (DShellWindowsEvents, DShellFolderViewEvents, ...).
+    // The handler gets the DISPID and the arguments, in reverse order as IDispatch passes them.
+    class DispatchEventSink final : public IDispatch
+    {
+        std::atomic<ULONG> m_ref{ 1 };
+        IID m_diid;
+        std::function<void(DISPID, const DISPPARAMS&)> m_onInvoke;
+
+        DispatchEventSink(REFIID diid, std::function<void(DISPID, const DISPPARAMS&)> onInvoke)
+            : m_diid(diid), m_onInvoke(std::move(onInvoke))
+        {}
+
+    public:
+        [[nodiscard]]
+        static wil::com_ptr_t<IDispatch> create(REFIID diid, std::function<void(DISPID, const DISPPARAMS&)> onInvoke)
+        {
+            wil::com_ptr_t<IDispatch> sink;
+            sink.attach(new DispatchEventSink(diid, std::move(onInvoke)));
+            return sink;
+        }
+
+        IFACEMETHODIMP QueryInterface(REFIID riid, void** ppv) noexcept override
+        {
+            if (riid == IID_IUnknown || riid == IID_IDispatch || riid == m_diid)
+            {
+                *ppv = static_cast<IDispatch*>(this);
+                AddRef();
+                return S_OK;
+            }
+            *ppv = nullptr;
+            return E_NOINTERFACE;
+        }
+        IFACEMETHODIMP_(ULONG) AddRef() noexcept override
+        {
+            return ++m_ref;
+        }
+        IFACEMETHODIMP_(ULONG) Release() noexcept override
+        {
+            auto ref = --m_ref;
+            if (ref == 0)
+                delete this;
+            return ref;
+        }
+
+        IFACEMETHODIMP GetTypeInfoCount(UINT* pctinfo) noexcept override
+        {
+            *pctinfo = 0;
+            return S_OK;
+        }
+        IFACEMETHODIMP GetTypeInfo(UINT, LCID, ITypeInfo**) noexcept override
+        {
+            return E_NOTIMPL;
+        }
+        IFACEMETHODIMP GetIDsOfNames(REFIID, LPOLESTR*, UINT, LCID, DISPID*) noexcept override
+        {
+            return E_NOTIMPL;
+        }
+        IFACEMETHODIMP Invoke(DISPID dispIdMember, REFIID, LCID, WORD, DISPPARAMS* pDispParams, VARIANT*, EXCEPINFO*, UINT*) noexcept override
+        try
+        {
+            static const DISPPARAMS noArguments{};
+            m_onInvoke(dispIdMember, pDispParams != nullptr ? *pDispParams : noArguments);
+            return S_OK;
+        }
+        CATCH_RETURN();
+    };
+
+    // Advise/Unadvise pair for a connection point, unadvised on destruction.
+    class unique_connection
+    {
+        wil::com_ptr_t<IConnectionPoint> m_cp;
+        DWORD m_cookie{};
+
+    public:
+        unique_connection() = default;
+        unique_connection(const unique_connection&) = delete;
+        unique_connection& operator=(const unique_connection&) = delete;
+        unique_connection(unique_connection&& other) noexcept
+            : m_cp(std::move(other.m_cp)), m_cookie(std::exchange(other.m_cookie, 0))
+        {}
+        unique_connection& operator=(unique_connection&& other) noexcept
+        {
+            reset();
+            m_cp = std::move(other.m_cp);
+            m_cookie = std::exchange(other.m_cookie, 0);
+            return *this;
+        }
+        ~unique_connection() noexcept
+        {
+            reset();
+        }
+
+        void advise(IUnknown* source, REFIID diid, IDispatch* sink)
+        {
+            reset();
+            auto cpc = wil::com_query<IConnectionPointContainer>(source);
+            THROW_IF_FAILED(cpc->FindConnectionPoint(diid, &m_cp));
+            THROW_IF_FAILED(m_cp->Advise(sink, &m_cookie));
+        }
+
+        void reset() noexcept
+        {
+            if (m_cp && m_cookie != 0)
+            {
+                m_cp->Unadvise(m_cookie);
+            }
+            m_cookie = 0;
+            m_cp = nullptr;
+        }
+    };
+}
@@ -0,0 +1,228 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ESCAPE_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ESCAPE_TARGET_SSE2
+#define ESCAPE_TARGET_AVX2
+#else
+#include <cpuid.h>
+#define ESCAPE_TARGET_SSE2 __attribute__((target("sse2")))
+#define ESCAPE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+    enum class Escape : unsigned char
+    {
+        None,
+        Quote,      // "..."
+        Csv,        // "...", with embedded quotes doubled
+        Json,       // "...", with \ " and control characters escaped
+        PowerShell, // "...", with ` " $ and the typographic double quotes escaped by a backtick
+    };
+
+    // Finding the characters an escape has to rewrite. Paths rarely contain any, so the writer copies
+    // clean runs in bulk and only looks at single characters where the scan stops.
+    // The scan runs over 16 or 8 UTF-16 units at a time with AVX2 or SSE2, picked once at run time.
+    namespace escape_detail
+    {
+        template <Escape E>
+        constexpr bool needsEscape(std::uint32_t c) noexcept
+        {
+            switch (E)
+            {
+            case Escape::Csv:
+                return c == '"';
+            case Escape::Json:
+                return c == '"' || c == '\\' || c < 0x20;
+            case Escape::PowerShell:
+                return c == '`' || c == '"' || c == '$' || (c >= 0x201C && c <= 0x201E);
+            default:
+                return false;
+            }
+        }
+
+        // Index of the first character of s[0, n) that needs escaping, or n.
+        template <Escape E, class Char>
+        std::size_t scanScalar(const Char* s, std::size_t n) noexcept
+        {
+            for (std::size_t i = 0; i < n; i++)
+            {
+                if (needsEscape<E>(static_cast<std::uint32_t>(s[i])))
+                    return i;
+            }
+            return n;
+        }
+
+#if ESCAPE_SCAN_X86
+        inline unsigned lowestBit(unsigned mask) noexcept
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return index;
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        // 0xFFFF in the lanes that need escaping. SSE2 only compares signed words, so unsigned ranges
+        // are tested with the sign bit flipped on both sides.
+        template <Escape E>
+        ESCAPE_TARGET_SSE2 inline __m128i escapeMask(__m128i v) noexcept
+        {
+            const auto bias = _mm_set1_epi16(static_cast<short>(0x8000));
+            auto m = _mm_cmpeq_epi16(v, _mm_set1_epi16('"'));
+            if constexpr (E == Escape::Json)
+            {
+                m = _mm_or_si128(m, _mm_cmpeq_epi16(v, _mm_set1_epi16('\\')));
+                m = _mm_or_si128(m, _mm_cmplt_epi16(_mm_xor_si128(v, bias), _mm_set1_epi16(static_cast<short>(0x8000 + 0x20))));
+            }
+            else if constexpr (E == Escape::PowerShell)
+            {
+                m = _mm_or_si128(m, _mm_cmpeq_epi16(v, _mm_set1_epi16('`')));
+                m = _mm_or_si128(m, _mm_cmpeq_epi16(v, _mm_set1_epi16('$')));
+                auto quotes = _mm_xor_si128(_mm_sub_epi16(v, _mm_set1_epi16(0x201C)), bias);
+                m = _mm_or_si128(m, _mm_cmplt_epi16(quotes, _mm_set1_epi16(static_cast<short>(0x8000 + 3))));
+            }
+            return m;
+        }
+
+        template <Escape E>
+        ESCAPE_TARGET_AVX2 inline __m256i escapeMask(__m256i v) noexcept
+        {
+            const auto bias = _mm256_set1_epi16(static_cast<short>(0x8000));
+            auto m = _mm256_cmpeq_epi16(v, _mm256_set1_epi16('"'));
+            if constexpr (E == Escape::Json)
+            {
+                m = _mm256_or_si256(m, _mm256_cmpeq_epi16(v, _mm256_set1_epi16('\\')));
+                m = _mm256_or_si256(m, _mm256_cmpgt_epi16(_mm256_set1_epi16(static_cast<short>(0x8000 + 0x20)), _mm256_xor_si256(v, bias)));
+            }
+            else if constexpr (E == Escape::PowerShell)
+            {
+                m = _mm256_or_si256(m, _mm256_cmpeq_epi16(v, _mm256_set1_epi16('`')));
+                m = _mm256_or_si256(m, _mm256_cmpeq_epi16(v, _mm256_set1_epi16('$')));
+                auto quotes = _mm256_xor_si256(_mm256_sub_epi16(v, _mm256_set1_epi16(0x201C)), bias);
+                m = _mm256_or_si256(m, _mm256_cmpgt_epi16(_mm256_set1_epi16(static_cast<short>(0x8000 + 3)), quotes));
+            }
+            return m;
+        }
+
+        // Char must be a 16-bit code unit: wchar_t on Windows, char16_t elsewhere.
+        template <Escape E, class Char>
+        ESCAPE_TARGET_SSE2 std::size_t scanSse2(const Char* s, std::size_t n) noexcept
+        {
+            static_assert(sizeof(Char) == 2);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(escapeMask<E>(v)));
+                if (mask)
+                    return i + lowestBit(mask) / 2;
+            }
+            return i + scanScalar<E>(s + i, n - i);
+        }
+
+        template <Escape E, class Char>
+        ESCAPE_TARGET_AVX2 std::size_t scanAvx2(const Char* s, std::size_t n) noexcept
+        {
+            static_assert(sizeof(Char) == 2);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+                auto mask = static_cast<unsigned>(_mm256_movemask_epi8(escapeMask<E>(v)));
+                if (mask)
+                    return i + lowestBit(mask) / 2;
+            }
+            if (i + 8 <= n)
+            {
+                auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(escapeMask<E>(v)));
+                if (mask)
+                    return i + lowestBit(mask) / 2;
+                i += 8;
+            }
+            return i + scanScalar<E>(s + i, n - i);
+        }
+
+        enum class ScanLevel : unsigned char
+        {
+            Scalar,
+            Sse2,
+            Avx2,
+        };
+
+        inline ScanLevel detectScanLevel() noexcept
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            const int maxLeaf = info[0];
+            __cpuid(info, 1);
+            const bool sse2 = (info[3] & (1 << 26)) != 0;
+            const bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+            bool avx2 = false;
+            if (osAvx && maxLeaf >= 7)
+            {
+                __cpuidex(info, 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+#else
+            __builtin_cpu_init();
+            const bool sse2 = __builtin_cpu_supports("sse2");
+            const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+            return avx2 ? ScanLevel::Avx2 : sse2 ? ScanLevel::Sse2 : ScanLevel::Scalar;
+        }
+
+        inline ScanLevel scanLevel() noexcept
+        {
+            static const ScanLevel level = detectScanLevel();
+            return level;
+        }
+#endif
+    }
+
+    // Index of the first character of s[0, n) that the escape has to rewrite, or n.
+    // Strings of 16-bit code units (wchar_t on Windows, char16_t) are scanned with SIMD, others one by one.
+    template <Escape E, class Char>
+    std::size_t findEscape(const Char* s, std::size_t n) noexcept
+    {
+        using namespace escape_detail;
+
+        if constexpr (E == Escape::None || E == Escape::Quote)
+        {
+            return n;
+        }
+        else
+        {
+#if ESCAPE_SCAN_X86
+            // Below one vector the dispatch costs more than it saves.
+            if constexpr (sizeof(Char) == 2)
+            {
+                if (n >= 8)
+                {
+                    switch (scanLevel())
+                    {
+                    case ScanLevel::Avx2:
+                        return scanAvx2<E>(s, n);
+                    case ScanLevel::Sse2:
+                        return scanSse2<E>(s, n);
+                    default:
+                        break;
+                    }
+                }
+            }
+#endif
+            return scanScalar<E>(s, n);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <unordered_map>
+
+namespace
+{
+    // The foreground window, if it is one we copy from, kept up to date from foreground notifications so that
+    // the keyboard hook reads one atomic instead of asking for the window and its class.
+    // Whether a window is a target is decided once per window and cached. Windows that were destroyed are
+    // evicted lazily, when the cache is full, rather than from a system-wide destroy notification; a handle is
+    // not reused for a long time, since part of it counts the reuses of its slot.
+    // Handle is the window handle type (HWND); the classification and the liveness check (IsWindow) are passed
+    // in, so the logic has no OS calls.
+    template <class Handle>
+    class ForegroundTracker
+    {
+        // When the cache reaches this size the windows that no longer exist are dropped from it, or every window
+        // if most still exist; a window that falls out is classified again.
+        static constexpr std::size_t maxCachedWindows = 4096;
+
+        std::atomic<Handle> m_target{};
+        // Written by the notification thread only.
+        std::unordered_map<Handle, bool> m_isTarget;
+
+        template <class IsAlive>
+        void evictDead(IsAlive&& isAlive)
+        {
+            for (auto it = m_isTarget.begin(); it != m_isTarget.end();)
+            {
+                if (isAlive(it->first))
+                    ++it;
+                else
+                    it = m_isTarget.erase(it);
+            }
+            // Leave room for a while, so that the next new windows do not scan the cache again.
+            if (m_isTarget.size() >= maxCachedWindows * 3 / 4)
+                m_isTarget.clear();
+        }
+
+    public:
+        // The foreground window if it is a target, or null.
+        [[nodiscard]] Handle target() const noexcept { return m_target.load(std::memory_order_acquire); }
+
+        // A window came to the foreground. isTarget(window) is called for windows not seen before, isAlive(window)
+        // for the cached windows when the cache is full.
+        template <class IsTarget, class IsAlive>
+        void onForeground(Handle window, IsTarget&& isTarget, IsAlive&& isAlive)
+        {
+            if (window == Handle{})
+            {
+                m_target.store(Handle{}, std::memory_order_release);
+                return;
+            }
+
+            auto it = m_isTarget.find(window);
+            if (it == m_isTarget.end())
+            {
+                if (m_isTarget.size() >= maxCachedWindows)
+                    evictDead(isAlive);
+                it = m_isTarget.emplace(window, isTarget(window)).first;
+            }
+            m_target.store(it->second ? window : Handle{}, std::memory_order_release);
+        }
+    };
+}
@@ -0,0 +1,235 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <windows.h>
+#include <exdispid.h>
+#include <shlobj.h>
+#include <shobjidl.h>
+#include <wil/com.h>
+#include <wil/resource.h>
+
+#include "DispatchEventSink.hpp"
+#include "ShellNameSources.hpp"
+#include "OutputFormat.hpp"
+#include "SelectionDiffCache.hpp"
+#include "SelectionSnapshot.hpp"
+
+namespace
+{
+    struct CachedItem
+    {
+        std::wstring name;
+        std::wstring path;
+        std::uint8_t flags{}; // SelectionItemFlags
+    };
+
+    // The Items interface of OutputFormat over a SelectionDiffCache.
+    class CachedSelectionItems
+    {
+        const SelectionDiffCache<CachedItem>& m_cache;
+
+    public:
+        explicit CachedSelectionItems(const SelectionDiffCache<CachedItem>& cache) noexcept
+            : m_cache(cache)
+        {}
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_cache.size(); }
+        [[nodiscard]] bool empty() const noexcept { return m_cache.empty(); }
+        [[nodiscard]] std::wstring_view name(std::size_t i) const noexcept { return m_cache[i].name; }
+        [[nodiscard]] std::wstring_view path(std::size_t i) const noexcept { return m_cache[i].path; }
+        [[nodiscard]] std::uint8_t flags(std::size_t i) const noexcept { return m_cache[i].flags; }
+    };
+
+    // An owned copy of a cached selection, for rendering after the cache has moved on.
+    inline SelectionSnapshot snapshotOf(const SelectionDiffCache<CachedItem>& cache)
+    {
+        std::size_t chars = 0;
+        for (std::size_t i = 0; i < cache.size(); i++)
+        {
+            chars += cache[i].name.size() + cache[i].path.size();
+        }
+
+        SelectionSnapshot snapshot;
+        snapshot.reserve(cache.size(), chars);
+        for (std::size_t i = 0; i < cache.size(); i++)
+        {
+            const auto& item = cache[i];
+            snapshot.append(item.name, item.path, item.flags);
+        }
+        return snapshot;
+    }
+
+    // Whether a DShellFolderViewEvents event can mean that the items of the view, or their names, changed.
+    // Renames and moves do not fire SelectionChanged, so everything but the events known to be about
+    // presentation counts.
+    inline bool changesViewItems(DISPID dispId) noexcept
+    {
+        switch (dispId)
+        {
+        case DISPID_BEGINDRAG:
+        case DISPID_VIEWMODECHANGED:
+        case DISPID_FOCUSCHANGED:
+        case DISPID_VIEWPAINTDONE:
+        case DISPID_COLUMNSCHANGED:
+        case DISPID_CTRLMOUSEWHEEL:
+        case DISPID_ICONSIZECHANGED:
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    // Keeps the resolved names of the selection of each Explorer view between copies.
+    // Any DShellFolderViewEvents event that changesViewItems() marks a view dirty; a copy of an unchanged
+    // selection reuses the cache as is, otherwise the selection is fetched as one ID list and only newly selected items are resolved,
+    // locally through the shell namespace rather than by a call into Explorer per item.
+    // Used from the copy worker thread only; the event sink touches nothing but the dirty flag.
+    class SelectionTracker
+    {
+        struct ViewState
+        {
+            wil::com_ptr_t<IUnknown> view; // identity of the IShellView the state belongs to
+            unique_connection events;
+            std::shared_ptr<std::atomic<bool>> dirty = std::make_shared<std::atomic<bool>>(true);
+            bool subscribed{ false };
+            unsigned fields{};
+            std::string folder;
+            SelectionDiffCache<CachedItem> cache;
+        };
+
+        std::unordered_map<HWND, std::unique_ptr<ViewState>> m_views;
+
+        ViewState& stateOf(HWND hWnd, IFolderView2* pfv2)
+        {
+            auto psv = wil::com_query<IShellView>(pfv2);
+            auto identity = psv.query<IUnknown>();
+
+            auto& state = m_views[hWnd];
+            if (state && state->view == identity)
+                return *state;
+
+            // A new view: the window navigated, or we have not seen it yet. Drop views of closed windows meanwhile.
+            for (auto it = m_views.begin(); it != m_views.end();)
+            {
+                if (it->first != hWnd && !IsWindow(it->first))
+                    it = m_views.erase(it);
+                else
+                    ++it;
+            }
+
+            state = std::make_unique<ViewState>();
+            state->view = std::move(identity);
+
+            wil::com_ptr_t<IDispatch> pDisp;
+            if (SUCCEEDED(psv->GetItemObject(SVGIO_BACKGROUND, IID_PPV_ARGS(&pDisp))))
+            {
+                auto sink = DispatchEventSink::create(DIID_DShellFolderViewEvents, [dirty = state->dirty](DISPID dispId, const DISPPARAMS&) {
+                    if (changesViewItems(dispId))
+                        dirty->store(true, std::memory_order_release);
+                });
+                try
+                {
+                    state->events.advise(pDisp.get(), DIID_DShellFolderViewEvents, sink.get());
+                    state->subscribed = true;
+                }
+                CATCH_LOG();
+            }
+            return *state;
+        }
+
+        static std::wstring nameOf(PCIDLIST_ABSOLUTE pidl, SIGDN sigdn)
+        {
+            wil::unique_cotaskmem_string name;
+            THROW_IF_FAILED(SHGetNameFromIDList(pidl, sigdn, &name));
+            return name.get();
+        }
+
+    public:
+        // Brings the cached selection of hWnd's view up to date and returns it, or nullptr if the selection
+        // is not available as an ID list (for example nothing is selected) or cancelled() returned true
+        // before all new items were resolved.
+        template <class Cancelled>
+        const SelectionDiffCache<CachedItem>* selection(HWND hWnd, IFolderView2* pfv2, unsigned fields, Cancelled&& cancelled)
+        {
+            auto& state = stateOf(hWnd, pfv2);
+
+            // Clear the flag before fetching, so that a change during the fetch is seen by the next copy.
+            auto dirty = state.dirty->exchange(false, std::memory_order_acq_rel);
+            if (!dirty && state.subscribed && state.fields == fields && !state.cache.empty())
+            {
+                DBGPRINTLN("selection unchanged, {} items reused", state.cache.size());
+                return &state.cache;
+            }
+            // Until the cache is brought up to date it does not describe the selection.
+            auto stale = wil::scope_exit([&] { state.dirty->store(true, std::memory_order_release); });
+
+            wil::unique_stg_medium medium;
+            if (!fetchSelectionIdList(pfv2, medium))
+                return nullptr;
+
+            wil::unique_hglobal_locked data{ medium.hGlobal };
+            if (!data)
+                return nullptr;
+
+            Cida cida;
+            if (!parseCida(data.get(), GlobalSize(medium.hGlobal), cida) || cida.children.empty())
+                return nullptr;
+            const auto folder = cida.folder;
+            const auto& children = cida.children;
+
+            if (state.fields != fields || state.folder != folder)
+            {
+                state.cache.clear();
+                state.fields = fields;
+                state.folder.assign(folder);
+            }
+
+            auto folderPidl = reinterpret_cast<PCIDLIST_ABSOLUTE>(folder.data());
+            auto stats = state.cache.update(children, [&](std::size_t i) {
+                wil::unique_cotaskmem_ptr<ITEMIDLIST_ABSOLUTE> pidl{ ILCombine(folderPidl, reinterpret_cast<PCUIDLIST_RELATIVE>(children[i].data())) };
+                THROW_IF_NULL_ALLOC(pidl);
+
+                CachedItem item;
+                if (fields & IFF_NAME)
+                {
+                    item.name = nameOf(pidl.get(), SIGDN_NORMALDISPLAY);
+                    item.flags |= SIF_NAME;
+                }
+                if (fields & IFF_PATH)
+                {
+                    item.path = nameOf(pidl.get(), SIGDN_DESKTOPABSOLUTEPARSING);
+                    item.flags |= SIF_PATH;
+                }
+                if (fields & IFF_FILESYSPATH)
+                {
+                    // Fails for items outside the file system.
+                    wil::unique_cotaskmem_string fileSystemPath;
+                    if (SUCCEEDED(SHGetNameFromIDList(pidl.get(), SIGDN_FILESYSPATH, &fileSystemPath)) && item.path == fileSystemPath.get())
+                        item.flags |= SIF_FILESYSTEM;
+                }
+                return item;
+            }, cancelled);
+            if (stats.cancelled)
+            {
+                DBGPRINTLN("selection cancelled after {} items resolved", stats.resolved);
+                return nullptr;
+            }
+            DBGPRINTLN("selection reused={} resolved={} evicted={}", stats.reused, stats.resolved, stats.evicted);
+            stale.release();
+
+            return &state.cache;
+        }
+
+        // Releases every view. Call before COM is uninitialized.
+        void clear() noexcept
+        {
+            m_views.clear();
+        }
+    };
+}
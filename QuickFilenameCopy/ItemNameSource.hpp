@@ -0,0 +1,68 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "SelectionSnapshot.hpp"
+
+namespace
+{
+    // One item as handed over by an ItemNameSource. The views point into the source's own buffers and
+    // only stay valid until its next call to next(); readAllItems copies them into a SelectionSnapshot.
+    struct SelectionItem
+    {
+        std::wstring_view name;
+        std::wstring_view path;
+        std::uint8_t flags{}; // SelectionItemFlags: which of name and path the item has, and what the path is
+    };
+
+    // Produces the names of the selected items a chunk at a time.
+    class ItemNameSource
+    {
+    public:
+        virtual ~ItemNameSource() = default;
+
+        // Number of items the source will produce.
+        virtual std::uint32_t count() = 0;
+
+        // Stores up to `count` items and returns how many were stored; 0 once the source is exhausted.
+        virtual std::uint32_t next(SelectionItem* items, std::uint32_t count) = 0;
+    };
+
+    // Reads the items chunk by chunk. cancelled, if given, is asked before every chunk after the first;
+    // once it returns true the items read so far are returned.
+    inline SelectionSnapshot readAllItems(ItemNameSource& source, std::uint32_t chunkSize, const std::function<bool()>& cancelled = nullptr)
+    {
+        const std::size_t count = source.count();
+        std::vector<SelectionItem> chunk(std::min<std::size_t>(std::max<std::uint32_t>(chunkSize, 1), count));
+
+        // The arena is sized once the first chunk shows how long the names are, with an eighth to spare.
+        SelectionSnapshot snapshot;
+        snapshot.reserve(count, 0);
+        while (snapshot.size() < count)
+        {
+            if (cancelled && snapshot.size() > 0 && cancelled())
+                break;
+
+            auto wanted = static_cast<std::uint32_t>(std::min(chunk.size(), count - snapshot.size()));
+            auto fetched = source.next(chunk.data(), wanted);
+            if (fetched == 0)
+                break;
+
+            for (std::uint32_t i = 0; i < fetched; i++)
+            {
+                const auto& item = chunk[i];
+                snapshot.append(item.name, item.path, item.flags);
+            }
+            if (snapshot.size() == fetched)
+            {
+                const auto perItem = snapshot.chars() / snapshot.size() + 1;
+                snapshot.reserve(count, snapshot.chars() + perItem * (count - snapshot.size()) * 9 / 8);
+            }
+        }
+        return snapshot;
+    }
+}
@@ -0,0 +1,217 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "StdFormat.hpp"
+
+namespace
+{
+    using namespace std::string_view_literals;
+
+    // Log-linear (HDR-style) histogram of nanosecond latencies with about 6% relative precision.
+    // Values below 32 get one bucket each; above that every power of two is split into 16 buckets.
+    // record() is lock-free and may be called from any thread.
+    class LatencyHistogram
+    {
+        static constexpr unsigned subBucketBits = 4;
+        static constexpr std::uint64_t subBucketCount = 1ull << subBucketBits;
+        static constexpr std::size_t bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+        std::array<std::atomic<std::uint64_t>, bucketCount> m_buckets{};
+        std::atomic<std::uint64_t> m_count{ 0 };
+        std::atomic<std::uint64_t> m_sum{ 0 };
+        std::atomic<std::uint64_t> m_max{ 0 };
+
+        static constexpr unsigned mostSignificantBit(std::uint64_t v) noexcept
+        {
+            unsigned msb = 0;
+            for (unsigned shift = 32; shift != 0; shift /= 2)
+            {
+                if (v >> shift)
+                {
+                    v >>= shift;
+                    msb += shift;
+                }
+            }
+            return msb;
+        }
+
+    public:
+        static constexpr std::size_t bucketOf(std::uint64_t v) noexcept
+        {
+            if (v < 2 * subBucketCount)
+                return static_cast<std::size_t>(v);
+
+            unsigned shift = mostSignificantBit(v) - subBucketBits;
+            return static_cast<std::size_t>((shift + 1) * subBucketCount + ((v >> shift) - subBucketCount));
+        }
+
+        // Smallest value that falls into the bucket.
+        static constexpr std::uint64_t lowerBoundOf(std::size_t bucket) noexcept
+        {
+            if (bucket < 2 * subBucketCount)
+                return bucket;
+
+            auto shift = bucket / subBucketCount - 1;
+            return (subBucketCount + bucket % subBucketCount) << shift;
+        }
+
+        static constexpr std::uint64_t upperBoundOf(std::size_t bucket) noexcept
+        {
+            return bucket + 1 < bucketCount ? lowerBoundOf(bucket + 1) - 1 : UINT64_MAX;
+        }
+
+        void record(std::uint64_t ns) noexcept
+        {
+            m_buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(ns, std::memory_order_relaxed);
+
+            auto max = m_max.load(std::memory_order_relaxed);
+            while (ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void reset() noexcept
+        {
+            for (auto& bucket : m_buckets)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            m_count = 0;
+            m_sum = 0;
+            m_max = 0;
+        }
+
+        [[nodiscard]] std::uint64_t count() const noexcept { return m_count.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::uint64_t max() const noexcept { return m_max.load(std::memory_order_relaxed); }
+        [[nodiscard]] std::uint64_t mean() const noexcept
+        {
+            auto count = this->count();
+            return count == 0 ? 0 : m_sum.load(std::memory_order_relaxed) / count;
+        }
+
+        // Upper bound of the bucket holding the p-th percentile (0 < p <= 100), capped at the recorded maximum.
+        [[nodiscard]]
+        std::uint64_t percentile(double p) const noexcept
+        {
+            auto count = this->count();
+            if (count == 0)
+                return 0;
+
+            auto rank = static_cast<std::uint64_t>(p / 100.0 * static_cast<double>(count) + 0.5);
+            if (rank == 0)
+                rank = 1;
+
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < bucketCount; i++)
+            {
+                seen += m_buckets[i].load(std::memory_order_relaxed);
+                if (seen >= rank)
+                    return std::min(upperBoundOf(i), max());
+            }
+            return max();
+        }
+    };
+
+    enum class LatencyStage : unsigned char
+    {
+        Hook,      // keyboard hook entry to return, for every keystroke
+        Lookup,    // finding the folder view of the foreground Explorer
+        Selection, // fetching the selected items
+        Sort,      // ordering the items by the configured sort mode
+        Format,    // rendering the text into the clipboard block
+        Clipboard, // publishing the clipboard block
+        Total,     // chord press to clipboard published
+        Count,
+    };
+
+    class LatencyStats
+    {
+        std::array<LatencyHistogram, static_cast<std::size_t>(LatencyStage::Count)> m_histograms;
+
+        static constexpr std::wstring_view stageNames[] = {
+            L"Hook"sv, L"Lookup"sv, L"Selection"sv, L"Sort"sv, L"Format"sv, L"Clipboard"sv, L"Total"sv,
+        };
+        static_assert(std::size(stageNames) == static_cast<std::size_t>(LatencyStage::Count));
+
+    public:
+        static LatencyStats& instance() noexcept
+        {
+            static LatencyStats stats;
+            return stats;
+        }
+
+        static std::int64_t now() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        LatencyHistogram& operator[](LatencyStage stage) noexcept
+        {
+            return m_histograms[static_cast<std::size_t>(stage)];
+        }
+
+        void recordSince(LatencyStage stage, std::int64_t start) noexcept
+        {
+            auto elapsed = now() - start;
+            (*this)[stage].record(elapsed > 0 ? static_cast<std::uint64_t>(elapsed) : 0);
+        }
+
+        void reset() noexcept
+        {
+            for (auto& histogram : m_histograms)
+            {
+                histogram.reset();
+            }
+        }
+
+        // One line per stage, latencies in microseconds.
+        [[nodiscard]]
+        std::wstring report() const
+        {
+            auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+
+            std::wstring text = std::format(L"{:<10}{:>10}{:>10}{:>10}{:>10}{:>10}{:>10}{:>10}\r\n"sv,
+                L"stage (us)"sv, L"count"sv, L"mean"sv, L"p50"sv, L"p90"sv, L"p99"sv, L"p99.9"sv, L"max"sv);
+            for (std::size_t i = 0; i < m_histograms.size(); i++)
+            {
+                const auto& h = m_histograms[i];
+                text += std::format(L"{:<10}{:>10}{:>10.1f}{:>10.1f}{:>10.1f}{:>10.1f}{:>10.1f}{:>10.1f}\r\n"sv,
+                    stageNames[i], h.count(), us(h.mean()), us(h.percentile(50)), us(h.percentile(90)),
+                    us(h.percentile(99)), us(h.percentile(99.9)), us(h.max()));
+            }
+            return text;
+        }
+    };
+
+    // Records the lifetime of the scope into a latency stage.
+    class ScopedLatency
+    {
+        LatencyStats& m_stats;
+        LatencyStage m_stage;
+        std::int64_t m_start;
+
+    public:
+        explicit ScopedLatency(LatencyStage stage) noexcept
+            : ScopedLatency(LatencyStats::instance(), stage)
+        {}
+        ScopedLatency(LatencyStats& stats, LatencyStage stage) noexcept
+            : m_stats(stats), m_stage(stage), m_start(LatencyStats::now())
+        {}
+        ScopedLatency(const ScopedLatency&) = delete;
+        ScopedLatency& operator=(const ScopedLatency&) = delete;
+        ~ScopedLatency() noexcept
+        {
+            m_stats.recordSince(m_stage, m_start);
+        }
+    };
+}
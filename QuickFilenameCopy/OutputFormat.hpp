@@ -0,0 +1,548 @@
+#pragma once
+#include <cstddef>
+#include <cwchar>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "EscapeScan.hpp"
+#include "PathInterner.hpp"
+
+namespace
+{
+    using namespace std::string_view_literals;
+
+    enum ItemFieldFlags : unsigned
+    {
+        IFF_NAME = 0x1, // display name as shown by Explorer
+        IFF_PATH = 0x2, // absolute parsing name, a file system path for ordinary files
+        IFF_FILESYSPATH = 0x4, // with IFF_PATH: whether the parsing name is the item's file system path
+    };
+
+    enum class ItemField : unsigned char
+    {
+        Name,
+        Path,
+        Dir,
+        FileName,
+        Stem,
+        Ext,
+    };
+
+    struct FormatOp
+    {
+        enum Kind : unsigned char
+        {
+            Literal,
+            Field,
+        };
+
+        Kind kind;
+        ItemField field;
+        Escape escape;
+        std::wstring_view text;
+
+        static constexpr FormatOp literal(std::wstring_view text) noexcept
+        {
+            return { Literal, ItemField::Name, Escape::None, text };
+        }
+        static constexpr FormatOp of(ItemField field, Escape escape = Escape::None) noexcept
+        {
+            return { Field, field, escape, {} };
+        }
+    };
+
+    // Text around the items: prefix + item + separator + item + ... + suffix.
+    struct FormatFrame
+    {
+        std::wstring_view prefix;
+        std::wstring_view separator;
+        std::wstring_view suffix;
+    };
+
+    namespace format_detail
+    {
+        // ".profile" has no extension, "archive.tar.gz" has ".gz".
+        constexpr std::size_t extPos(std::wstring_view fileName) noexcept
+        {
+            auto pos = fileName.rfind(L'.');
+            return pos == std::wstring_view::npos || pos == 0 ? fileName.size() : pos;
+        }
+
+        template <class Items, class = void>
+        struct has_path_parts : std::false_type {};
+
+        template <class Items>
+        struct has_path_parts<Items, std::void_t<decltype(std::declval<const Items&>().pathParts(std::size_t{}))>> : std::true_type {};
+
+        // The path of item i as the folder prefix, including the trailing separator, and the leaf.
+        // Items that intern their folders hand out the parts directly; for the others the path is split here.
+        template <class Items>
+        std::pair<std::wstring_view, std::wstring_view> pathPartsOf(const Items& items, std::size_t i) noexcept
+        {
+            if constexpr (has_path_parts<Items>::value)
+            {
+                return items.pathParts(i);
+            }
+            else
+            {
+                auto path = items.path(i);
+                auto leafPos = leafPosOf(path);
+                return { path.substr(0, leafPos), path.substr(leafPos) };
+            }
+        }
+
+        // A field value in up to two pieces, written one after the other: a path is its folder prefix
+        // followed by its leaf, and is never joined into one string just to be copied out again.
+        struct FieldText
+        {
+            std::wstring_view head;
+            std::wstring_view tail;
+        };
+
+        template <class Items>
+        FieldText fieldOf(const Items& items, std::size_t i, ItemField field) noexcept
+        {
+            if (field == ItemField::Name)
+                return { {}, items.name(i) };
+
+            auto [prefix, leaf] = pathPartsOf(items, i);
+            switch (field)
+            {
+            case ItemField::Path:
+                return { prefix, leaf };
+            case ItemField::Dir:
+                return { {}, prefix.substr(0, prefix.empty() ? 0 : prefix.size() - 1) };
+            case ItemField::FileName:
+                return { {}, leaf };
+            case ItemField::Stem:
+                return { {}, leaf.substr(0, extPos(leaf)) };
+            case ItemField::Ext:
+                return { {}, leaf.substr(extPos(leaf)) };
+            default:
+                return {};
+            }
+        }
+
+        inline wchar_t* append(wchar_t* dest, std::wstring_view s) noexcept
+        {
+            std::wmemcpy(dest, s.data(), s.size());
+            return dest + s.size();
+        }
+
+        constexpr wchar_t hexDigit(unsigned v) noexcept
+        {
+            return static_cast<wchar_t>(v < 10 ? L'0' + v : L'a' + v - 10);
+        }
+
+        // Characters the escape adds around the value.
+        constexpr std::size_t quotesOf(Escape escape) noexcept
+        {
+            return escape == Escape::None ? 0 : 2;
+        }
+
+        // What the escape writes for a character findEscape stopped at.
+        template <Escape E>
+        constexpr std::size_t escapedCharSize(wchar_t c) noexcept
+        {
+            if constexpr (E == Escape::Json)
+            {
+                if (c == L'"' || c == L'\\' || c == L'\n' || c == L'\r' || c == L'\t')
+                    return 2;
+                return 6; // \u00XX
+            }
+            else
+            {
+                return 2; // "" for Csv, `c for PowerShell
+            }
+        }
+
+        template <Escape E>
+        wchar_t* writeEscapedChar(wchar_t* dest, wchar_t c) noexcept
+        {
+            if constexpr (E == Escape::Csv)
+            {
+                *dest++ = L'"';
+                *dest++ = c;
+            }
+            else if constexpr (E == Escape::PowerShell)
+            {
+                *dest++ = L'`';
+                *dest++ = c;
+            }
+            else if constexpr (E == Escape::Json)
+            {
+                switch (c)
+                {
+                case L'"': *dest++ = L'\\'; *dest++ = L'"'; break;
+                case L'\\': *dest++ = L'\\'; *dest++ = L'\\'; break;
+                case L'\n': *dest++ = L'\\'; *dest++ = L'n'; break;
+                case L'\r': *dest++ = L'\\'; *dest++ = L'r'; break;
+                case L'\t': *dest++ = L'\\'; *dest++ = L't'; break;
+                default:
+                    dest = append(dest, L"\\u00"sv);
+                    *dest++ = hexDigit(static_cast<unsigned>(c) >> 4);
+                    *dest++ = hexDigit(static_cast<unsigned>(c) & 0xF);
+                    break;
+                }
+            }
+            return dest;
+        }
+
+        // Size of s escaped, without the surrounding quotes.
+        template <Escape E>
+        std::size_t escapedBodySize(std::wstring_view s) noexcept
+        {
+            std::size_t cch = s.size();
+            for (auto pos = findEscape<E>(s.data(), s.size()); pos < s.size();)
+            {
+                cch += escapedCharSize<E>(s[pos]) - 1;
+                pos += 1 + findEscape<E>(s.data() + pos + 1, s.size() - pos - 1);
+            }
+            return cch;
+        }
+
+        // Copies the runs between characters that need escaping in bulk.
+        template <Escape E>
+        wchar_t* writeEscapedBody(wchar_t* dest, std::wstring_view s) noexcept
+        {
+            for (;;)
+            {
+                auto run = findEscape<E>(s.data(), s.size());
+                dest = append(dest, s.substr(0, run));
+                if (run == s.size())
+                    return dest;
+                dest = writeEscapedChar<E>(dest, s[run]);
+                s.remove_prefix(run + 1);
+            }
+        }
+
+        inline std::size_t escapedBodySize(std::wstring_view s, Escape escape) noexcept
+        {
+            switch (escape)
+            {
+            case Escape::Csv: return escapedBodySize<Escape::Csv>(s);
+            case Escape::Json: return escapedBodySize<Escape::Json>(s);
+            case Escape::PowerShell: return escapedBodySize<Escape::PowerShell>(s);
+            default: return s.size();
+            }
+        }
+
+        inline wchar_t* writeEscapedBody(wchar_t* dest, std::wstring_view s, Escape escape) noexcept
+        {
+            switch (escape)
+            {
+            case Escape::Csv: return writeEscapedBody<Escape::Csv>(dest, s);
+            case Escape::Json: return writeEscapedBody<Escape::Json>(dest, s);
+            case Escape::PowerShell: return writeEscapedBody<Escape::PowerShell>(dest, s);
+            default: return append(dest, s);
+            }
+        }
+
+        // The quotes go once around the whole value; each piece is escaped on its own.
+        inline std::size_t escapedSize(const FieldText& text, Escape escape) noexcept
+        {
+            return quotesOf(escape) + escapedBodySize(text.head, escape) + escapedBodySize(text.tail, escape);
+        }
+
+        inline wchar_t* writeEscaped(wchar_t* dest, const FieldText& text, Escape escape) noexcept
+        {
+            if (escape != Escape::None)
+                *dest++ = L'"';
+            dest = writeEscapedBody(dest, text.head, escape);
+            dest = writeEscapedBody(dest, text.tail, escape);
+            if (escape != Escape::None)
+                *dest++ = L'"';
+            return dest;
+        }
+
+        // Renders items [begin, end) of a selection of items.size() items.
+        // Rendering consecutive ranges and concatenating them gives the same text as rendering everything at once.
+        template <class Items, class Ops>
+        std::size_t measure(const Items& items, std::size_t begin, std::size_t end, const Ops& ops, const FormatFrame& frame) noexcept
+        {
+            std::size_t cch = 0;
+            if (begin == 0)
+                cch += frame.prefix.size();
+            for (auto i = begin; i < end; i++)
+            {
+                if (i > 0)
+                    cch += frame.separator.size();
+                for (const auto& op : ops)
+                {
+                    cch += op.kind == FormatOp::Literal ? op.text.size() : escapedSize(fieldOf(items, i, op.field), op.escape);
+                }
+            }
+            if (end == items.size())
+                cch += frame.suffix.size();
+            return cch;
+        }
+
+        template <class Items, class Ops>
+        wchar_t* write(const Items& items, std::size_t begin, std::size_t end, const Ops& ops, const FormatFrame& frame, wchar_t* dest) noexcept
+        {
+            if (begin == 0)
+                dest = append(dest, frame.prefix);
+            for (auto i = begin; i < end; i++)
+            {
+                if (i > 0)
+                    dest = append(dest, frame.separator);
+                for (const auto& op : ops)
+                {
+                    dest = op.kind == FormatOp::Literal ? append(dest, op.text) : writeEscaped(dest, fieldOf(items, i, op.field), op.escape);
+                }
+            }
+            if (end == items.size())
+                dest = append(dest, frame.suffix);
+            return dest;
+        }
+
+        template <class Ops>
+        constexpr unsigned requiredFields(const Ops& ops) noexcept
+        {
+            unsigned fields = 0;
+            for (const auto& op : ops)
+            {
+                if (op.kind == FormatOp::Field)
+                    fields |= op.field == ItemField::Name ? IFF_NAME : IFF_PATH;
+            }
+            return fields;
+        }
+    }
+
+    enum class BuiltinFormat : unsigned char
+    {
+        Names,
+        Paths,
+        Quoted,
+        Csv,
+        Json,
+        PowerShell,
+        Template,
+    };
+
+    template <BuiltinFormat F>
+    struct Builtin;
+
+    template <>
+    struct Builtin<BuiltinFormat::Names>
+    {
+        static constexpr FormatOp ops[] = { FormatOp::of(ItemField::Name) };
+        static constexpr FormatFrame frame{ L""sv, L"\n"sv, L""sv };
+    };
+
+    template <>
+    struct Builtin<BuiltinFormat::Paths>
+    {
+        static constexpr FormatOp ops[] = { FormatOp::of(ItemField::Path) };
+        static constexpr FormatFrame frame{ L""sv, L"\n"sv, L""sv };
+    };
+
+    template <>
+    struct Builtin<BuiltinFormat::Quoted>
+    {
+        static constexpr FormatOp ops[] = { FormatOp::of(ItemField::Path, Escape::Quote) };
+        static constexpr FormatFrame frame{ L""sv, L" "sv, L""sv };
+    };
+
+    template <>
+    struct Builtin<BuiltinFormat::Csv>
+    {
+        static constexpr FormatOp ops[] = {
+            FormatOp::of(ItemField::Name, Escape::Csv),
+            FormatOp::literal(L","sv),
+            FormatOp::of(ItemField::Path, Escape::Csv),
+        };
+        static constexpr FormatFrame frame{ L""sv, L"\r\n"sv, L"\r\n"sv };
+    };
+
+    template <>
+    struct Builtin<BuiltinFormat::Json>
+    {
+        static constexpr FormatOp ops[] = { FormatOp::of(ItemField::Path, Escape::Json) };
+        static constexpr FormatFrame frame{ L"["sv, L","sv, L"]"sv };
+    };
+
+    template <>
+    struct Builtin<BuiltinFormat::PowerShell>
+    {
+        static constexpr FormatOp ops[] = { FormatOp::of(ItemField::Path, Escape::PowerShell) };
+        static constexpr FormatFrame frame{ L""sv, L", "sv, L""sv };
+    };
+
+    // An output format: one of the built-in formats, whose op lists are compile-time constants,
+    // or a user template such as "{dir}\{stem}{ext}" compiled once into an op list.
+    class OutputFormat
+    {
+        BuiltinFormat m_kind{ BuiltinFormat::Names };
+        std::shared_ptr<const std::wstring> m_text; // backing store for the template's literals and frame
+        std::vector<FormatOp> m_ops;
+        FormatFrame m_frame;
+
+        template <class F>
+        auto dispatch(F&& f) const
+        {
+            switch (m_kind)
+            {
+            case BuiltinFormat::Paths:
+                return f(Builtin<BuiltinFormat::Paths>::ops, Builtin<BuiltinFormat::Paths>::frame);
+            case BuiltinFormat::Quoted:
+                return f(Builtin<BuiltinFormat::Quoted>::ops, Builtin<BuiltinFormat::Quoted>::frame);
+            case BuiltinFormat::Csv:
+                return f(Builtin<BuiltinFormat::Csv>::ops, Builtin<BuiltinFormat::Csv>::frame);
+            case BuiltinFormat::Json:
+                return f(Builtin<BuiltinFormat::Json>::ops, Builtin<BuiltinFormat::Json>::frame);
+            case BuiltinFormat::PowerShell:
+                return f(Builtin<BuiltinFormat::PowerShell>::ops, Builtin<BuiltinFormat::PowerShell>::frame);
+            case BuiltinFormat::Template:
+                return f(m_ops, m_frame);
+            case BuiltinFormat::Names:
+            default:
+                return f(Builtin<BuiltinFormat::Names>::ops, Builtin<BuiltinFormat::Names>::frame);
+            }
+        }
+
+        static std::optional<ItemField> parseField(std::wstring_view name) noexcept
+        {
+            if (name == L"name"sv) return ItemField::Name;
+            if (name == L"path"sv) return ItemField::Path;
+            if (name == L"dir"sv) return ItemField::Dir;
+            if (name == L"filename"sv) return ItemField::FileName;
+            if (name == L"stem"sv) return ItemField::Stem;
+            if (name == L"ext"sv) return ItemField::Ext;
+            return std::nullopt;
+        }
+
+        static std::optional<Escape> parseEscape(std::wstring_view name) noexcept
+        {
+            if (name.empty()) return Escape::None;
+            if (name == L"quote"sv) return Escape::Quote;
+            if (name == L"csv"sv) return Escape::Csv;
+            if (name == L"json"sv) return Escape::Json;
+            if (name == L"powershell"sv) return Escape::PowerShell;
+            return std::nullopt;
+        }
+
+    public:
+        OutputFormat() = default;
+
+        explicit OutputFormat(BuiltinFormat kind) noexcept
+            : m_kind(kind == BuiltinFormat::Template ? BuiltinFormat::Names : kind)
+        {}
+
+        // Compiles a per-item template. Fields are written as {name}, {path}, {dir}, {filename}, {stem} or {ext},
+        // optionally with an escape: {path:quote}, {path:csv}, {path:json}, {path:powershell}.
+        // "{{" and "}}" are literal braces.
+        // Returns nullopt if the template is malformed.
+        static std::optional<OutputFormat> compile(std::wstring_view templ, std::wstring_view separator)
+        {
+            auto text = std::make_shared<std::wstring>();
+            text->reserve(templ.size() + separator.size());
+            text->append(separator);
+
+            // Literal runs are collected as offsets into text first; views are taken once text stops growing.
+            struct PendingOp
+            {
+                FormatOp op;
+                std::size_t offset;
+                std::size_t length;
+            };
+            std::vector<PendingOp> pending;
+
+            auto pushLiteral = [&](wchar_t c) {
+                if (pending.empty() || pending.back().op.kind != FormatOp::Literal)
+                    pending.push_back({ FormatOp::literal({}), text->size(), 0 });
+                text->push_back(c);
+                pending.back().length++;
+            };
+
+            for (std::size_t i = 0; i < templ.size(); i++)
+            {
+                auto c = templ[i];
+                if (c == L'{' && i + 1 < templ.size() && templ[i + 1] == L'{')
+                {
+                    pushLiteral(L'{');
+                    i++;
+                }
+                else if (c == L'}' && i + 1 < templ.size() && templ[i + 1] == L'}')
+                {
+                    pushLiteral(L'}');
+                    i++;
+                }
+                else if (c == L'{')
+                {
+                    auto close = templ.find(L'}', i);
+                    if (close == std::wstring_view::npos)
+                        return std::nullopt;
+
+                    auto spec = templ.substr(i + 1, close - i - 1);
+                    auto colon = spec.find(L':');
+                    auto field = parseField(spec.substr(0, colon));
+                    auto escape = parseEscape(colon == std::wstring_view::npos ? std::wstring_view{} : spec.substr(colon + 1));
+                    if (!field || !escape)
+                        return std::nullopt;
+
+                    pending.push_back({ FormatOp::of(*field, *escape), 0, 0 });
+                    i = close;
+                }
+                else if (c == L'}')
+                {
+                    return std::nullopt;
+                }
+                else
+                {
+                    pushLiteral(c);
+                }
+            }
+
+            OutputFormat format;
+            format.m_kind = BuiltinFormat::Template;
+            format.m_ops.reserve(pending.size());
+            for (auto& p : pending)
+            {
+                if (p.op.kind == FormatOp::Literal)
+                    p.op.text = std::wstring_view{ text->data() + p.offset, p.length };
+                format.m_ops.push_back(p.op);
+            }
+            format.m_frame = { {}, std::wstring_view{ text->data(), separator.size() }, {} };
+            format.m_text = std::move(text);
+            return format;
+        }
+
+        [[nodiscard]]
+        BuiltinFormat kind() const noexcept
+        {
+            return m_kind;
+        }
+
+        // Combination of ItemFieldFlags the items must provide.
+        [[nodiscard]]
+        unsigned requiredFields() const noexcept
+        {
+            return dispatch([](const auto& ops, const FormatFrame&) { return format_detail::requiredFields(ops); });
+        }
+
+        // Number of characters (without terminator) needed for items [begin, end).
+        template <class Items>
+        [[nodiscard]]
+        std::size_t measure(const Items& items, std::size_t begin, std::size_t end) const noexcept
+        {
+            return dispatch([&](const auto& ops, const FormatFrame& frame) {
+                return format_detail::measure(items, begin, end, ops, frame);
+            });
+        }
+
+        // Writes exactly measure(items, begin, end) characters to dest and returns the end.
+        template <class Items>
+        wchar_t* write(const Items& items, std::size_t begin, std::size_t end, wchar_t* dest) const noexcept
+        {
+            return dispatch([&](const auto& ops, const FormatFrame& frame) {
+                return format_detail::write(items, begin, end, ops, frame, dest);
+            });
+        }
+    };
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    // Splits a path after its last separator: "C:\dir\file.txt" into "C:\dir\" and "file.txt".
+    // A path without a separator is all leaf.
+    constexpr std::size_t leafPosOf(std::wstring_view path) noexcept
+    {
+        auto pos = path.find_last_of(L"\\/");
+        return pos == std::wstring_view::npos ? 0 : pos + 1;
+    }
+
+    // Parent folder prefixes of paths, each stored once however many paths share it.
+    // A path is kept as a prefix id and its leaf, so writing it out is two copies and thousands of files
+    // from one folder cost one copy of the folder. Prefixes include the trailing separator.
+    class PathInterner
+    {
+        // Prefixes are views of the keys, which stay put because the map allocates a node per entry.
+        std::unordered_map<std::wstring, std::uint32_t> m_ids;
+        std::vector<std::wstring_view> m_prefixes;
+        std::uint32_t m_last{};
+
+    public:
+        struct Split
+        {
+            std::uint32_t prefixId;
+            std::wstring_view leaf; // a view of the path passed to intern()
+        };
+
+        PathInterner() = default;
+        PathInterner(PathInterner&&) noexcept = default;
+        PathInterner& operator=(PathInterner&&) noexcept = default;
+        PathInterner(const PathInterner&) = delete;
+        PathInterner& operator=(const PathInterner&) = delete;
+
+        Split intern(std::wstring_view path)
+        {
+            auto leafPos = leafPosOf(path);
+            auto prefix = path.substr(0, leafPos);
+
+            // Consecutive paths nearly always share the folder; compare before hashing.
+            if (!m_prefixes.empty() && m_prefixes[m_last] == prefix)
+                return { m_last, path.substr(leafPos) };
+
+            auto [it, inserted] = m_ids.try_emplace(std::wstring{ prefix }, static_cast<std::uint32_t>(m_prefixes.size()));
+            if (inserted)
+                m_prefixes.emplace_back(it->first);
+            m_last = it->second;
+            return { m_last, path.substr(leafPos) };
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_prefixes.size(); }
+
+        // The folder prefix including the trailing separator, empty for paths without one.
+        [[nodiscard]] std::wstring_view prefix(std::uint32_t id) const noexcept { return m_prefixes[id]; }
+
+        // The folder itself: the prefix without the trailing separator.
+        [[nodiscard]]
+        std::wstring_view folder(std::uint32_t id) const noexcept
+        {
+            auto prefix = m_prefixes[id];
+            return prefix.substr(0, prefix.empty() ? 0 : prefix.size() - 1);
+        }
+
+        // Approximate heap bytes, for the benchmark report.
+        [[nodiscard]]
+        std::size_t bytes() const noexcept
+        {
+            std::size_t n = m_prefixes.capacity() * sizeof(std::wstring_view) + m_ids.bucket_count() * sizeof(void*);
+            for (const auto& [prefix, id] : m_ids)
+            {
+                n += sizeof(std::pair<const std::wstring, std::uint32_t>) + 2 * sizeof(void*);
+                if (prefix.capacity() > std::wstring{}.capacity())
+                    n += (prefix.capacity() + 1) * sizeof(wchar_t);
+            }
+            return n;
+        }
+    };
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ChordEngine.hpp"
+#include "CidaParser.hpp"
+#include "ComponentBenchmarks.hpp"
+#include "ItemNameSource.hpp"
+#include "LatencyHistogram.hpp"
+#include "SelectionSnapshot.hpp"
+#include "ShellWindowIndex.hpp"
+#include "SimulatedShell.hpp"
+#include "SpscQueue.hpp"
+#include "StdFormat.hpp"
+
+namespace
+{
+    using namespace std::string_view_literals;
+
+    // The settings a benchmark run replays the pipeline with.
+    struct PipelineBenchmarkConfig
+    {
+        std::uint32_t itemChunkSize = 256;
+        std::size_t formatChunkSize = 16384;
+        unsigned fields{};         // ItemFieldFlags the format and the extra clipboard formats read
+        std::vector<Chord> chords; // bindings the simulated keystrokes are matched against
+    };
+
+    // Replays the copy pipeline against SimulatedShell and returns the report. publish(items, stats) stands in
+    // for everything after the selection is read: sorting, rendering and the clipboard. It records its own
+    // stages in stats and returns the number of characters of text it rendered.
+    // Latencies go to their own LatencyStats so that a benchmark never mixes with live numbers.
+    template <class Publish>
+    std::wstring runPipelineBenchmark(const BenchmarkOptions& options, const PipelineBenchmarkConfig& config, Publish&& publish)
+    {
+        auto stats = std::make_unique<LatencyStats>();
+        ShellWindowIndex<SimulatedShellWindows> index{ std::max<std::uint32_t>(options.windows, 1), options.lookupLatencyUs };
+        index.rebuild();
+
+        std::uint64_t chars{};
+        SelectionSnapshot lastItems;
+        const auto started = LatencyStats::now();
+        for (std::uint32_t i = 0; i < options.iterations; i++)
+        {
+            const auto queuedAt = LatencyStats::now();
+            {
+                ScopedLatency latency{ *stats, LatencyStage::Lookup };
+                if (!index.find(index.backend().window(i)))
+                    continue;
+            }
+
+            SelectionSnapshot items;
+            {
+                ScopedLatency latency{ *stats, LatencyStage::Selection };
+                SimulatedNameSource source{ options, config.fields };
+                items = readAllItems(source, config.itemChunkSize);
+            }
+            chars += publish(static_cast<const SelectionSnapshot&>(items), *stats);
+            stats->recordSince(LatencyStage::Total, queuedAt);
+            lastItems = std::move(items);
+        }
+        const auto seconds = std::max(static_cast<double>(LatencyStats::now() - started) / 1e9, 1e-9);
+        const auto strings = compareWithStringVectors(lastItems);
+
+        // The hook's share: classifying keystrokes against the configured chords. The system's key state, which
+        // the hook reads when the engine asks, is a table here; the report counts how often it was read.
+        const auto keyEvents = simulatedKeyStream(options.keyEvents);
+        ChordEngine engine;
+        engine.bind(config.chords);
+        std::array<bool, 256> keyState{};
+        std::size_t chords{};
+        std::size_t resyncs{};
+        const auto keysStarted = LatencyStats::now();
+        for (const auto& event : keyEvents)
+        {
+            auto binding = engine.onKey(event.vk, event.down, event.time);
+            if (binding == ChordEngine::needsResync)
+            {
+                resyncs++;
+                engine.resync([&](std::uint8_t vk) { return keyState[vk]; });
+                binding = engine.onKey(event.vk, event.down, event.time);
+            }
+            keyState[event.vk] = event.down;
+            chords += binding >= 0;
+        }
+        const auto keyNs = static_cast<double>(LatencyStats::now() - keysStarted) / std::max<std::size_t>(keyEvents.size(), 1);
+
+        // The hand-off from the hook to the copy worker: one producer and one consumer thread on a small ring,
+        // one request per key event.
+        SpscQueue<std::uint64_t, 16> queue;
+        std::uint64_t received{};
+        const auto queueStarted = LatencyStats::now();
+        std::thread consumer{ [&] {
+            std::uint64_t request{};
+            for (std::size_t n = 0; n < keyEvents.size();)
+            {
+                if (!queue.try_pop(request))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                received += request;
+                n++;
+            }
+        } };
+        for (std::size_t i = 0; i < keyEvents.size(); i++)
+        {
+            while (!queue.try_push(i + 1))
+            {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+        const auto queueNs = static_cast<double>(LatencyStats::now() - queueStarted) / std::max<std::size_t>(keyEvents.size(), 1);
+        const bool queueIntact = received == static_cast<std::uint64_t>(keyEvents.size()) * (keyEvents.size() + 1) / 2;
+
+        // What CidaNameSource does before resolving names: splitting the selection's ID list block.
+        const auto cidaBlock = simulatedCida(options);
+        Cida cida;
+        const auto cidaStarted = LatencyStats::now();
+        const bool cidaParsed = parseCida(cidaBlock.data(), cidaBlock.size(), cida);
+        const auto cidaNs = static_cast<double>(LatencyStats::now() - cidaStarted) / std::max<std::size_t>(cida.children.size(), 1);
+
+        auto report = std::format(
+            L"windows={} items={} iterations={} nameLength={}-{} chunkLatencyUs={} lookupLatencyUs={} folders={} depth={} clipboard={}\r\n"
+            L"itemChunkSize={} formatChunkSize={}\r\n"
+            L"elapsed {:.3f} s, {:.0f} items/s, {:.1f} MB/s, selection snapshot {} bytes in {} folders\r\n"
+            L"snapshot read in {:.2f} ns per item; as std::vector<std::wstring> {} bytes, read in {:.2f} ns per item\r\n"
+            L"chord engine {:.2f} ns per key event over {} events, {} chords, {} resyncs\r\n"
+            L"request queue {:.2f} ns per request over {} requests{}\r\n"
+            L"CIDA parse {:.2f} ns per item over {} items in {} bytes{}\r\n\r\n"sv,
+            options.windows, options.items, options.iterations, options.minNameLength, options.maxNameLength,
+            options.chunkLatencyUs, options.lookupLatencyUs, options.folders, options.depth, options.clipboard,
+            config.itemChunkSize, config.formatChunkSize,
+            seconds, static_cast<double>(options.items) * options.iterations / seconds,
+            static_cast<double>(chars * sizeof(char16_t)) / seconds / (1024 * 1024), lastItems.bytes(), lastItems.folderCount(),
+            strings.snapshotNs, strings.bytes, strings.vectorNs,
+            keyNs, keyEvents.size(), chords, resyncs,
+            queueNs, keyEvents.size(), queueIntact ? L""sv : L" (lost requests)"sv,
+            cidaNs, cida.children.size(), cidaBlock.size(), cidaParsed ? L""sv : L" (rejected)"sv);
+        report += stats->report();
+        if (options.components)
+        {
+            report += L"\r\n"sv;
+            report += renderBenchmarkReport(options);
+            report += L"\r\n"sv;
+            report += scalingBenchmarkReport(options);
+            report += L"\r\n"sv;
+            report += traceBenchmarkReport();
+            report += L"\r\n"sv;
+            report += selectionDiffBenchmarkReport(options);
+        }
+        return report;
+    }
+}
@@ -1,15 +1,25 @@
 ﻿#include "framework.h"
 #include "resource.h"
 
+#include <functional>
+#include <memory>
+#include <optional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+#include <exdispid.h>
 #include <wil/com.h>
 #include <wil/resource.h>
 #include <wil/result.h>
 
 #pragma comment(lib, "Version.lib")
 #pragma comment(lib, "Shlwapi.lib")
+#pragma comment(lib, "Comdlg32.lib")
+#pragma comment(lib, "Dwmapi.lib")
 
 #include "DebugPrintWndProc.hpp"
+#include "Trace.hpp"
+#include "LatencyHistogram.hpp"
 
 #pragma comment(linker, "/manifestdependency:\"type='win32' \
     name='Microsoft.Windows.Common-Controls' \
@@ -19,6 +29,7 @@
     language='*'\"")
 
 #define WM_NOTIFYICON (WM_USER + 100)
+#define WM_COPIED (WM_USER + 101)
 constexpr int TIMER_ID_ADDTRAYICON = 100;
 
 #define CATCH_SHOW_MSGBOX(hWnd)                                                     \
@@ -29,10 +40,6 @@ constexpr int TIMER_ID_ADDTRAYICON = 100;
         ::MessageBox(hWnd, message, g_szTitle.c_str(), MB_ICONERROR);                         \
     }
 
-#define TRACE() my::DbgPrint("{}", __FUNCTION__ "\n")
-//#define TRACE() 
-#define DBGPRINTLN(fmt, ...) my::DbgPrint(__FILE__ "(" _STRINGIZE(__LINE__) "): " fmt "\n", __VA_ARGS__)
-
 #if __cpp_designated_initializers
 #define DESIGNATED_INIT(designator) designator
 #else
@@ -47,13 +54,13 @@ namespace my
     template <class... T>
     inline auto DbgPrint(const std::wstring_view fmt, const T&... args)
     {
-        OutputDebugStringW(std::format(fmt, args...).c_str());
+        OutputDebugStringW(std::vformat(fmt, std::make_wformat_args(args...)).c_str());
     }
 
     template <class... T>
     inline auto DbgPrint(const std::string_view fmt, const T&... args)
     {
-        OutputDebugStringA(std::format(fmt, args...).c_str());
+        OutputDebugStringA(std::vformat(fmt, std::make_format_args(args...)).c_str());
     }
 
     inline auto GetWindowThreadProcessId(HWND hwnd)
@@ -102,14 +109,150 @@ static HINSTANCE getHinstance() noexcept
 }
 
 #include "SplashWiindow.hpp"
+#include "Settings.hpp"
+#include "DispatchEventSink.hpp"
+#include "ShellWindowIndex.hpp"
+#include "ShellNameSources.hpp"
+#include "IncrementalSelection.hpp"
+#include "RenderPlan.hpp"
+#include "CopyWorker.hpp"
+#include "ForegroundTracker.hpp"
+#include "ClipboardEncoders.hpp"
+#include "DeferredRender.hpp"
+#include "PipelineBenchmark.hpp"
+
+// IShellWindows behind ShellWindowIndex. Its events arrive and the rebuilds it is posted run in the MTA,
+// so the one IShellWindows serves the event threads and the thread pool alike.
+class Win32ShellWindows
+{
+    wil::com_ptr_t<IShellWindows> m_pSHWinds;
+    TP_CALLBACK_ENVIRON m_environment{};
+    PTP_CLEANUP_GROUP m_cleanupGroup{};
+
+public:
+    using Window = HWND;
+    using Entry = wil::com_ptr_t<IShellBrowser>;
+
+private:
+    // Querying information from an Explorer window | The Old New Thing
+    // https://devblogs.microsoft.com/oldnewthing/20040720-00/?p=38393
+    std::optional<std::pair<Window, Entry>> itemAt(long i) const
+    {
+        VARIANT v{};
+        V_VT(&v) = VT_I4; V_I4(&v) = i;
+        wil::com_ptr_t<IDispatch> pDisp;
+        if (FAILED(m_pSHWinds->Item(v, pDisp.put())) || !pDisp)
+            return std::nullopt; // the window was closed while we were enumerating
+
+        auto pWBA = pDisp.try_query<IWebBrowserApp>();
+        if (!pWBA)
+            return std::nullopt;
+
+        SHANDLE_PTR hWndShell{};
+        if (FAILED(pWBA->get_HWND(&hWndShell)))
+            return std::nullopt;
+
+        auto psp = pWBA.try_query<IServiceProvider>();
+        Entry psb;
+        if (!psp || FAILED(psp->QueryService(SID_STopLevelBrowser, IID_PPV_ARGS(&psb))))
+            return std::nullopt;
+        return std::make_pair(reinterpret_cast<HWND>(hWndShell), std::move(psb));
+    }
+
+public:
+    Win32ShellWindows() noexcept
+    {
+        InitializeThreadpoolEnvironment(&m_environment);
+    }
+    Win32ShellWindows(const Win32ShellWindows&) = delete;
+    Win32ShellWindows& operator=(const Win32ShellWindows&) = delete;
+    ~Win32ShellWindows() noexcept
+    {
+        close();
+        DestroyThreadpoolEnvironment(&m_environment);
+    }
+
+    void open(wil::com_ptr_t<IShellWindows> pSHWinds)
+    {
+        m_cleanupGroup = CreateThreadpoolCleanupGroup();
+        THROW_LAST_ERROR_IF_NULL(m_cleanupGroup);
+        SetThreadpoolCallbackCleanupGroup(&m_environment, m_cleanupGroup, nullptr);
+        m_pSHWinds = std::move(pSHWinds);
+    }
+
+    // Waits for the work posted so far and releases IShellWindows.
+    void close() noexcept
+    {
+        if (m_cleanupGroup != nullptr)
+        {
+            CloseThreadpoolCleanupGroupMembers(m_cleanupGroup, FALSE, nullptr);
+            CloseThreadpoolCleanupGroup(m_cleanupGroup);
+            m_cleanupGroup = nullptr;
+        }
+        m_pSHWinds = nullptr;
+    }
+
+    [[nodiscard]] IShellWindows* get() const noexcept { return m_pSHWinds.get(); }
+
+    std::vector<std::pair<Window, Entry>> enumerate() const
+    {
+        std::vector<std::pair<Window, Entry>> windows;
+        if (!m_pSHWinds)
+            return windows;
+
+        long count{};
+        THROW_IF_FAILED(m_pSHWinds->get_Count(&count));
+        windows.reserve(count);
+        for (long i = 0; i < count; i++)
+        {
+            if (auto window = itemAt(i))
+                windows.push_back(std::move(*window));
+        }
+        return windows;
+    }
+
+    bool isWindow(HWND hWnd) const noexcept
+    {
+        return IsWindow(hWnd) != FALSE;
+    }
+
+    void post(std::function<void()> work)
+    {
+        if (m_cleanupGroup == nullptr)
+            return;
+
+        auto context = std::make_unique<std::function<void()>>(std::move(work));
+        THROW_IF_WIN32_BOOL_FALSE(TrySubmitThreadpoolCallback([](PTP_CALLBACK_INSTANCE, PVOID p) noexcept {
+            std::unique_ptr<std::function<void()>> work{ static_cast<std::function<void()>*>(p) };
+            try
+            {
+                (*work)();
+            }
+            CATCH_LOG();
+        }, context.get(), &m_environment));
+        context.release();
+    }
+};
 
 HHOOK g_hook;
 std::wstring g_szTitle;
 HWND g_hwnd;
-wil::com_ptr_t<IShellWindows> g_pSHWinds;
+Settings g_settings;
+ShellWindowIndex<Win32ShellWindows> g_shellWindowIndex;
+unique_connection g_shellWindowEvents;
+CopyWorker g_copyWorker;
+ChordEngine g_chordEngine; // only touched by the keyboard hook and the WinEvent hooks on its thread, after startup
+ForegroundTracker<HWND> g_foreground;
+std::unique_ptr<ActivationBackend> g_activation;
+wil::unique_hwineventhook g_foregroundEvents;
+wil::unique_hwineventhook g_desktopSwitchEvents;
+SelectionTracker g_selectionTracker;
+DeferredRender<std::function<wil::unique_hglobal()>> g_deferredText;
 
 LRESULT CALLBACK wndProc(HWND, UINT, WPARAM, LPARAM) noexcept;
 INT_PTR CALLBACK about(HWND, UINT, WPARAM, LPARAM) noexcept;
+void startHookActivation(const std::vector<Chord>& chords);
+void benchmark(HINSTANCE, const BenchmarkOptions&);
 
 constexpr auto NOTIFY_UID = 1;
 constexpr auto szWindowClass = L"{1D93FDAB-20F9-427D-9650-8B9C861C8137}";
@@ -144,170 +287,618 @@ service_provider_t< err_policy> to_service_provider(wil::com_ptr_t<T> from)
     return service_provider_t{ from.query<IServiceProvider>() };
 }
 
-void setClipboardText(std::wstring_view ss)
+// Allocates a clipboard block of cb bytes and lets write fill it in place.
+template <class Writer>
+wil::unique_hglobal allocGlobal(size_t cb, Writer&& write)
 {
-    if (ss.empty()) {
-        return;
-    }
-
-    size_t cchNeeded = ss.size() + 1;
-    wil::unique_hglobal hGlobal{ GlobalAlloc(GMEM_MOVEABLE | GMEM_DDESHARE, cchNeeded * sizeof(WCHAR)) };
+    wil::unique_hglobal hGlobal{ GlobalAlloc(GMEM_MOVEABLE | GMEM_DDESHARE, cb) };
     THROW_LAST_ERROR_IF_NULL(hGlobal);
     {
-        WCHAR* lock = (reinterpret_cast<WCHAR*>(GlobalLock(hGlobal.get())));
+        void* lock = GlobalLock(hGlobal.get());
         THROW_LAST_ERROR_IF_NULL(lock);
-        THROW_IF_FAILED(StringCbCopyW(lock, GlobalSize(hGlobal.get()), ss.data()));
-        GlobalUnlock(hGlobal.get());
+        auto unlock = wil::scope_exit([&] {
+            GlobalUnlock(hGlobal.get());
+        });
+        write(lock);
+    }
+    return hGlobal;
+}
+
+// Allocates a clipboard block for cch characters plus the terminator and lets write fill it in place.
+template <class Writer>
+wil::unique_hglobal allocGlobalText(size_t cch, Writer&& write)
+{
+    return allocGlobal((cch + 1) * sizeof(WCHAR), [&](void* lock) {
+        WCHAR* end = write(static_cast<WCHAR*>(lock));
+        *end = L'\0';
+    });
+}
+
+void writeUtf8File(LPCWSTR fileName, std::wstring_view text)
+{
+    std::string utf8(utf8Length(text), '\0');
+    writeUtf8(text, utf8.data());
+
+    wil::unique_hfile file{ CreateFileW(fileName, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+    THROW_LAST_ERROR_IF(!file);
+    DWORD written{};
+    THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), utf8.data(), static_cast<DWORD>(utf8.size()), &written, nullptr));
+}
+
+struct ClipboardBlock
+{
+    UINT format;
+    wil::unique_hglobal data;
+};
+
+void setClipboardBlocks(std::vector<ClipboardBlock>& blocks)
+{
+    for (auto& block : blocks)
+    {
+        THROW_LAST_ERROR_IF_NULL(SetClipboardData(block.format, block.data.get()));
+        block.data.release();
     }
+}
 
+// Publishes all blocks in one Open/Empty/Close transaction.
+void setClipboardData(std::vector<ClipboardBlock> blocks)
+{
     THROW_IF_WIN32_BOOL_FALSE(OpenClipboard(g_hwnd));
     {
         auto defer = wil::scope_exit([&] {
             CloseClipboard();
         });
         THROW_IF_WIN32_BOOL_FALSE(EmptyClipboard());
-        THROW_LAST_ERROR_IF_NULL(SetClipboardData(CF_UNICODETEXT, hGlobal.get()));
-        hGlobal.release();
+        setClipboardBlocks(blocks);
     }
 }
 
-SplashWiindow g_splashWindow;
+// Publishes formats with delayed rendering: render runs on the window thread when an application pastes.
+// The other blocks are published as they are, in the same transaction.
+void offerClipboardData(const std::vector<UINT>& formats, std::function<wil::unique_hglobal()> render, std::vector<ClipboardBlock> blocks)
+{
+    THROW_IF_WIN32_BOOL_FALSE(OpenClipboard(g_hwnd));
+    {
+        auto defer = wil::scope_exit([&] {
+            CloseClipboard();
+        });
+        THROW_IF_WIN32_BOOL_FALSE(EmptyClipboard());
+        g_deferredText.offer(std::move(render));
+        for (auto format : formats)
+        {
+            // Without data SetClipboardData returns NULL on success as well; only the last error tells them apart.
+            SetLastError(ERROR_SUCCESS);
+            if (SetClipboardData(format, nullptr) == nullptr)
+            {
+                if (const auto error = GetLastError(); error != ERROR_SUCCESS)
+                {
+                    // The copy fails as the immediate path does; drop the items instead of holding them until
+                    // the clipboard changes hands, for formats that may not have been offered.
+                    g_deferredText.discard();
+                    THROW_WIN32(error);
+                }
+            }
+        }
+        setClipboardBlocks(blocks);
+    }
+}
+
+// Item fields needed by the text format and the extra clipboard formats together.
+unsigned itemFields(const OutputFormat& format) noexcept
+{
+    return format.requiredFields() | requiredFieldsOf(g_settings.clipboardFormats);
+}
 
-void copySelectedItems(wil::com_ptr_t<IFolderView2> pfv2)
+// Encodes the extra clipboard formats that are built from the items (CF_HDROP, HTML Format, text/markdown).
+template <class Items>
+void encodeClipboardFormats(const Items& items, std::vector<ClipboardBlock>& blocks)
 {
-    std::wstring ss;
+    static const UINT cfHtml = RegisterClipboardFormatW(L"HTML Format");
+    static const UINT cfMarkdown = RegisterClipboardFormatW(L"text/markdown");
 
-    wil::com_ptr_t<IShellItemArray> pSIA;
-    THROW_IF_FAILED(pfv2->GetSelection(TRUE, &pSIA));
+    auto plan = ClipboardEncodingPlan::measure(items, g_settings.clipboardFormats & (CBF_HDROP | CBF_HTML | CBF_MARKDOWN));
+    if (plan.formats == 0)
+        return;
 
-    DWORD dwCount{};
-    THROW_IF_FAILED(pSIA->GetCount(&dwCount));
-    for (DWORD i = 0; i < dwCount; i++)
-    {
-        wil::com_ptr_t<IShellItem> pSI;
-        THROW_IF_FAILED(pSIA->GetItemAt(i, &pSI));
+    wil::unique_hglobal hdrop;
+    wil::unique_hglobal html;
+    wil::unique_hglobal markdown;
+    void* hdropData{};
+    void* htmlData{};
+    void* markdownData{};
+    auto allocate = [](wil::unique_hglobal& block, void*& data, size_t bytes) {
+        block.reset(GlobalAlloc(GMEM_MOVEABLE | GMEM_DDESHARE, bytes));
+        THROW_LAST_ERROR_IF_NULL(block);
+        data = GlobalLock(block.get());
+        THROW_LAST_ERROR_IF_NULL(data);
+    };
+    auto unlock = wil::scope_exit([&] {
+        if (hdropData)
+            GlobalUnlock(hdrop.get());
+        if (htmlData)
+            GlobalUnlock(html.get());
+        if (markdownData)
+            GlobalUnlock(markdown.get());
+    });
+    if (plan.formats & CBF_HDROP)
+        allocate(hdrop, hdropData, plan.hdropBytes);
+    if (plan.formats & CBF_HTML)
+        allocate(html, htmlData, plan.htmlBytes);
+    if (plan.formats & CBF_MARKDOWN)
+        allocate(markdown, markdownData, plan.markdownBytes);
+    plan.write(items, static_cast<std::byte*>(hdropData), static_cast<char*>(htmlData), static_cast<char*>(markdownData));
+    unlock.reset();
+
+    if (hdrop)
+        blocks.push_back({ CF_HDROP, std::move(hdrop) });
+    if (html)
+        blocks.push_back({ cfHtml, std::move(html) });
+    if (markdown)
+        blocks.push_back({ cfMarkdown, std::move(markdown) });
+}
+
+UINT utf8ClipboardFormat()
+{
+    static const UINT cfUtf8 = RegisterClipboardFormatW(L"UTF8_STRING");
+    return cfUtf8;
+}
 
-        wil::unique_cotaskmem_string displayName;
-        THROW_IF_FAILED(pSI->GetDisplayName(SIGDN_NORMALDISPLAY, &displayName));
+// Encodes the rendered text once more as UTF-8 (CBF_UTF8), transcoded straight into the clipboard block.
+void encodeUtf8Text(std::wstring_view text, std::vector<ClipboardBlock>& blocks)
+{
+    const auto cb = utf8Length(text);
+    blocks.push_back({ utf8ClipboardFormat(), allocGlobal(cb + 1, [&](void* dest) {
+        *writeUtf8(text, static_cast<char*>(dest)) = '\0';
+    }) });
+}
+
+// Copies a CFSTR_SHELLIDLIST block as Explorer provided it.
+void encodeShellIdList(const void* source, SIZE_T cb, std::vector<ClipboardBlock>& blocks)
+{
+    static const UINT cfShellIdList = RegisterClipboardFormatW(CFSTR_SHELLIDLIST);
+
+    blocks.push_back({ cfShellIdList, allocGlobal(cb, [&](void* dest) {
+        memcpy(dest, source, cb);
+    }) });
+}
 
-        if (i > 0) {
-            ss.append(L"\n");
+// Copies the selection's CFSTR_SHELLIDLIST as Explorer provides it.
+void encodeShellIdList(IFolderView2* pfv2, std::vector<ClipboardBlock>& blocks)
+{
+    wil::unique_stg_medium medium;
+    if (!fetchSelectionIdList(pfv2, medium))
+        return;
+
+    wil::unique_hglobal_locked source{ medium.hGlobal };
+    THROW_LAST_ERROR_IF_NULL(source.get());
+    encodeShellIdList(source.get(), GlobalSize(medium.hGlobal), blocks);
+}
+
+// WM_RENDERFORMAT and WM_RENDERALLFORMATS. The clipboard is already open for WM_RENDERFORMAT;
+// for WM_RENDERALLFORMATS it has to be opened, and only filled if we still own it.
+void renderDeferredText(HWND hWnd, bool all)
+try
+{
+    auto render = g_deferredText.take();
+    if (!render)
+        return;
+
+    // Both text formats come from one render, so whichever is asked for first sets the other as well.
+    auto setText = [&] {
+        auto text = (*render)();
+        std::vector<ClipboardBlock> blocks;
+        if (g_settings.clipboardFormats & CBF_UTF8)
+        {
+            wil::unique_hglobal_locked lock{ text.get() };
+            THROW_LAST_ERROR_IF_NULL(lock.get());
+            encodeUtf8Text(static_cast<const WCHAR*>(lock.get()), blocks);
         }
+        blocks.insert(blocks.begin(), ClipboardBlock{ CF_UNICODETEXT, std::move(text) });
+        setClipboardBlocks(blocks);
+    };
+    if (!all)
+    {
+        setText();
+        return;
+    }
 
-        ss.append(displayName.get());
+    THROW_IF_WIN32_BOOL_FALSE(OpenClipboard(hWnd));
+    auto defer = wil::scope_exit([&] {
+        CloseClipboard();
+    });
+    if (GetClipboardOwner() == hWnd)
+    {
+        setText();
     }
-    setClipboardText(ss);
-    g_splashWindow.show(getHinstance(), (g_szTitle + L" Splash"s).c_str());
 }
+CATCH_LOG()
 
+SplashWiindow g_splashWindow;
 
-// Querying information from an Explorer window | The Old New Thing
-// https://devblogs.microsoft.com/oldnewthing/20040720-00/?p=38393
-void traverseShellWindows(wil::com_ptr_t<IShellWindows> pSHWinds, HWND hWndTarget)
+// SortMode::Locale: the user's locale with digits compared as numbers, as Explorer sorts.
+// The byte sort key is packed two bytes per character, so it compares like the portable keys.
+void appendLocaleSortKey(std::wstring_view text, std::vector<wchar_t>& key)
 {
-    TRACE();
+    if (text.empty())
+        return;
 
-    if (hWndTarget == nullptr) {
+    constexpr DWORD flags = LCMAP_SORTKEY | NORM_IGNORECASE | SORT_DIGITSASNUMBERS;
+    thread_local std::vector<BYTE> bytes;
+    const int cb = LCMapStringEx(LOCALE_NAME_USER_DEFAULT, flags, text.data(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr, 0);
+    if (cb <= 0)
         return;
+    bytes.resize(cb);
+    LCMapStringEx(LOCALE_NAME_USER_DEFAULT, flags, text.data(), static_cast<int>(text.size()), reinterpret_cast<LPWSTR>(bytes.data()), cb, nullptr, nullptr, 0);
+    for (int i = 0; i < cb; i += 2)
+    {
+        key.push_back(static_cast<wchar_t>((bytes[i] << 8) | (i + 1 < cb ? bytes[i + 1] : 0)));
     }
+}
 
-    long count;
-    THROW_IF_FAILED(pSHWinds->get_Count(&count));
-    for (long i = 0; i < count; i++)
+// Calls f with the items in the configured sort order, or as they are if they are not sorted.
+template <class Items, class F>
+auto withSortOrder(const Items& items, LatencyStats& stats, F&& f)
+{
+    if (g_settings.sortMode == SortMode::None || items.size() < 2)
+        return f(items);
+
+    std::vector<std::uint32_t> order;
     {
-        VARIANT v{};
-        V_VT(&v) = VT_I4; V_I4(&v) = i;
-        wil::com_ptr_t< IDispatch> pDisp;
-        THROW_IF_FAILED(pSHWinds->Item(v, pDisp.put()));
-        auto pWBA = pDisp.query<IWebBrowserApp>();
+        ScopedLatency latency{ stats, LatencyStage::Sort };
+        order = sortedOrder(items.size(), g_settings.formatChunkSize, [&](size_t i, std::vector<wchar_t>& key) {
+            if (g_settings.sortMode == SortMode::Locale)
+                appendLocaleSortKey(sortTextOf(items, i), key);
+            else
+                appendSortKey(g_settings.sortMode, sortTextOf(items, i), key);
+        });
+    }
+    return f(SortedItems<Items>{ items, std::move(order) });
+}
 
-        SHANDLE_PTR hWndShell{};
-        THROW_IF_FAILED(pWBA->get_HWND(&hWndShell));
+// Renders items in the configured order and the given format and the extra clipboard formats and, if publish
+// is set, puts them on the clipboard together with blocks. Returns the number of characters of text rendered.
+template <class Items>
+size_t publishItems(const Items& items, const OutputFormat& format, LatencyStats& stats, std::vector<ClipboardBlock> blocks = {}, bool publish = true)
+{
+    const size_t cch = withSortOrder(items, stats, [&](const auto& ordered) {
+        ScopedLatency latency{ stats, LatencyStage::Format };
+
+        RenderPlan plan{ format, ordered, g_settings.formatChunkSize };
+        const auto cch = plan.size();
+        auto text = allocGlobalText(cch, [&](WCHAR* dest) {
+            auto end = plan.write(dest);
+            if (g_settings.clipboardFormats & CBF_UTF8)
+                encodeUtf8Text({ dest, cch }, blocks);
+            return end;
+        });
+        blocks.insert(blocks.begin(), ClipboardBlock{ CF_UNICODETEXT, std::move(text) });
+        encodeClipboardFormats(ordered, blocks);
+        return cch;
+    });
+    if (publish)
+    {
+        ScopedLatency latency{ stats, LatencyStage::Clipboard };
+        setClipboardData(std::move(blocks));
+    }
+    return cch;
+}
 
-        { // debug
-            wil::unique_bstr name;
-            pWBA->get_Name(wil::out_param(name));
+bool deferRendering(size_t count) noexcept
+{
+    return g_settings.delayedRenderThreshold != 0 && count >= g_settings.delayedRenderThreshold;
+}
+
+// Publishes items with delayed rendering. Only the item list is kept;
+// the text is rendered if and when an application pastes. format must outlive the clipboard ownership.
+template <class Items>
+void offerItems(std::shared_ptr<const Items> items, const OutputFormat& format, std::vector<ClipboardBlock> blocks)
+{
+    // Sorted up front so that the formats encoded now and the text rendered later agree on the order.
+    withSortOrder(*items, LatencyStats::instance(), [&](auto&& ordered) {
+        using Ordered = std::decay_t<decltype(ordered)>;
+        encodeClipboardFormats(ordered, blocks);
+
+        // A sorted view refers to the items, so the render keeps both alive.
+        std::shared_ptr<const Ordered> view;
+        if constexpr (std::is_same_v<Ordered, Items>)
+            view = items;
+        else
+            view = std::make_shared<const Ordered>(std::move(ordered));
+
+        ScopedLatency latency{ LatencyStage::Clipboard };
+        std::vector<UINT> formats{ CF_UNICODETEXT };
+        if (g_settings.clipboardFormats & CBF_UTF8)
+            formats.push_back(utf8ClipboardFormat());
+        offerClipboardData(formats, [items, view = std::move(view), format = &format] {
+            ScopedLatency latency{ LatencyStage::Format };
+            RenderPlan plan{ *format, *view, g_settings.formatChunkSize };
+            return allocGlobalText(plan.size(), [&](WCHAR* dest) {
+                return plan.write(dest);
+            });
+        }, std::move(blocks));
+    });
+}
 
-            wil::unique_bstr fullname;
-            pWBA->get_FullName(wil::out_param(fullname));
+// Runs on the copy worker. A newer request stops the copy between item chunks, before anything is published.
+void copySelectedItems(HWND hWnd, wil::com_ptr_t<IFolderView2> pfv2, const OutputFormat& format)
+{
+    g_copyWorker.readingSelection();
+
+    // Formats taken from the view as they are rather than built from the item names.
+    auto viewBlocks = [&] {
+        std::vector<ClipboardBlock> blocks;
+        if (g_settings.clipboardFormats & CBF_SHELLIDLIST)
+            encodeShellIdList(pfv2.get(), blocks);
+        return blocks;
+    };
 
-            my::DbgPrint(L"[{}] name={}, fullname={}, hwnd={}\n"sv, i, name.get(), fullname.get(), hWndShell);
+    if (g_settings.incrementalSelection)
+    {
+        const SelectionDiffCache<CachedItem>* cached{};
+        std::vector<ClipboardBlock> blocks;
+        {
+            ScopedLatency latency{ LatencyStage::Selection };
+            cached = g_selectionTracker.selection(hWnd, pfv2.get(), itemFields(format), [] { return g_copyWorker.superseded(); });
+            if (cached != nullptr)
+                blocks = viewBlocks();
         }
-
-        if (reinterpret_cast<HWND>(hWndShell) == hWndTarget)
+        if (g_copyWorker.superseded())
+        {
+            DBGPRINTLN("copy superseded while resolving the selection");
+            return;
+        }
+        if (cached != nullptr)
         {
-            auto psp = pWBA.query<IServiceProvider>();
+            if (deferRendering(cached->size()))
+                offerItems(std::make_shared<const SelectionSnapshot>(snapshotOf(*cached)), format, std::move(blocks));
+            else
+                publishItems(CachedSelectionItems{ *cached }, format, LatencyStats::instance(), std::move(blocks));
+            PostMessage(g_hwnd, WM_COPIED, 0, 0);
+            return;
+        }
+    }
 
-            wil::com_ptr_t<IShellBrowser> psb;
-            THROW_IF_FAILED(psp->QueryService(SID_STopLevelBrowser, IID_PPV_ARGS(&psb)));
+    SelectionSnapshot items;
+    std::vector<ClipboardBlock> blocks;
+    {
+        ScopedLatency latency{ LatencyStage::Selection };
 
-            wil::com_ptr_t<IShellView> psv;
-            THROW_IF_FAILED(psb->QueryActiveShellView(&psv));
+        // The selection's ID lists in one transfer, resolved here; one call into Explorer per chunk of items
+        // otherwise, for example when nothing is selected and the folder itself is copied.
+        std::unique_ptr<ItemNameSource> source;
+        auto cida = CidaNameSource::create(pfv2.get(), itemFields(format));
+        if (cida)
+        {
+            if (g_settings.clipboardFormats & CBF_SHELLIDLIST)
+                encodeShellIdList(cida->block(), cida->blockSize(), blocks);
+            source = std::move(cida);
+        }
+        else
+        {
+            wil::com_ptr_t<IShellItemArray> pSIA;
+            THROW_IF_FAILED(pfv2->GetSelection(TRUE, &pSIA));
+            source = std::make_unique<ShellItemArrayNameSource>(pSIA.get(), itemFields(format), g_settings.itemChunkSize);
+            blocks = viewBlocks();
+        }
 
-            auto pfv2 = psv.query<IFolderView2>();
+        items = readAllItems(*source, g_settings.itemChunkSize, [] { return g_copyWorker.superseded(); });
+        if (g_copyWorker.superseded())
+        {
+            DBGPRINTLN("copy superseded after {} items", items.size());
+            return;
+        }
+    }
+    if (items.empty()) {
+        return;
+    }
 
-            { // debug
+    if (deferRendering(items.size()))
+        offerItems(std::make_shared<const SelectionSnapshot>(std::move(items)), format, std::move(blocks));
+    else
+        publishItems(items, format, LatencyStats::instance(), std::move(blocks));
+    PostMessage(g_hwnd, WM_COPIED, 0, 0);
+}
 
-                UINT viewMode{};
-                THROW_IF_FAILED(pfv2->GetCurrentViewMode(&viewMode));
 
-                int itemCount{};
-                THROW_IF_FAILED(pfv2->ItemCount(SVGIO_BACKGROUND, &itemCount));
+// Fills the shell window index and keeps it current from DShellWindowsEvents.
+void attachShellWindowIndex()
+{
+    auto& shellWindows = g_shellWindowIndex.backend();
+    shellWindows.open(wil::CoCreateInstance<ShellWindows, IShellWindows>(CLSCTX_ALL));
 
-                my::DbgPrint(L"[{}] viewMode={}, itemCount={}\n"sv, i, viewMode, itemCount);
-            }
+    // Both events pass the cookie of the window as their only argument.
+    auto sink = DispatchEventSink::create(DIID_DShellWindowsEvents, [](DISPID dispId, const DISPPARAMS& params) {
+        VARIANT cookie{};
+        if (params.cArgs < 1 || FAILED(VariantChangeType(&cookie, &params.rgvarg[0], 0, VT_I4)))
+            return;
 
-            copySelectedItems(pfv2);
-            my::DbgPrint(L"[{}] Copied!\n"sv, i);
+        switch (dispId)
+        {
+        case DISPID_WINDOWREGISTERED:
+            g_shellWindowIndex.onRegistered(V_I4(&cookie));
+            break;
+        case DISPID_WINDOWREVOKED:
+            g_shellWindowIndex.onRevoked(V_I4(&cookie));
+            break;
+        default:
             break;
         }
+    });
+    g_shellWindowEvents.advise(shellWindows.get(), DIID_DShellWindowsEvents, sink.get());
+
+    g_shellWindowIndex.rebuild();
+}
+
+void detachShellWindowIndex() noexcept
+{
+    g_shellWindowEvents.reset();
+    g_shellWindowIndex.backend().close();
+    g_shellWindowIndex.clear();
+}
+
+// Returns the folder view shown by the shell window, or nullptr if hWnd is not one.
+wil::com_ptr_t<IFolderView2> folderViewOf(HWND hWnd)
+{
+    auto psb = g_shellWindowIndex.find(hWnd);
+    if (!psb || !*psb)
+        return nullptr;
+
+    wil::com_ptr_t<IShellView> psv;
+    THROW_IF_FAILED((*psb)->QueryActiveShellView(&psv));
+
+    return psv.query<IFolderView2>();
+}
+
+void copyFromShellWindow(HWND hWndTarget, const OutputFormat& format)
+{
+    TRACE();
+
+    if (hWndTarget == nullptr) {
+        return;
     }
+
+    wil::com_ptr_t<IFolderView2> pfv2;
+    {
+        ScopedLatency latency{ LatencyStage::Lookup };
+        pfv2 = folderViewOf(hWndTarget);
+    }
+    if (!pfv2) {
+        return;
+    }
+
+    copySelectedItems(hWndTarget, pfv2, format);
+    DBGPRINTLN("hwnd={:x} copied", hWndTarget);
+}
+
+// Replays the copy pipeline against SimulatedShell with the current settings and returns the report.
+std::wstring runBenchmark(const BenchmarkOptions& options)
+{
+    PipelineBenchmarkConfig config{ g_settings.itemChunkSize, g_settings.formatChunkSize, itemFields(g_settings.format), g_settings.hotkeyChords() };
+    return runPipelineBenchmark(options, config, [&](const SelectionSnapshot& items, LatencyStats& stats) {
+        return publishItems(items, g_settings.format, stats, {}, options.clipboard);
+    });
+}
+
+// "/benchmark key=value ...": the options of a benchmark run; nullopt for any other command line.
+std::optional<BenchmarkOptions> parseBenchmarkCommandLine(LPCWSTR commandLine)
+{
+    int argc{};
+    wil::unique_hlocal_ptr<LPWSTR> argv{ CommandLineToArgvW(commandLine, &argc) };
+    if (!argv || argc < 1 || lstrcmpiW(argv.get()[0], L"/benchmark") != 0)
+        return std::nullopt;
+
+    std::vector<std::wstring_view> args{ argv.get() + 1, argv.get() + argc };
+    return BenchmarkOptions::parse(args);
+}
+
+// A chord of any activation backend was pressed: hands the foreground target to the copy worker.
+// Returns whether the press was used, that is whether a target is in the foreground.
+bool activate(int binding, bool repeat) noexcept
+{
+    if (binding < 0)
+        return false;
+
+    auto hWnd = g_foreground.target();
+    DBGPRINTLN("binding:{} target:{:x}", binding, reinterpret_cast<ULONG_PTR>(hWnd));
+    // The target may have been closed without another window coming to the foreground.
+    if (hWnd == nullptr || !IsWindow(hWnd))
+        return false;
+
+    if (!g_copyWorker.post({ hWnd, LatencyStats::now(), static_cast<std::uint8_t>(binding), repeat }))
+    {
+        DBGPRINTLN("copy request dropped");
+    }
+    return true;
 }
 
 LRESULT CALLBACK lowLevelKeyboardProc(int code, WPARAM wParam, LPARAM lParam) noexcept
 {
     TRACE();
+    ScopedLatency latency{ LatencyStage::Hook };
 
     if (code < HC_ACTION)
         return CallNextHookEx(nullptr, code, wParam, lParam);
 
     auto pKbdll = reinterpret_cast<const KBDLLHOOKSTRUCT*>(lParam);
 
-    DBGPRINTLN("flags:{:x}, vkCode:{:x}"sv, pKbdll->flags, pKbdll->vkCode);
+    DBGPRINTLN("flags:{:x}, vkCode:{:x}", pKbdll->flags, pKbdll->vkCode);
 
-    if ((pKbdll->flags & (LLKHF_LOWER_IL_INJECTED | LLKHF_UP)) == 0 && pKbdll->vkCode == 'C')
+    const auto vk = static_cast<std::uint8_t>(pKbdll->vkCode);
+    const bool down = (pKbdll->flags & LLKHF_UP) == 0;
+    auto binding = g_chordEngine.onKey(vk, down, pKbdll->time);
+    if (binding == ChordEngine::needsResync)
     {
-        auto ctrlKey = GetAsyncKeyState(VK_CONTROL) & 0x8000;
-        auto shiftKey = GetAsyncKeyState(VK_SHIFT) & 0x8000;
-        DBGPRINTLN("ctrlKey:{}, shiftKey:{}"sv, ctrlKey, shiftKey);
+        // Key events may have been lost; ask the system, which has not seen this event yet.
+        g_chordEngine.resync([](std::uint8_t key) { return (GetAsyncKeyState(key) & 0x8000) != 0; });
+        binding = g_chordEngine.onKey(vk, down, pKbdll->time);
+        DBGPRINTLN("modifiers:{:x}, binding:{}", g_chordEngine.modifiers(), binding);
+    }
 
-        if (ctrlKey != 0 && shiftKey != 0)
-        {
-            auto hWnd{ GetForegroundWindow() };
-            if (hWnd == nullptr) {
-                hWnd = GetForegroundWindow();
-            }
+    if ((pKbdll->flags & LLKHF_LOWER_IL_INJECTED) == 0 && activate(binding, g_chordEngine.repeated()))
+        return 1;
 
-            if (hWnd != nullptr)
-            {
-                WCHAR className[512]{};
-                RealGetWindowClass(hWnd, className, ARRAYSIZE(className));
-
-                DBGPRINTLN(L"className:{}", className);
-                if (lstrcmp(className, targetClassName) == 0)
-                    try {
-                    traverseShellWindows(g_pSHWinds, hWnd);
-                    return 1;
-                }
-                catch (...)
-                {
-                    DBGPRINTLN("catch");
-                }
-            }
-        }
+    return CallNextHookEx(nullptr, code, wParam, lParam);
+}
+
+bool isTargetWindow(HWND hWnd) noexcept
+{
+    WCHAR className[512]{};
+    RealGetWindowClass(hWnd, className, ARRAYSIZE(className));
+    return lstrcmp(className, targetClassName) == 0;
+}
+
+bool isLiveWindow(HWND hWnd) noexcept
+{
+    return IsWindow(hWnd) != FALSE;
+}
+
+// Foreground notifications, delivered on the thread that installed the hook: the same thread as the keyboard
+// hook, so a foreground change is seen before the keystrokes that follow it.
+void CALLBACK foregroundEventProc(HWINEVENTHOOK, DWORD, HWND hWnd, LONG idObject, LONG idChild, DWORD, DWORD) noexcept
+try
+{
+    if (idObject != OBJID_WINDOW || idChild != CHILDID_SELF)
+        return;
+
+    const bool hadTarget = g_foreground.target() != nullptr;
+    g_foreground.onForeground(hWnd, isTargetWindow, isLiveWindow);
+    DBGPRINTLN("foreground:{:x} target:{:x}", reinterpret_cast<ULONG_PTR>(hWnd), reinterpret_cast<ULONG_PTR>(g_foreground.target()));
+
+    const bool hasTarget = g_foreground.target() != nullptr;
+    if (g_activation && hasTarget != hadTarget && !g_activation->onTargetChanged(hasTarget))
+    {
+        DBGPRINTLN("hotkeys taken by another application, falling back to the keyboard hook");
+        startHookActivation(g_settings.hotkeyChords());
     }
+}
+CATCH_LOG()
 
-    return CallNextHookEx(nullptr, code, wParam, lParam);
+// The keyboard hook sees no events while another desktop (the secure desktop, a locked or switched session)
+// has the input, so the chord engine cannot trust the key state it tracked from before.
+void CALLBACK desktopSwitchEventProc(HWINEVENTHOOK, DWORD, HWND, LONG, LONG, DWORD, DWORD) noexcept
+{
+    DBGPRINTLN("desktop switch");
+    g_chordEngine.invalidate();
+}
+
+void uninstallForegroundTracking()
+{
+    g_foregroundEvents.reset();
+    g_desktopSwitchEvents.reset();
+}
+
+void installForegroundTracking()
+{
+    TRACE();
+
+    uninstallForegroundTracking();
+
+    g_foregroundEvents.reset(SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr, &foregroundEventProc, 0, 0, WINEVENT_OUTOFCONTEXT));
+    THROW_LAST_ERROR_IF_NULL(g_foregroundEvents);
+    g_desktopSwitchEvents.reset(SetWinEventHook(EVENT_SYSTEM_DESKTOPSWITCH, EVENT_SYSTEM_DESKTOPSWITCH, nullptr, &desktopSwitchEventProc, 0, 0, WINEVENT_OUTOFCONTEXT));
+    THROW_LAST_ERROR_IF_NULL(g_desktopSwitchEvents);
+
+    g_foreground.onForeground(GetForegroundWindow(), isTargetWindow, isLiveWindow);
 }
 
 void uninstallHook()
@@ -331,6 +922,87 @@ void installHook()
     THROW_LAST_ERROR_IF_NULL(g_hook);
 }
 
+// ActivationMode::Hook: every keystroke goes through lowLevelKeyboardProc and the chord engine.
+class HookActivation final : public ActivationBackend
+{
+public:
+    bool start(const std::vector<Chord>& chords) override
+    {
+        g_chordEngine.bind(chords);
+        installHook();
+        return true;
+    }
+
+    void stop() noexcept override
+    {
+        uninstallHook();
+    }
+};
+
+// ActivationMode::HotKey: WM_HOTKEY to hWnd, with the hotkey id being the binding.
+struct Win32HotKeyApi
+{
+    HWND hWnd;
+
+    bool registerHotKey(int id, const Chord& chord) const noexcept
+    {
+        const UINT modifiers = MOD_NOREPEAT
+            | ((chord.modifiers & CHM_CONTROL) ? MOD_CONTROL : 0)
+            | ((chord.modifiers & CHM_SHIFT) ? MOD_SHIFT : 0)
+            | ((chord.modifiers & CHM_ALT) ? MOD_ALT : 0)
+            | ((chord.modifiers & CHM_WIN) ? MOD_WIN : 0);
+        if (RegisterHotKey(hWnd, id, modifiers, chord.vk))
+            return true;
+        LOG_LAST_ERROR_MSG("RegisterHotKey %d", id);
+        return false;
+    }
+
+    void unregisterHotKey(int id) const noexcept
+    {
+        UnregisterHotKey(hWnd, id);
+    }
+};
+
+// Replaces the activation backend, if any, with the keyboard hook, which serves any chord.
+void startHookActivation(const std::vector<Chord>& chords)
+{
+    if (g_activation)
+        g_activation->stop();
+    auto hook = std::make_unique<HookActivation>();
+    hook->start(chords);
+    g_activation = std::move(hook);
+}
+
+// Starts the configured activation backend. Hotkeys that another application holds, now or once a target
+// window comes to the foreground (see foregroundEventProc), fall back to the keyboard hook.
+void startActivation(HWND hWnd)
+{
+    TRACE();
+
+    const auto chords = g_settings.hotkeyChords();
+    if (g_settings.activation == ActivationMode::HotKey)
+    {
+        auto hotKeys = std::make_unique<HotKeyActivation<Win32HotKeyApi>>(Win32HotKeyApi{ hWnd });
+        if (hotKeys->start(chords) && hotKeys->onTargetChanged(g_foreground.target() != nullptr))
+        {
+            g_activation = std::move(hotKeys);
+            return;
+        }
+        DBGPRINTLN("hotkeys unavailable, falling back to the keyboard hook");
+    }
+
+    startHookActivation(chords);
+}
+
+void stopActivation() noexcept
+{
+    if (g_activation)
+    {
+        g_activation->stop();
+        g_activation.reset();
+    }
+}
+
 bool isWorking()
 {
     return g_hook != nullptr;
@@ -406,12 +1078,19 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
     SetDefaultDllDirectories(LOAD_LIBRARY_SEARCH_SYSTEM32);
 
     UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
     UNREFERENCED_PARAMETER(nCmdShow);
 
     g_hInst = hInstance;
 
     g_szTitle = my::loadString(hInstance, IDS_APP_TITLE);
+    g_settings = Settings::load();
+
+#if QFC_TRACE_LEVEL > 0
+    TraceLog::instance().start([](const std::string& line) { OutputDebugStringA(line.c_str()); });
+    auto tracing = wil::scope_exit([] { TraceLog::instance().stop(); });
+    // The keyboard hook traces from this thread; its ring is allocated here rather than in the hook.
+    TraceLog::prepareThread();
+#endif
 
     g_szTitle.append(
 #if _M_ARM64 
@@ -423,6 +1102,12 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
 #endif
     );
 
+    if (auto options = parseBenchmarkCommandLine(lpCmdLine))
+    {
+        benchmark(hInstance, *options);
+        return 0;
+    }
+
     wil::unique_mutex m{ CreateMutex(nullptr, FALSE, g_szTitle.c_str()) };
     if (GetLastError() == ERROR_ALREADY_EXISTS)
     {
@@ -433,12 +1118,19 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
     THROW_IF_FAILED(hr);
     auto initialized = wil::scope_exit([] { CoUninitialize(); });
 
-    g_pSHWinds = wil::CoCreateInstance<ShellWindows, IShellWindows>(CLSCTX_ALL);
+    attachShellWindowIndex();
 
-    installHook();
-    auto hook = wil::scope_exit([] {
-        uninstallHook();
-        g_pSHWinds = nullptr;
+    g_copyWorker.start([](const CopyRequest& request) {
+        copyFromShellWindow(request.hWnd, g_settings.hotkeys[request.binding].format);
+        LatencyStats::instance().recordSince(LatencyStage::Total, request.queuedAt);
+    });
+
+    installForegroundTracking();
+    auto tracking = wil::scope_exit([] {
+        uninstallForegroundTracking();
+        g_copyWorker.stop();
+        g_selectionTracker.clear();
+        detachShellWindowIndex();
     });
 
     if (registerMyClass(hInstance) == 0)
@@ -446,6 +1138,9 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
         THROW_LAST_ERROR();
     }
 
+    g_splashWindow.create(hInstance, g_szTitle + L" Splash"s, g_settings.splashFadeMs, g_settings.splashFrameBudget);
+    auto splash = wil::scope_exit([] { g_splashWindow.destroy(); });
+
     HWND hWnd = CreateWindowW(szWindowClass, g_szTitle.c_str(), 0, CW_USEDEFAULT, 0, CW_USEDEFAULT, 0, nullptr, nullptr,
                               hInstance, nullptr);
 
@@ -454,6 +1149,9 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance
         return FALSE;
     }
 
+    startActivation(hWnd);
+    auto activation = wil::scope_exit([] { stopActivation(); });
+
     tryAddNotifyIcon(hWnd, NOTIFY_UID);
 
     MSG msg{};
@@ -484,6 +1182,44 @@ try
 }
 CATCH_SHOW_MSGBOX(hWnd)
 
+void saveLatencyStatistics(HWND hWnd)
+try
+{
+    WCHAR fileName[MAX_PATH]{ L"latency.txt" };
+    OPENFILENAMEW ofn{ sizeof(ofn) };
+    ofn.hwndOwner = hWnd;
+    ofn.lpstrFilter = L"Text Files (*.txt)\0*.txt\0All Files (*.*)\0*.*\0";
+    ofn.lpstrFile = fileName;
+    ofn.nMaxFile = ARRAYSIZE(fileName);
+    ofn.lpstrDefExt = L"txt";
+    ofn.Flags = OFN_OVERWRITEPROMPT | OFN_PATHMUSTEXIST;
+    if (!GetSaveFileNameW(&ofn))
+        return;
+
+    writeUtf8File(fileName, LatencyStats::instance().report());
+}
+CATCH_SHOW_MSGBOX(hWnd)
+
+void benchmark(HINSTANCE hInstance, const BenchmarkOptions& options)
+try
+{
+    // The clipboard needs an owner window, otherwise SetClipboardData fails after EmptyClipboard.
+    wil::unique_hwnd owner;
+    if (options.clipboard)
+    {
+        owner.reset(CreateWindowW(L"STATIC", nullptr, 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, hInstance, nullptr));
+        THROW_LAST_ERROR_IF_NULL(owner);
+        g_hwnd = owner.get();
+    }
+
+    auto report = runBenchmark(options);
+    if (options.output.empty())
+        ::MessageBox(nullptr, report.c_str(), g_szTitle.c_str(), MB_ICONINFORMATION);
+    else
+        writeUtf8File(options.output.c_str(), report);
+}
+CATCH_SHOW_MSGBOX(nullptr)
+
 LRESULT CALLBACK wndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) noexcept
 {
     static UINT s_uTaskbarRestart;
@@ -505,6 +1241,12 @@ LRESULT CALLBACK wndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         case ID_ROOT_REGISTERTOSTARTUPPROGRAM:
             registerToShortcut(hWnd);
             break;
+        case ID_ROOT_LATENCYSTATISTICS:
+            ::MessageBox(hWnd, LatencyStats::instance().report().c_str(), g_szTitle.c_str(), MB_ICONINFORMATION);
+            break;
+        case ID_ROOT_SAVELATENCYSTATISTICS:
+            saveLatencyStatistics(hWnd);
+            break;
         case ID_ROOT_EXIT:
             DestroyWindow(hWnd);
             break;
@@ -515,6 +1257,27 @@ LRESULT CALLBACK wndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     case WM_DESTROY:
         PostQuitMessage(0);
         break;
+    case WM_RENDERFORMAT:
+        if (wParam == CF_UNICODETEXT || wParam == utf8ClipboardFormat())
+            renderDeferredText(hWnd, false);
+        return 0;
+    case WM_RENDERALLFORMATS:
+        renderDeferredText(hWnd, true);
+        return 0;
+    case WM_DESTROYCLIPBOARD:
+        g_deferredText.discard();
+        return 0;
+    case WM_HOTKEY:
+        if (g_activation)
+            activate(g_activation->onHotKey(static_cast<int>(wParam)), false); // MOD_NOREPEAT
+        return 0;
+    case WM_COPIED:
+        try
+        {
+            g_splashWindow.show();
+        }
+        CATCH_LOG();
+        return 0;
     case WM_NOTIFYICON:
         switch (lParam)
         {
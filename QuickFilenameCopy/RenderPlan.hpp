@@ -0,0 +1,84 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+#include "OutputFormat.hpp"
+
+namespace
+{
+    // Splits the items into chunks that are measured and written in parallel.
+    // Each chunk writes at its prefix-summed offset in the final buffer, so the text is
+    // assembled without extra copies and is identical to a sequential render.
+    template <class Items>
+    class RenderPlan
+    {
+        const OutputFormat& m_format;
+        const Items& m_items;
+        std::vector<std::size_t> m_bounds;  // chunk i covers items [m_bounds[i], m_bounds[i + 1])
+        std::vector<std::size_t> m_offsets; // chunk i starts at m_offsets[i]; the last entry is the total size
+
+        std::vector<std::size_t> chunkIndices() const
+        {
+            std::vector<std::size_t> indices(m_bounds.size() - 1);
+            std::iota(indices.begin(), indices.end(), std::size_t{ 0 });
+            return indices;
+        }
+
+    public:
+        RenderPlan(const OutputFormat& format, const Items& items, std::size_t itemsPerChunk)
+            : m_format(format), m_items(items)
+        {
+            itemsPerChunk = std::max<std::size_t>(itemsPerChunk, 1);
+
+            // With no items there is still one empty chunk, which renders the prefix and suffix.
+            std::size_t begin = 0;
+            do
+            {
+                m_bounds.push_back(begin);
+                begin += itemsPerChunk;
+            } while (begin < items.size());
+            m_bounds.push_back(items.size());
+
+            m_offsets.resize(m_bounds.size());
+            if (chunkCount() == 1)
+            {
+                m_offsets[1] = format.measure(items, m_bounds[0], m_bounds[1]);
+                return;
+            }
+
+            auto indices = chunkIndices();
+            std::for_each(std::execution::par, indices.begin(), indices.end(), [&](std::size_t i) {
+                m_offsets[i + 1] = m_format.measure(m_items, m_bounds[i], m_bounds[i + 1]);
+            });
+            std::inclusive_scan(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+        }
+
+        [[nodiscard]]
+        std::size_t chunkCount() const noexcept
+        {
+            return m_bounds.size() - 1;
+        }
+
+        // Number of characters write() stores, without terminator.
+        [[nodiscard]]
+        std::size_t size() const noexcept
+        {
+            return m_offsets.back();
+        }
+
+        wchar_t* write(wchar_t* dest) const
+        {
+            if (chunkCount() == 1)
+                return m_format.write(m_items, m_bounds[0], m_bounds[1], dest);
+
+            auto indices = chunkIndices();
+            std::for_each(std::execution::par, indices.begin(), indices.end(), [&](std::size_t i) {
+                m_format.write(m_items, m_bounds[i], m_bounds[i + 1], dest + m_offsets[i]);
+            });
+            return dest + size();
+        }
+    };
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // Resolved values of the items of a selection, keyed by an opaque identity (the bytes of a child PIDL).
+    // update() reconciles the cache with a new selection: items that were already selected keep their value,
+    // only new ones are resolved, and items no longer selected are dropped. A cancelled update leaves the cache
+    // empty but keeps every value resolved so far, so that the next update does not resolve them again.
+    template <class Value>
+    class SelectionDiffCache
+    {
+        struct Entry
+        {
+            std::string key;
+            Value value;
+            std::uint32_t generation;
+        };
+
+        // Keys are views into Entry::key so that a lookup does not allocate.
+        std::unordered_map<std::string_view, std::unique_ptr<Entry>> m_entries;
+        std::vector<const Value*> m_order;
+        std::uint32_t m_generation{};
+
+    public:
+        struct Stats
+        {
+            std::size_t reused;
+            std::size_t resolved;
+            std::size_t evicted;
+            bool cancelled;
+        };
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_order.size(); }
+        [[nodiscard]] bool empty() const noexcept { return m_order.empty(); }
+        [[nodiscard]] const Value& operator[](std::size_t i) const noexcept { return *m_order[i]; }
+
+        void clear() noexcept
+        {
+            m_entries.clear();
+            m_order.clear();
+        }
+
+        // keys[i] identifies the i-th selected item and must be convertible to std::string_view.
+        // resolve(i) returns the value of an item that was not in the previous selection.
+        // cancelled() is asked before each item that has to be resolved; once it returns true the update stops.
+        template <class Keys, class Resolve, class Cancelled>
+        Stats update(const Keys& keys, Resolve&& resolve, Cancelled&& cancelled)
+        {
+            const auto generation = ++m_generation;
+            Stats stats{};
+
+            m_order.clear();
+            m_order.reserve(keys.size());
+            for (std::size_t i = 0; i < keys.size(); i++)
+            {
+                std::string_view key{ keys[i] };
+                auto it = m_entries.find(key);
+                if (it != m_entries.end())
+                {
+                    it->second->generation = generation;
+                    stats.reused++;
+                }
+                else
+                {
+                    if (cancelled())
+                    {
+                        m_order.clear();
+                        stats.cancelled = true;
+                        return stats;
+                    }
+                    auto entry = std::make_unique<Entry>(Entry{ std::string{ key }, resolve(i), generation });
+                    it = m_entries.emplace(std::string_view{ entry->key }, std::move(entry)).first;
+                    stats.resolved++;
+                }
+                m_order.push_back(&it->second->value);
+            }
+
+            for (auto it = m_entries.begin(); it != m_entries.end();)
+            {
+                if (it->second->generation != generation)
+                {
+                    it = m_entries.erase(it);
+                    stats.evicted++;
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            return stats;
+        }
+
+        template <class Keys, class Resolve>
+        Stats update(const Keys& keys, Resolve&& resolve)
+        {
+            return update(keys, std::forward<Resolve>(resolve), [] { return false; });
+        }
+    };
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "PathInterner.hpp"
+
+namespace
+{
+    enum SelectionItemFlags : std::uint8_t
+    {
+        SIF_NAME = 0x1, // the item has a display name
+        SIF_PATH = 0x2, // the item has a parsing path
+        SIF_FILESYSTEM = 0x4, // the parsing path is also the item's file system path (SIGDN_FILESYSPATH)
+    };
+
+    // The selected items in selection order, as consumed by OutputFormat.
+    // All names and path leaves live back to back in one arena; per item there are only offsets, lengths,
+    // a parent folder id and flags, stored as parallel arrays. The parent folders are interned, so a path
+    // is its folder prefix, stored once per folder, followed by its leaf; see pathParts().
+    // Appending an item does not allocate once the arrays are reserved, and iterating touches nothing
+    // but the arrays, the arena and the few folders.
+    class SelectionSnapshot
+    {
+        std::vector<wchar_t> m_arena;
+        std::vector<std::uint32_t> m_nameOffsets;
+        std::vector<std::uint32_t> m_nameLengths;
+        std::vector<std::uint32_t> m_leafOffsets;
+        std::vector<std::uint32_t> m_leafLengths;
+        std::vector<std::uint32_t> m_parentIds;
+        std::vector<std::uint8_t> m_flags;
+
+        // Distinct parent folders. A selection usually comes from one folder, so this stays tiny.
+        PathInterner m_folders;
+
+        std::uint32_t store(std::wstring_view s)
+        {
+            auto offset = static_cast<std::uint32_t>(m_arena.size());
+            m_arena.insert(m_arena.end(), s.begin(), s.end());
+            return offset;
+        }
+
+    public:
+        // Reserves room for count items with about chars characters of names and paths in total.
+        void reserve(std::size_t count, std::size_t chars)
+        {
+            m_arena.reserve(chars);
+            m_nameOffsets.reserve(count);
+            m_nameLengths.reserve(count);
+            m_leafOffsets.reserve(count);
+            m_leafLengths.reserve(count);
+            m_parentIds.reserve(count);
+            m_flags.reserve(count);
+        }
+
+        void append(std::wstring_view name, std::wstring_view path, std::uint8_t flags)
+        {
+            auto [parentId, leaf] = m_folders.intern(path);
+            m_nameOffsets.push_back(store(name));
+            m_nameLengths.push_back(static_cast<std::uint32_t>(name.size()));
+            m_leafOffsets.push_back(store(leaf));
+            m_leafLengths.push_back(static_cast<std::uint32_t>(leaf.size()));
+            m_parentIds.push_back(parentId);
+            m_flags.push_back(flags);
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_flags.size(); }
+        [[nodiscard]] bool empty() const noexcept { return m_flags.empty(); }
+        // Characters of names and path leaves stored in the arena.
+        [[nodiscard]] std::size_t chars() const noexcept { return m_arena.size(); }
+
+        [[nodiscard]] std::wstring_view name(std::size_t i) const noexcept
+        {
+            return { m_arena.data() + m_nameOffsets[i], m_nameLengths[i] };
+        }
+        // The path as the folder prefix, including the trailing separator, and the leaf.
+        // The path itself is never stored in one piece.
+        [[nodiscard]] std::pair<std::wstring_view, std::wstring_view> pathParts(std::size_t i) const noexcept
+        {
+            return { m_folders.prefix(m_parentIds[i]), { m_arena.data() + m_leafOffsets[i], m_leafLengths[i] } };
+        }
+        [[nodiscard]] std::uint32_t parentId(std::size_t i) const noexcept { return m_parentIds[i]; }
+        [[nodiscard]] std::uint8_t flags(std::size_t i) const noexcept { return m_flags[i]; }
+
+        [[nodiscard]] std::size_t folderCount() const noexcept { return m_folders.size(); }
+        [[nodiscard]] std::wstring_view folder(std::uint32_t id) const noexcept { return m_folders.folder(id); }
+
+        // Heap bytes held by the snapshot, for the benchmark report.
+        [[nodiscard]]
+        std::size_t bytes() const noexcept
+        {
+            return m_arena.capacity() * sizeof(wchar_t)
+                + (m_nameOffsets.capacity() + m_nameLengths.capacity() + m_leafOffsets.capacity()
+                    + m_leafLengths.capacity() + m_parentIds.capacity()) * sizeof(std::uint32_t)
+                + m_flags.capacity() + m_folders.bytes();
+        }
+    };
+}
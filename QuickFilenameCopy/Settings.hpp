@@ -0,0 +1,210 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <windows.h>
+#include <shlwapi.h>
+
+#include "Activation.hpp"
+#include "ChordEngine.hpp"
+#include "ClipboardEncoders.hpp"
+#include "OutputFormat.hpp"
+#include "SortOrder.hpp"
+
+namespace
+{
+    // A chord and what it copies.
+    struct HotkeyBinding
+    {
+        Chord chord;
+        OutputFormat format;
+    };
+
+    // User tunables, read once at startup from QuickFilenameCopy*.ini next to the executable.
+    struct Settings
+    {
+        // Number of items fetched from Explorer per round trip.
+        ULONG itemChunkSize = 256;
+        // Number of items formatted per parallel task; selections up to this size are formatted on one thread.
+        ULONG formatChunkSize = 16384;
+        // Keep the names of each view's selection between copies and only resolve what changed.
+        bool incrementalSelection = false;
+        // Selections of at least this many items are put on the clipboard with delayed rendering; 0 disables it.
+        ULONG delayedRenderThreshold = 0;
+        // Extra clipboard formats published with the text, a combination of ClipboardFormatFlags.
+        unsigned clipboardFormats = 0;
+        // What gets copied for the selection.
+        OutputFormat format;
+        // Chords that copy the selection; the first is [Copy] Hotkey with format, the others come from
+        // [Hotkey1] to [Hotkey9], each with its own format.
+        std::vector<HotkeyBinding> hotkeys;
+        // How hotkeys are recognized; HotKey falls back to Hook if a chord is taken by another application.
+        ActivationMode activation = ActivationMode::Hook;
+        // Order of the copied items.
+        SortMode sortMode = SortMode::None;
+        // Duration of the splash fade-out; 0 hides it at once.
+        UINT splashFadeMs = 0;
+        // Maximum number of frames the splash renders per copy, including the first one.
+        UINT splashFrameBudget = 8;
+
+        static std::wstring iniPath()
+        {
+            WCHAR path[MAX_PATH]{};
+            GetModuleFileNameW(nullptr, path, ARRAYSIZE(path));
+            PathRenameExtensionW(path, L".ini");
+            return path;
+        }
+
+        static std::wstring readString(const std::wstring& path, LPCWSTR section, LPCWSTR key, LPCWSTR defaultValue)
+        {
+            WCHAR value[1024]{};
+            DWORD len = GetPrivateProfileStringW(section, key, defaultValue, value, ARRAYSIZE(value), path.c_str());
+            return { value, len };
+        }
+
+        // "\n", "\r", "\t" and "\\" in ini values stand for the control characters, which an ini file cannot hold.
+        static std::wstring unescape(std::wstring_view s)
+        {
+            std::wstring result;
+            result.reserve(s.size());
+            for (size_t i = 0; i < s.size(); i++)
+            {
+                if (s[i] == L'\\' && i + 1 < s.size())
+                {
+                    switch (s[i + 1])
+                    {
+                    case L'n': result.push_back(L'\n'); i++; continue;
+                    case L'r': result.push_back(L'\r'); i++; continue;
+                    case L't': result.push_back(L'\t'); i++; continue;
+                    case L'\\': result.push_back(L'\\'); i++; continue;
+                    default: break;
+                    }
+                }
+                result.push_back(s[i]);
+            }
+            return result;
+        }
+
+        static OutputFormat parseFormat(const std::wstring& path, LPCWSTR section)
+        {
+            auto name = readString(path, section, L"Format", L"names");
+            if (lstrcmpiW(name.c_str(), L"paths") == 0)
+                return OutputFormat{ BuiltinFormat::Paths };
+            if (lstrcmpiW(name.c_str(), L"quoted") == 0)
+                return OutputFormat{ BuiltinFormat::Quoted };
+            if (lstrcmpiW(name.c_str(), L"csv") == 0)
+                return OutputFormat{ BuiltinFormat::Csv };
+            if (lstrcmpiW(name.c_str(), L"json") == 0)
+                return OutputFormat{ BuiltinFormat::Json };
+            if (lstrcmpiW(name.c_str(), L"powershell") == 0)
+                return OutputFormat{ BuiltinFormat::PowerShell };
+            if (lstrcmpiW(name.c_str(), L"template") == 0)
+            {
+                auto templ = readString(path, section, L"Template", L"{name}");
+                auto separator = unescape(readString(path, section, L"Separator", L"\\n"));
+                if (auto format = OutputFormat::compile(templ, separator))
+                    return *format;
+            }
+            return OutputFormat{ BuiltinFormat::Names };
+        }
+
+        static SortMode parseSortMode(const std::wstring& name) noexcept
+        {
+            if (lstrcmpiW(name.c_str(), L"name") == 0)
+                return SortMode::Name;
+            if (lstrcmpiW(name.c_str(), L"natural") == 0)
+                return SortMode::Natural;
+            if (lstrcmpiW(name.c_str(), L"extension") == 0)
+                return SortMode::Extension;
+            if (lstrcmpiW(name.c_str(), L"locale") == 0)
+                return SortMode::Locale;
+            return SortMode::None;
+        }
+
+        // The [Copy] chord first, then each [HotkeyN] section with a valid Hotkey, until the first one without.
+        static std::vector<HotkeyBinding> parseHotkeys(const std::wstring& path, const OutputFormat& format)
+        {
+            std::vector<HotkeyBinding> hotkeys;
+            auto chord = parseChord(readString(path, L"Copy", L"Hotkey", L"Ctrl+Shift+C"));
+            hotkeys.push_back({ chord.value_or(Chord{ CHM_CONTROL | CHM_SHIFT, 'C' }), format });
+
+            for (int i = 1; i <= 9; i++)
+            {
+                auto section = L"Hotkey" + std::to_wstring(i);
+                auto text = readString(path, section.c_str(), L"Hotkey", L"");
+                if (text.empty())
+                    break;
+                if (auto chord = parseChord(text))
+                    hotkeys.push_back({ *chord, parseFormat(path, section.c_str()) });
+            }
+            return hotkeys;
+        }
+
+        static ActivationMode parseActivation(const std::wstring& name) noexcept
+        {
+            if (lstrcmpiW(name.c_str(), L"hotkey") == 0)
+                return ActivationMode::HotKey;
+            return ActivationMode::Hook;
+        }
+
+        // Comma separated list of hdrop, html, markdown, shellidlist and utf8.
+        static unsigned parseClipboardFormats(std::wstring_view list)
+        {
+            unsigned formats = 0;
+            while (!list.empty())
+            {
+                auto comma = list.find(L',');
+                auto name = std::wstring{ list.substr(0, comma) };
+                StrTrimW(name.data(), L" \t");
+                if (lstrcmpiW(name.c_str(), L"hdrop") == 0)
+                    formats |= CBF_HDROP;
+                else if (lstrcmpiW(name.c_str(), L"html") == 0)
+                    formats |= CBF_HTML;
+                else if (lstrcmpiW(name.c_str(), L"markdown") == 0)
+                    formats |= CBF_MARKDOWN;
+                else if (lstrcmpiW(name.c_str(), L"shellidlist") == 0)
+                    formats |= CBF_SHELLIDLIST;
+                else if (lstrcmpiW(name.c_str(), L"utf8") == 0)
+                    formats |= CBF_UTF8;
+                list = comma == std::wstring_view::npos ? std::wstring_view{} : list.substr(comma + 1);
+            }
+            return formats;
+        }
+
+        static Settings load()
+        {
+            const auto path = iniPath();
+            Settings settings;
+
+            settings.itemChunkSize = GetPrivateProfileIntW(L"Copy", L"ItemChunkSize", settings.itemChunkSize, path.c_str());
+            if (settings.itemChunkSize == 0)
+                settings.itemChunkSize = 1;
+
+            settings.formatChunkSize = GetPrivateProfileIntW(L"Copy", L"FormatChunkSize", settings.formatChunkSize, path.c_str());
+            settings.incrementalSelection = GetPrivateProfileIntW(L"Copy", L"IncrementalSelection", 0, path.c_str()) != 0;
+            settings.delayedRenderThreshold = GetPrivateProfileIntW(L"Copy", L"DelayedRenderThreshold", settings.delayedRenderThreshold, path.c_str());
+            settings.format = parseFormat(path, L"Copy");
+            settings.hotkeys = parseHotkeys(path, settings.format);
+            settings.activation = parseActivation(readString(path, L"Copy", L"Activation", L"hook"));
+            settings.clipboardFormats = parseClipboardFormats(readString(path, L"Copy", L"ClipboardFormats", L""));
+            settings.sortMode = parseSortMode(readString(path, L"Copy", L"Sort", L"none"));
+
+            settings.splashFadeMs = GetPrivateProfileIntW(L"Splash", L"FadeMs", settings.splashFadeMs, path.c_str());
+            settings.splashFrameBudget = GetPrivateProfileIntW(L"Splash", L"FrameBudget", settings.splashFrameBudget, path.c_str());
+
+            return settings;
+        }
+
+        // The chords of hotkeys, in binding order, for ChordEngine::bind().
+        [[nodiscard]]
+        std::vector<Chord> hotkeyChords() const
+        {
+            std::vector<Chord> chords;
+            for (const auto& hotkey : hotkeys)
+            {
+                chords.push_back(hotkey.chord);
+            }
+            return chords;
+        }
+    };
+}
@@ -0,0 +1,205 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cwchar>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <windows.h>
+#include <shlobj.h>
+#include <shlwapi.h>
+#include <shobjidl.h>
+#include <wil/com.h>
+#include <wil/resource.h>
+#include <wil/result.h>
+
+#include "CidaParser.hpp"
+#include "ItemNameSource.hpp"
+#include "OutputFormat.hpp"
+
+namespace
+{
+    namespace shell_source_detail
+    {
+        inline std::wstring_view view(const wil::unique_cotaskmem_string& s) noexcept
+        {
+            return s ? std::wstring_view{ s.get() } : std::wstring_view{};
+        }
+
+        // The strings of one chunk of items. They are kept until the next chunk is fetched,
+        // which is as long as the SelectionItem views handed out for them are used.
+        class ChunkStrings
+        {
+            std::vector<wil::unique_cotaskmem_string> m_names;
+            std::vector<wil::unique_cotaskmem_string> m_paths;
+            std::vector<bool> m_fileSystem;
+
+        public:
+            void reset(std::size_t count)
+            {
+                m_names.clear();
+                m_paths.clear();
+                m_fileSystem.clear();
+                m_names.resize(count);
+                m_paths.resize(count);
+                m_fileSystem.resize(count);
+            }
+
+            wil::unique_cotaskmem_string& name(std::size_t i) noexcept { return m_names[i]; }
+            wil::unique_cotaskmem_string& path(std::size_t i) noexcept { return m_paths[i]; }
+
+            // Records whether the path of item i is its file system path, given what SIGDN_FILESYSPATH returned.
+            void setFileSystemPath(std::size_t i, const wil::unique_cotaskmem_string& fileSystemPath) noexcept
+            {
+                m_fileSystem[i] = m_paths[i] && fileSystemPath && std::wcscmp(m_paths[i].get(), fileSystemPath.get()) == 0;
+            }
+
+            SelectionItem item(std::size_t i) const noexcept
+            {
+                return { view(m_names[i]), view(m_paths[i]),
+                    static_cast<std::uint8_t>((m_names[i] ? SIF_NAME : 0) | (m_paths[i] ? SIF_PATH : 0) | (m_fileSystem[i] ? SIF_FILESYSTEM : 0)) };
+            }
+        };
+    }
+
+    // Walks an IShellItemArray through IEnumShellItems::Next so that each round trip
+    // into Explorer returns a whole chunk of items instead of one GetItemAt call per item.
+    class ShellItemArrayNameSource final : public ItemNameSource
+    {
+        wil::com_ptr_t<IEnumShellItems> m_enum;
+        std::uint32_t m_count{};
+        unsigned m_fields;
+        std::vector<IShellItem*> m_items;
+        shell_source_detail::ChunkStrings m_strings;
+
+    public:
+        // fields is a combination of ItemFieldFlags.
+        ShellItemArrayNameSource(IShellItemArray* pSIA, unsigned fields, std::uint32_t chunkSize)
+            : m_fields(fields), m_items(std::max<std::uint32_t>(chunkSize, 1))
+        {
+            DWORD dwCount{};
+            THROW_IF_FAILED(pSIA->GetCount(&dwCount));
+            m_count = dwCount;
+            THROW_IF_FAILED(pSIA->EnumItems(&m_enum));
+        }
+
+        std::uint32_t count() override
+        {
+            return m_count;
+        }
+
+        std::uint32_t next(SelectionItem* items, std::uint32_t count) override
+        {
+            count = std::min(count, static_cast<std::uint32_t>(m_items.size()));
+
+            ULONG fetched{};
+            THROW_IF_FAILED(m_enum->Next(count, m_items.data(), &fetched));
+
+            std::vector<wil::com_ptr_t<IShellItem>> shellItems(fetched);
+            for (ULONG i = 0; i < fetched; i++)
+            {
+                shellItems[i].attach(m_items[i]);
+            }
+
+            m_strings.reset(fetched);
+            for (ULONG i = 0; i < fetched; i++)
+            {
+                if (m_fields & IFF_NAME)
+                    THROW_IF_FAILED(shellItems[i]->GetDisplayName(SIGDN_NORMALDISPLAY, &m_strings.name(i)));
+                if (m_fields & IFF_PATH)
+                    THROW_IF_FAILED(shellItems[i]->GetDisplayName(SIGDN_DESKTOPABSOLUTEPARSING, &m_strings.path(i)));
+                if (m_fields & IFF_FILESYSPATH)
+                {
+                    // Fails for items outside the file system.
+                    wil::unique_cotaskmem_string fileSystemPath;
+                    if (SUCCEEDED(shellItems[i]->GetDisplayName(SIGDN_FILESYSPATH, &fileSystemPath)))
+                        m_strings.setFileSystemPath(i, fileSystemPath);
+                }
+                items[i] = m_strings.item(i);
+            }
+            return fetched;
+        }
+    };
+
+    // Fetches the selection of the view as one CFSTR_SHELLIDLIST block: two calls into Explorer
+    // however many items are selected. Returns false if nothing is selected.
+    inline bool fetchSelectionIdList(IFolderView2* pfv2, wil::unique_stg_medium& medium)
+    {
+        wil::com_ptr_t<IDataObject> pdo;
+        if (FAILED(pfv2->Items(SVGIO_SELECTION, IID_PPV_ARGS(&pdo))))
+            return false;
+
+        static const auto cfShellIdList = static_cast<CLIPFORMAT>(RegisterClipboardFormatW(CFSTR_SHELLIDLIST));
+        FORMATETC fe{ cfShellIdList, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+        return SUCCEEDED(pdo->GetData(&fe, &medium)) && medium.tymed == TYMED_HGLOBAL;
+    }
+
+    // Resolves the selection from its CFSTR_SHELLIDLIST block: the ID lists of all items come over in one
+    // transfer, and names are then asked of the parent folder in this process, so no call per item goes into
+    // Explorer. The parent folder is bound once; only children deeper than one level are resolved on their own.
+    class CidaNameSource final : public ItemNameSource
+    {
+        wil::unique_stg_medium m_medium;
+        wil::unique_hglobal_locked m_data;
+        Cida m_cida;
+        std::vector<char> m_absolute; // the ID list of the item being resolved
+        unsigned m_fields;
+        std::uint32_t m_next{};
+        shell_source_detail::ChunkStrings m_strings;
+
+        CidaNameSource(wil::unique_stg_medium medium, unsigned fields)
+            : m_medium(std::move(medium)), m_data(m_medium.hGlobal), m_fields(fields)
+        {}
+
+    public:
+        // nullptr if the view has no selection as an ID list; the caller falls back to ShellItemArrayNameSource.
+        // fields is a combination of ItemFieldFlags.
+        static std::unique_ptr<CidaNameSource> create(IFolderView2* pfv2, unsigned fields)
+        {
+            wil::unique_stg_medium medium;
+            if (!fetchSelectionIdList(pfv2, medium))
+                return nullptr;
+
+            std::unique_ptr<CidaNameSource> source{ new CidaNameSource(std::move(medium), fields) };
+            if (!source->m_data || !parseCida(source->m_data.get(), GlobalSize(source->m_medium.hGlobal), source->m_cida) || source->m_cida.children.empty())
+                return nullptr;
+            return source;
+        }
+
+        // The CFSTR_SHELLIDLIST block as Explorer provided it.
+        [[nodiscard]] const void* block() const noexcept { return m_data.get(); }
+        [[nodiscard]] SIZE_T blockSize() const noexcept { return GlobalSize(m_medium.hGlobal); }
+
+        std::uint32_t count() override
+        {
+            return static_cast<std::uint32_t>(m_cida.children.size());
+        }
+
+        // Names are resolved from absolute ID lists rather than through the folder bound once: a folder object
+        // is tied to the thread that bound it, and the copy worker would pay a marshaled call per item and name.
+        std::uint32_t next(SelectionItem* items, std::uint32_t count) override
+        {
+            count = std::min(count, this->count() - m_next);
+            m_strings.reset(count);
+            for (std::uint32_t i = 0; i < count; i++)
+            {
+                auto pidl = reinterpret_cast<PCIDLIST_ABSOLUTE>(absoluteIdList(m_cida, m_cida.children[m_next + i], m_absolute).data());
+                if (m_fields & IFF_NAME)
+                    THROW_IF_FAILED(SHGetNameFromIDList(pidl, SIGDN_NORMALDISPLAY, &m_strings.name(i)));
+                if (m_fields & IFF_PATH)
+                    THROW_IF_FAILED(SHGetNameFromIDList(pidl, SIGDN_DESKTOPABSOLUTEPARSING, &m_strings.path(i)));
+                if (m_fields & IFF_FILESYSPATH)
+                {
+                    // Fails for items outside the file system.
+                    wil::unique_cotaskmem_string fileSystemPath;
+                    if (SUCCEEDED(SHGetNameFromIDList(pidl, SIGDN_FILESYSPATH, &fileSystemPath)))
+                        m_strings.setFileSystemPath(i, fileSystemPath);
+                }
+                items[i] = m_strings.item(i);
+            }
+            m_next += count;
+            return count;
+        }
+    };
+}
@@ -0,0 +1,187 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    // Window -> browser for every open shell window, so looking up the foreground Explorer costs a hash probe
+    // instead of a walk over IShellWindows.
+    // DShellWindowsEvents keeps the table current one window at a time: a revocation evicts the window
+    // registered under its cookie. IShellWindows cannot be asked which window a cookie names, so a registration
+    // enumerates the windows on whatever Backend::post runs it on and adds the ones the table does not know;
+    // the cookie is kept when that is exactly one window. A revocation with an unknown cookie drops the windows
+    // that no longer exist, and a lookup miss enumerates everything again in the caller.
+    //
+    // Backend is the shell behind the table:
+    //   using Window, Entry;                                    // window handle and what is kept per window
+    //   std::vector<std::pair<Window, Entry>> enumerate();       // every shell window
+    //   bool isWindow(Window);                                  // whether the window still exists
+    //   void post(std::function<void()>);                       // runs the function later, on another thread
+    template <class Backend>
+    class ShellWindowIndex
+    {
+    public:
+        using Window = typename Backend::Window;
+        using Entry = typename Backend::Entry;
+
+    private:
+        Backend m_backend;
+
+        mutable std::shared_mutex m_lock;
+        std::unordered_map<Window, Entry> m_entries;
+        // Windows registered while attached, by the cookie their revocation will carry.
+        // Windows found by enumerate() have no cookie.
+        std::unordered_map<long, Window> m_cookies;
+        // Windows added by registrations, with the count of additions when each was added, so that a rebuild
+        // keeps the ones added while it was enumerating.
+        std::unordered_map<Window, std::uint64_t> m_added;
+        std::uint64_t m_additions{};
+
+        // Drops the windows that no longer exist, for a revocation whose cookie is unknown.
+        void prune()
+        {
+            std::unique_lock lock{ m_lock };
+            for (auto it = m_entries.begin(); it != m_entries.end();)
+            {
+                if (m_backend.isWindow(it->first))
+                {
+                    ++it;
+                    continue;
+                }
+                m_added.erase(it->first);
+                it = m_entries.erase(it);
+            }
+        }
+
+        // Adds the windows the table does not know yet; the one window, if it is one, gets the cookie.
+        void addRegistered(long cookie)
+        {
+            auto windows = m_backend.enumerate();
+
+            std::unique_lock lock{ m_lock };
+            std::optional<Window> added;
+            std::size_t count = 0;
+            for (auto& [window, entry] : windows)
+            {
+                if (m_entries.count(window) != 0)
+                    continue;
+                m_entries.emplace(window, std::move(entry));
+                m_added.insert_or_assign(window, ++m_additions);
+                added = window;
+                count++;
+            }
+            // Several new windows: registrations arrived together, and which cookie is whose is unknown.
+            // Their revocations prune instead.
+            if (count == 1)
+                m_cookies.insert_or_assign(cookie, *added);
+        }
+
+    public:
+        template <class... Args>
+        explicit ShellWindowIndex(Args&&... args)
+            : m_backend(std::forward<Args>(args)...)
+        {}
+
+        [[nodiscard]] Backend& backend() noexcept { return m_backend; }
+
+        // DISPID_WINDOWREGISTERED: adds the window registered under cookie, later on another thread.
+        void onRegistered(long cookie)
+        {
+            m_backend.post([this, cookie] { addRegistered(cookie); });
+        }
+
+        // DISPID_WINDOWREVOKED: removes the window registered under cookie.
+        void onRevoked(long cookie)
+        {
+            {
+                std::unique_lock lock{ m_lock };
+                auto it = m_cookies.find(cookie);
+                if (it != m_cookies.end())
+                {
+                    m_entries.erase(it->second);
+                    m_added.erase(it->second);
+                    m_cookies.erase(it);
+                    return;
+                }
+            }
+            prune();
+        }
+
+        // The entry of window, or nullopt if it is not a shell window. A window may become a shell window
+        // before its registration reaches the table, so a miss rebuilds it and looks again. Call it where
+        // enumerating the shell windows may block, as the copy worker does.
+        std::optional<Entry> find(Window window)
+        {
+            auto lookup = [&]() -> std::optional<Entry> {
+                std::shared_lock lock{ m_lock };
+                auto it = m_entries.find(window);
+                if (it != m_entries.end())
+                    return it->second;
+                return std::nullopt;
+            };
+
+            if (auto entry = lookup())
+                return entry;
+            rebuild();
+            return lookup();
+        }
+
+        // Enumerates every shell window and makes the table match. Windows that registrations added while
+        // the enumeration ran are kept, and so are the cookies of windows that are still open.
+        void rebuild()
+        {
+            std::uint64_t additionsBefore;
+            {
+                std::shared_lock lock{ m_lock };
+                additionsBefore = m_additions;
+            }
+            auto windows = m_backend.enumerate();
+
+            std::unordered_map<Window, Entry> entries;
+            entries.reserve(windows.size());
+            for (auto& [window, entry] : windows)
+            {
+                entries.insert_or_assign(window, std::move(entry));
+            }
+
+            std::unique_lock lock{ m_lock };
+            for (auto it = m_added.begin(); it != m_added.end();)
+            {
+                if (it->second <= additionsBefore)
+                {
+                    it = m_added.erase(it);
+                    continue;
+                }
+                if (auto entry = m_entries.find(it->first); entry != m_entries.end() && entries.count(it->first) == 0)
+                    entries.emplace(it->first, std::move(entry->second));
+                ++it;
+            }
+            m_entries.swap(entries);
+            for (auto it = m_cookies.begin(); it != m_cookies.end();)
+            {
+                it = m_entries.count(it->second) != 0 ? std::next(it) : m_cookies.erase(it);
+            }
+        }
+
+        void clear() noexcept
+        {
+            std::unique_lock lock{ m_lock };
+            m_entries.clear();
+            m_cookies.clear();
+            m_added.clear();
+        }
+
+        [[nodiscard]]
+        std::size_t size() const
+        {
+            std::shared_lock lock{ m_lock };
+            return m_entries.size();
+        }
+    };
+}
@@ -0,0 +1,356 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+#include <functional>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ItemNameSource.hpp"
+#include "OutputFormat.hpp"
+
+namespace
+{
+    using namespace std::string_view_literals;
+
+    // Parameters of a /benchmark run, given on the command line as key=value pairs:
+    //   QuickFilenameCopy64.exe /benchmark out=report.txt items=100000 windows=30 iterations=20
+    struct BenchmarkOptions
+    {
+        std::uint32_t windows = 30;        // number of simulated shell windows in the index
+        std::uint32_t items = 100000;      // selection size
+        std::uint32_t iterations = 20;     // copies to run
+        std::uint32_t minNameLength = 4;   // display names are uniformly distributed in [minNameLength, maxNameLength]
+        std::uint32_t maxNameLength = 40;
+        std::uint32_t chunkLatencyUs = 0;  // delay injected per ItemNameSource::next call, standing in for a round trip into Explorer
+        std::uint32_t lookupLatencyUs = 0; // delay injected per window read from the simulated IShellWindows
+        std::uint32_t folders = 1;         // parent folders the selection is spread over, in consecutive runs
+        std::uint32_t depth = 1;           // directory levels between C:\Bench and each item
+        std::uint32_t keyEvents = 1000000; // key events replayed through the chord engine
+        bool components = true;    // also run the component benchmarks (ComponentBenchmarks.hpp)
+        bool clipboard = false;    // also publish to the real clipboard
+        std::wstring output;       // report file; a message box is shown when empty
+
+        // args are the key=value pairs that follow /benchmark; anything else is ignored.
+        static BenchmarkOptions parse(const std::vector<std::wstring_view>& args)
+        {
+            BenchmarkOptions options;
+            for (auto arg : args)
+            {
+                auto eq = arg.find(L'=');
+                if (eq == std::wstring_view::npos)
+                    continue;
+
+                auto key = arg.substr(0, eq);
+                auto value = arg.substr(eq + 1);
+                auto number = [&] { return static_cast<std::uint32_t>(std::wcstoul(std::wstring{ value }.c_str(), nullptr, 10)); };
+
+                if (key == L"windows"sv) options.windows = number();
+                else if (key == L"items"sv) options.items = number();
+                else if (key == L"iterations"sv) options.iterations = number();
+                else if (key == L"minNameLength"sv) options.minNameLength = number();
+                else if (key == L"maxNameLength"sv) options.maxNameLength = number();
+                else if (key == L"chunkLatencyUs"sv) options.chunkLatencyUs = number();
+                else if (key == L"lookupLatencyUs"sv) options.lookupLatencyUs = number();
+                else if (key == L"folders"sv) options.folders = number();
+                else if (key == L"depth"sv) options.depth = number();
+                else if (key == L"keyEvents"sv) options.keyEvents = number();
+                else if (key == L"clipboard"sv) options.clipboard = number() != 0;
+                else if (key == L"components"sv) options.components = number() != 0;
+                else if (key == L"out"sv) options.output = value;
+            }
+            if (options.maxNameLength < options.minNameLength)
+                options.maxNameLength = options.minNameLength;
+            if (options.iterations == 0)
+                options.iterations = 1;
+            options.folders = std::clamp<std::uint32_t>(options.folders, 1, std::max<std::uint32_t>(options.items, 1));
+            options.depth = std::max<std::uint32_t>(options.depth, 1);
+            return options;
+        }
+    };
+
+    inline void injectLatency(std::uint32_t us)
+    {
+        if (us == 0)
+            return;
+
+        // Spin rather than sleep: Sleep cannot express sub-millisecond round trips.
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+        while (std::chrono::steady_clock::now() < until)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // Stand-in for IShellWindows behind ShellWindowIndex: fake window handles mapped to window numbers.
+    // Windows open and close under cookies as Explorer's do, at any position of the enumeration, since
+    // IShellWindows does not keep them in registration order; posted work waits until runPosted().
+    class SimulatedShellWindows
+    {
+    public:
+        using Window = std::uintptr_t;
+        using Entry = std::uint32_t; // window number
+
+    private:
+        struct Registration
+        {
+            long cookie;
+            Window window;
+            Entry entry;
+        };
+
+        std::vector<Registration> m_windows;
+        std::vector<Window> m_destroyed;
+        std::vector<std::function<void()>> m_posted;
+        std::uint32_t m_lookupLatencyUs;
+        long m_nextCookie{ 1 };
+        std::uint32_t m_nextEntry{};
+
+    public:
+        // Called by enumerate() once it has read the windows, standing in for events that arrive meanwhile.
+        std::function<void()> duringEnumerate;
+
+        SimulatedShellWindows(std::uint32_t windows, std::uint32_t lookupLatencyUs)
+            : m_lookupLatencyUs(lookupLatencyUs)
+        {
+            for (std::uint32_t i = 0; i < windows; i++)
+            {
+                open();
+            }
+        }
+
+        static constexpr Window windowOf(std::uint32_t entry) noexcept
+        {
+            return static_cast<Window>(0x10000 + entry * 8);
+        }
+
+        // Registers a new window at position of the enumeration (the end by default) and returns its cookie.
+        long open(std::size_t position = SIZE_MAX)
+        {
+            const auto entry = m_nextEntry++;
+            const auto at = std::min(position, m_windows.size());
+            m_windows.push_back({ m_nextCookie, windowOf(entry), entry });
+            std::rotate(m_windows.begin() + at, m_windows.end() - 1, m_windows.end());
+            return m_nextCookie++;
+        }
+
+        // Revokes the window registered under cookie; destroyed also destroys its window.
+        void close(long cookie, bool destroyed = true)
+        {
+            auto it = std::find_if(m_windows.begin(), m_windows.end(), [&](const Registration& r) { return r.cookie == cookie; });
+            if (it == m_windows.end())
+                return;
+            if (destroyed)
+                m_destroyed.push_back(it->window);
+            m_windows.erase(it);
+        }
+
+        [[nodiscard]] std::size_t windowCount() const noexcept { return m_windows.size(); }
+        [[nodiscard]] Window window(std::uint32_t i) const noexcept { return m_windows[i % m_windows.size()].window; }
+
+        std::vector<std::pair<Window, Entry>> enumerate()
+        {
+            std::vector<std::pair<Window, Entry>> windows;
+            windows.reserve(m_windows.size());
+            for (const auto& r : m_windows)
+            {
+                injectLatency(m_lookupLatencyUs);
+                windows.emplace_back(r.window, r.entry);
+            }
+            if (auto during = std::exchange(duringEnumerate, nullptr))
+                during();
+            return windows;
+        }
+
+        bool isWindow(Window window) const noexcept
+        {
+            return std::find(m_destroyed.begin(), m_destroyed.end(), window) == m_destroyed.end();
+        }
+
+        void post(std::function<void()> work)
+        {
+            m_posted.push_back(std::move(work));
+        }
+
+        // Runs the work posted so far; returns how many functions ran.
+        std::size_t runPosted()
+        {
+            auto posted = std::move(m_posted);
+            m_posted.clear();
+            for (auto& work : posted)
+            {
+                work();
+            }
+            return posted.size();
+        }
+    };
+
+    // Stand-in for ShellItemArrayNameSource producing deterministic pseudo-random names.
+    class SimulatedNameSource final : public ItemNameSource
+    {
+        const BenchmarkOptions& m_options;
+        unsigned m_fields;
+        std::uint32_t m_produced{};
+        std::mt19937 m_random{ 12345 };
+        std::uniform_int_distribution<std::uint32_t> m_length;
+        // Per slot of the last chunk, as a real source holds the strings of the chunk it returned.
+        std::vector<std::wstring> m_names;
+        std::vector<std::wstring> m_paths;
+        std::wstring m_folder;
+        std::uint32_t m_folderIndex{ UINT32_MAX };
+
+        std::wstring_view makeName(std::wstring_view prefix, std::wstring& name)
+        {
+            const auto length = m_length(m_random);
+            name.assign(prefix);
+            for (std::uint32_t i = 0; i < length; i++)
+            {
+                name.push_back(static_cast<wchar_t>(L'a' + m_random() % 26));
+            }
+            if (length > 4)
+                name[name.size() - 4] = L'.';
+            return name;
+        }
+
+        // C:\Bench\Level1\...\Folder<n>\, depth levels deep; item i lies in folder i * folders / items.
+        std::wstring_view folderOf(std::uint32_t item)
+        {
+            const auto index = static_cast<std::uint32_t>(static_cast<std::uint64_t>(item) * m_options.folders / std::max<std::uint32_t>(m_options.items, 1));
+            if (index != m_folderIndex)
+            {
+                m_folderIndex = index;
+                m_folder.assign(L"C:\\Bench\\"sv);
+                for (std::uint32_t level = 1; level < m_options.depth; level++)
+                {
+                    m_folder.append(L"Level"sv).append(std::to_wstring(level)).push_back(L'\\');
+                }
+                m_folder.append(L"Folder"sv).append(std::to_wstring(index)).push_back(L'\\');
+            }
+            return m_folder;
+        }
+
+    public:
+        SimulatedNameSource(const BenchmarkOptions& options, unsigned fields)
+            : m_options(options), m_fields(fields), m_length(options.minNameLength, options.maxNameLength)
+        {}
+
+        std::uint32_t count() override
+        {
+            return m_options.items;
+        }
+
+        std::uint32_t next(SelectionItem* items, std::uint32_t count) override
+        {
+            injectLatency(m_options.chunkLatencyUs);
+
+            count = std::min(count, m_options.items - m_produced);
+            if (m_names.size() < count)
+            {
+                m_names.resize(count);
+                m_paths.resize(count);
+            }
+            for (std::uint32_t i = 0; i < count; i++)
+            {
+                items[i] = {};
+                if (m_fields & IFF_NAME)
+                {
+                    items[i].name = makeName({}, m_names[i]);
+                    items[i].flags |= SIF_NAME;
+                }
+                if (m_fields & IFF_PATH)
+                {
+                    items[i].path = makeName(folderOf(m_produced + i), m_paths[i]);
+                    items[i].flags |= (m_fields & IFF_FILESYSPATH) ? SIF_PATH | SIF_FILESYSTEM : SIF_PATH;
+                }
+            }
+            m_produced += count;
+            return count;
+        }
+    };
+
+    struct SimulatedKeyEvent
+    {
+        std::uint8_t vk;
+        bool down;
+        std::uint32_t time; // milliseconds
+    };
+
+    // Deterministic typing for the chord engine: mostly plain letters, digits and spaces, some with Shift,
+    // a few with Ctrl, and a Ctrl+Shift+C now and then, 20 to 200 ms apart with a pause of a few seconds
+    // every 500 keys or so. Roughly count events.
+    inline std::vector<SimulatedKeyEvent> simulatedKeyStream(std::uint32_t count)
+    {
+        std::vector<SimulatedKeyEvent> events;
+        events.reserve(count + 6);
+        std::mt19937 random{ 54321 };
+        std::uint32_t time{};
+        auto event = [&](std::uint8_t vk, bool down) {
+            time += 20 + random() % 180;
+            events.push_back({ vk, down, time });
+        };
+        auto press = [&](std::uint8_t vk, auto&&... modifiers) {
+            (event(modifiers, true), ...);
+            event(vk, true);
+            event(vk, false);
+            (event(modifiers, false), ...);
+        };
+        constexpr std::uint8_t vkLShift = 0xA0;
+        constexpr std::uint8_t vkLControl = 0xA2;
+        while (events.size() < count)
+        {
+            const auto r = random() % 1000;
+            if (r % 500 == 499)
+                time += 2000 + random() % 5000;
+            const auto key = static_cast<std::uint8_t>(r % 37 == 36 ? ' ' : r % 37 < 26 ? 'A' + r % 37 : '0' + r % 37 - 26);
+            if (r < 2)
+                press('C', vkLControl, vkLShift);
+            else if (r < 20)
+                press(key, vkLControl);
+            else if (r < 80)
+                press(key, vkLShift);
+            else
+                press(key);
+        }
+        return events;
+    }
+
+    // A CFSTR_SHELLIDLIST block with options.items children, shaped like Explorer's: a two-level folder and one
+    // item per child, sized like a file system item with a name of the configured length. The bytes inside the
+    // items are filler; only the layout matters to the parser.
+    inline std::vector<char> simulatedCida(const BenchmarkOptions& options)
+    {
+        std::mt19937 random{ 6789 };
+        std::uniform_int_distribution<std::uint32_t> length{ options.minNameLength, options.maxNameLength };
+
+        const auto count = options.items;
+        std::vector<char> block((count + 2) * sizeof(std::uint32_t));
+        auto put32 = [&](std::size_t at, std::uint32_t value) { std::memcpy(block.data() + at, &value, sizeof(value)); };
+        auto appendItem = [&](std::size_t cb) {
+            const auto at = block.size();
+            block.resize(at + cb, '\x5A');
+            const auto size = static_cast<std::uint16_t>(cb);
+            std::memcpy(block.data() + at, &size, sizeof(size));
+        };
+        auto appendTerminator = [&] { block.resize(block.size() + sizeof(std::uint16_t), '\0'); };
+
+        put32(0, count);
+        put32(sizeof(std::uint32_t), static_cast<std::uint32_t>(block.size()));
+        appendItem(20);
+        appendItem(48);
+        appendTerminator();
+        for (std::uint32_t i = 0; i < count; i++)
+        {
+            put32((i + 2) * sizeof(std::uint32_t), static_cast<std::uint32_t>(block.size()));
+            appendItem(std::min<std::size_t>(64 + 2 * length(random), 0xFFFF));
+            appendTerminator();
+        }
+        return block;
+    }
+}
@@ -0,0 +1,221 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <memory>
+#include <numeric>
+#include <string_view>
+#include <utility>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cwctype>
+#endif
+
+#include "OutputFormat.hpp"
+
+namespace
+{
+    enum class SortMode : unsigned char
+    {
+        None,      // selection order, as Explorer returns it
+        Name,      // case-insensitive ordinal
+        Natural,   // case-insensitive, digit runs compared as numbers: "file2" < "file10"
+        Extension, // by extension, then naturally by name
+        Locale,    // the user's locale with digits as numbers, as Explorer sorts; keys come from the OS
+    };
+
+    namespace sort_detail
+    {
+#ifdef _WIN32
+        // The invariant upper case of every UTF-16 unit, mapped in one call the first time a name needs it.
+        // LCMapStringEx with LOCALE_NAME_INVARIANT is what the ordinal case-insensitive comparison of Windows
+        // folds with; towupper would not do, since the C locale of the CRT only maps ASCII.
+        inline const wchar_t* upperCaseTable() noexcept
+        {
+            static const auto table = [] {
+                auto units = std::make_unique<wchar_t[]>(0x10000);
+                auto upper = std::make_unique<wchar_t[]>(0x10000);
+                for (std::uint32_t c = 0; c < 0x10000; c++)
+                {
+                    units[c] = static_cast<wchar_t>(c);
+                    upper[c] = static_cast<wchar_t>(c);
+                }
+                // One to one: LCMAP_UPPERCASE never changes the length. Surrogates stay as they are, and are
+                // left out so that a lone half cannot fail the call. Should it fail anyway, names fold as ASCII.
+                for (auto [first, end] : { std::pair{ 0, 0xD800 }, std::pair{ 0xE000, 0x10000 } })
+                {
+                    LCMapStringEx(LOCALE_NAME_INVARIANT, LCMAP_UPPERCASE, units.get() + first, end - first,
+                        upper.get() + first, end - first, nullptr, nullptr, 0);
+                }
+                return upper;
+            }();
+            return table.get();
+        }
+#endif
+
+        // Folds to upper case, as the ordinal case-insensitive comparison of Windows does. Elsewhere the
+        // process locale has to know the characters: towupper maps only ASCII in the "C" locale.
+        inline wchar_t fold(wchar_t c) noexcept
+        {
+            if (c < 0x80)
+                return c >= L'a' && c <= L'z' ? static_cast<wchar_t>(c - (L'a' - L'A')) : c;
+#ifdef _WIN32
+            return upperCaseTable()[c];
+#else
+            return static_cast<wchar_t>(std::towupper(static_cast<std::wint_t>(c)));
+#endif
+        }
+
+        constexpr bool isDigit(wchar_t c) noexcept
+        {
+            return c >= L'0' && c <= L'9';
+        }
+
+        // Marks a digit run in a natural key. Below every printable character, so numbers sort before text.
+        constexpr wchar_t numberMark = 0x1;
+
+        inline void appendFolded(std::wstring_view text, std::vector<wchar_t>& key)
+        {
+            for (auto c : text)
+            {
+                key.push_back(fold(c));
+            }
+        }
+
+        // Each digit run becomes the mark, its length without leading zeros and the digits, so that comparing
+        // keys as plain strings compares the numbers by magnitude; the rest is folded.
+        inline void appendNatural(std::wstring_view text, std::vector<wchar_t>& key)
+        {
+            for (std::size_t i = 0; i < text.size();)
+            {
+                if (!isDigit(text[i]))
+                {
+                    key.push_back(fold(text[i++]));
+                    continue;
+                }
+
+                auto end = i;
+                while (end < text.size() && isDigit(text[end]))
+                {
+                    end++;
+                }
+                while (i + 1 < end && text[i] == L'0')
+                {
+                    i++;
+                }
+                key.push_back(numberMark);
+                key.push_back(static_cast<wchar_t>(std::min<std::size_t>(end - i, 0xFFFF)));
+                key.insert(key.end(), text.begin() + i, text.begin() + end);
+                i = end;
+            }
+        }
+    }
+
+    // Appends the sort key of text for the portable modes. Locale keys come from the OS and are built by the caller.
+    inline void appendSortKey(SortMode mode, std::wstring_view text, std::vector<wchar_t>& key)
+    {
+        using namespace sort_detail;
+
+        switch (mode)
+        {
+        case SortMode::Name:
+            appendFolded(text, key);
+            break;
+        case SortMode::Extension:
+        {
+            auto ext = text.substr(format_detail::extPos(text));
+            appendFolded(ext.substr(ext.empty() ? 0 : 1), key);
+            key.push_back(L'\0');
+            appendNatural(text, key);
+            break;
+        }
+        default:
+            appendNatural(text, key);
+            break;
+        }
+    }
+
+    // What an item is sorted by: the file name when the item has a path, the display name otherwise.
+    template <class Items>
+    std::wstring_view sortTextOf(const Items& items, std::size_t i) noexcept
+    {
+        auto leaf = format_detail::pathPartsOf(items, i).second;
+        return leaf.empty() ? items.name(i) : leaf;
+    }
+
+    // The order of count items sorted by precomputed keys: keyOf(i, key) appends the key of item i,
+    // once per item, and the sort compares the keys as plain strings. Ties keep the selection order.
+    // Keys are built and sorted in parallel once there is more than one chunk of items.
+    template <class KeyOf>
+    std::vector<std::uint32_t> sortedOrder(std::size_t count, std::size_t itemsPerChunk, KeyOf&& keyOf)
+    {
+        itemsPerChunk = std::max<std::size_t>(itemsPerChunk, 1);
+        const auto chunks = (count + itemsPerChunk - 1) / itemsPerChunk;
+
+        // One arena per chunk; keys are views into them, taken once the chunk is complete.
+        std::vector<std::vector<wchar_t>> arenas(chunks);
+        std::vector<std::wstring_view> keys(count);
+        auto buildChunk = [&](std::size_t c) {
+            const auto begin = c * itemsPerChunk;
+            const auto end = std::min(count, begin + itemsPerChunk);
+            std::vector<std::size_t> offsets(end - begin + 1);
+            auto& arena = arenas[c];
+            for (auto i = begin; i < end; i++)
+            {
+                offsets[i - begin] = arena.size();
+                keyOf(i, arena);
+            }
+            offsets[end - begin] = arena.size();
+            for (auto i = begin; i < end; i++)
+            {
+                keys[i] = { arena.data() + offsets[i - begin], offsets[i - begin + 1] - offsets[i - begin] };
+            }
+        };
+
+        std::vector<std::uint32_t> order(count);
+        std::iota(order.begin(), order.end(), std::uint32_t{ 0 });
+        auto less = [&](std::uint32_t a, std::uint32_t b) {
+            auto c = keys[a].compare(keys[b]);
+            return c < 0 || (c == 0 && a < b);
+        };
+
+        if (chunks <= 1)
+        {
+            if (chunks == 1)
+                buildChunk(0);
+            std::sort(order.begin(), order.end(), less);
+            return order;
+        }
+
+        std::vector<std::size_t> indices(chunks);
+        std::iota(indices.begin(), indices.end(), std::size_t{ 0 });
+        std::for_each(std::execution::par, indices.begin(), indices.end(), buildChunk);
+        std::sort(std::execution::par, order.begin(), order.end(), less);
+        return order;
+    }
+
+    // The Items interface of OutputFormat over other items in a given order.
+    template <class Items>
+    class SortedItems
+    {
+        const Items& m_items;
+        std::vector<std::uint32_t> m_order;
+
+    public:
+        SortedItems(const Items& items, std::vector<std::uint32_t> order) noexcept
+            : m_items(items), m_order(std::move(order))
+        {}
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_order.size(); }
+        [[nodiscard]] bool empty() const noexcept { return m_order.empty(); }
+        [[nodiscard]] std::wstring_view name(std::size_t i) const noexcept { return m_items.name(m_order[i]); }
+        [[nodiscard]] std::pair<std::wstring_view, std::wstring_view> pathParts(std::size_t i) const noexcept
+        {
+            return format_detail::pathPartsOf(m_items, m_order[i]);
+        }
+        [[nodiscard]] std::uint8_t flags(std::size_t i) const noexcept { return m_items.flags(m_order[i]); }
+    };
+}
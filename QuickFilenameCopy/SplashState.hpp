@@ -0,0 +1,125 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+namespace
+{
+    // Show/hide/retrigger logic and frame scheduling of the splash window, kept free of Win32 so that it can be
+    // reasoned about on its own. Times are milliseconds on any monotonic clock.
+    // A frame is rendered only on a state change: once when shown, and at most frameBudget - 1 more times while
+    // fading out. A copy therefore never costs more than frameBudget frames.
+    class SplashState
+    {
+    public:
+        enum class Action
+        {
+            None,       // nothing to do
+            Show,       // render at full opacity and show the window
+            Reposition, // already visible: move it and restart the countdown, no re-render
+            Fade,       // start the fade-out; pull frames with fadeFrame() every frameInterval()
+            Hide,       // hide the window, keeping it and its bitmap for the next copy
+        };
+
+    private:
+        enum class Phase
+        {
+            Hidden,
+            Visible,
+            Fading,
+        };
+
+        std::uint64_t m_visibleFor;
+        std::uint64_t m_fadeFor;
+        unsigned m_frameBudget;
+        std::uint64_t m_deadline{};
+        Phase m_phase{ Phase::Hidden };
+        unsigned m_frames{};
+        std::uint8_t m_alpha{};
+
+    public:
+        explicit SplashState(std::uint64_t visibleFor, std::uint64_t fadeFor = 0, unsigned frameBudget = 1) noexcept
+            : m_visibleFor(visibleFor), m_fadeFor(fadeFor), m_frameBudget(std::max(frameBudget, 1u))
+        {}
+
+        [[nodiscard]] bool visible() const noexcept { return m_phase != Phase::Hidden; }
+        [[nodiscard]] bool fading() const noexcept { return m_phase == Phase::Fading; }
+        [[nodiscard]] std::uint64_t deadline() const noexcept { return m_deadline; }
+        [[nodiscard]] unsigned framesRendered() const noexcept { return m_frames; }
+
+        // A copy completed. Rapid retriggers while visible only push the deadline out;
+        // a retrigger during the fade-out renders the window opaque again.
+        Action trigger(std::uint64_t now) noexcept
+        {
+            m_deadline = now + m_visibleFor;
+            if (m_phase == Phase::Visible)
+                return Action::Reposition;
+
+            m_phase = Phase::Visible;
+            m_frames = 1;
+            m_alpha = 255;
+            return Action::Show;
+        }
+
+        // The countdown timer fired. Returns None if a retrigger moved the deadline in the meantime
+        // or the fade-out is still running.
+        Action expire(std::uint64_t now) noexcept
+        {
+            switch (m_phase)
+            {
+            case Phase::Visible:
+                if (now < m_deadline)
+                    return Action::None;
+                if (m_fadeFor != 0 && m_frames < m_frameBudget)
+                {
+                    m_phase = Phase::Fading;
+                    return Action::Fade;
+                }
+                break;
+            case Phase::Fading:
+                if (now < m_deadline + m_fadeFor)
+                    return Action::None;
+                break;
+            case Phase::Hidden:
+                return Action::None;
+            }
+            m_phase = Phase::Hidden;
+            return Action::Hide;
+        }
+
+        // The user clicked the splash away.
+        Action dismiss() noexcept
+        {
+            if (m_phase == Phase::Hidden)
+                return Action::None;
+
+            m_phase = Phase::Hidden;
+            return Action::Hide;
+        }
+
+        // Opacity of the fade-out frame that will be presented at the given time,
+        // or nullopt if the frame would not change anything or the budget is spent.
+        std::optional<std::uint8_t> fadeFrame(std::uint64_t presentAt) noexcept
+        {
+            if (m_phase != Phase::Fading || m_frames >= m_frameBudget)
+                return std::nullopt;
+
+            auto elapsed = presentAt > m_deadline ? presentAt - m_deadline : 0;
+            auto alpha = elapsed >= m_fadeFor ? 0 : static_cast<std::uint8_t>(255 - 255 * elapsed / m_fadeFor);
+            if (alpha == m_alpha)
+                return std::nullopt;
+
+            m_alpha = alpha;
+            m_frames++;
+            return alpha;
+        }
+
+        // Spacing of fade-out frames: spread the remaining budget over the fade, but never faster than the display.
+        [[nodiscard]]
+        std::uint64_t frameInterval(std::uint64_t refreshPeriod) const noexcept
+        {
+            auto frames = m_frameBudget > 1 ? m_frameBudget - 1 : 1;
+            return std::max<std::uint64_t>({ refreshPeriod, (m_fadeFor + frames - 1) / frames, 1 });
+        }
+    };
+}
@@ -1,52 +1,209 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <windows.h>
+#include <dwmapi.h>
 #include <wil/resource.h>
 
+#include "SplashState.hpp"
 
 namespace
 {
     using namespace std::string_literals;
     using namespace std::string_view_literals;
 
+    // Millisecond clock on QueryPerformanceCounter, the time base of DWM composition timing.
+    class CompositionClock
+    {
+        LARGE_INTEGER m_frequency{};
+
+        std::uint64_t toMs(std::uint64_t qpc) const noexcept
+        {
+            return qpc * 1000 / static_cast<std::uint64_t>(m_frequency.QuadPart);
+        }
+
+    public:
+        CompositionClock() noexcept
+        {
+            QueryPerformanceFrequency(&m_frequency);
+        }
+
+        std::uint64_t now() const noexcept
+        {
+            LARGE_INTEGER qpc{};
+            QueryPerformanceCounter(&qpc);
+            return toMs(static_cast<std::uint64_t>(qpc.QuadPart));
+        }
+
+        // When a frame submitted now reaches the screen and the display refresh period.
+        // Falls back to (now, 0) when composition timing is unavailable.
+        std::pair<std::uint64_t, std::uint64_t> nextPresent() const noexcept
+        {
+            LARGE_INTEGER qpc{};
+            QueryPerformanceCounter(&qpc);
+            const auto now = static_cast<std::uint64_t>(qpc.QuadPart);
+
+            DWM_TIMING_INFO info{ sizeof(info) };
+            if (FAILED(DwmGetCompositionTimingInfo(nullptr, &info)) || info.qpcRefreshPeriod == 0)
+                return { toMs(now), 0 };
+
+            auto vblank = info.qpcVBlank;
+            if (vblank < now)
+                vblank += ((now - vblank) / info.qpcRefreshPeriod + 1) * info.qpcRefreshPeriod;
+            return { toMs(vblank), toMs(info.qpcRefreshPeriod) };
+        }
+    };
+
+    // A layered popup created once at startup. The "Copied!" image is rendered into a cached DIB once
+    // and handed to UpdateLayeredWindow; showing it again only moves the window and restarts the countdown.
+    // Nothing runs between copies: the only timer is the countdown, plus fade-out frames if enabled.
     class SplashWiindow
     {
-        constexpr POINT centerOfRect(RECT rect)
+        static constexpr POINT centerOfRect(RECT rect)
         {
             return { rect.left + (rect.right - rect.left) / 2, rect.top + (rect.bottom - rect.top) / 2 };
         }
         static constexpr auto szWindowClassSplash = L"{D62A344C-F05F-44CD-BDA8-37038EF1E191}";
+        static constexpr SIZE size{ 400, 400 };
+        static constexpr UINT visibleMs = 500;
+        static constexpr UINT_PTR timerId = 1;
 
         static SplashWiindow* getSelf(HWND hWnd)
         {
             return (SplashWiindow*)GetWindowLongPtr(hWnd, GWLP_USERDATA);
         }
 
-        void onPaint(wil::unique_hdc_paint hdc) noexcept
+        HWND m_hWnd{};
+        SplashState m_state{ visibleMs };
+        CompositionClock m_clock;
+        wil::unique_hfont m_hfont;
+        wil::unique_hbitmap m_bitmap;
+        wil::unique_hdc m_hdcBitmap; // declared after m_bitmap so that it is deleted while the bitmap is still selected
+
+        void render()
         {
-            RECT rect{};
-            GetClientRect(m_hWnd, &rect);
+            wil::unique_hdc_window hdcScreen{ GetDC(nullptr) };
+            THROW_LAST_ERROR_IF_NULL(hdcScreen);
+
+            m_hdcBitmap.reset(CreateCompatibleDC(hdcScreen.get()));
+            THROW_LAST_ERROR_IF_NULL(m_hdcBitmap);
+
+            BITMAPINFO bmi{};
+            bmi.bmiHeader.biSize = sizeof(bmi.bmiHeader);
+            bmi.bmiHeader.biWidth = size.cx;
+            bmi.bmiHeader.biHeight = -size.cy;
+            bmi.bmiHeader.biPlanes = 1;
+            bmi.bmiHeader.biBitCount = 32;
+            bmi.bmiHeader.biCompression = BI_RGB;
+            void* bits{};
+            m_bitmap.reset(CreateDIBSection(hdcScreen.get(), &bmi, DIB_RGB_COLORS, &bits, nullptr, 0));
+            THROW_LAST_ERROR_IF_NULL(m_bitmap);
+            SelectObject(m_hdcBitmap.get(), m_bitmap.get());
 
-            FillRect(hdc.get(), &rect, (HBRUSH)GetStockObject(GRAY_BRUSH));
-            SetBkMode(hdc.get(), TRANSPARENT);
+            m_hfont.reset(CreateFont(40, 20, 0,
+                FW_BOLD, FALSE, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, PROOF_QUALITY, DEFAULT_PITCH, nullptr));
 
-            COLORREF bk_color = GetTextColor(hdc.get());
-            auto textColor{ wil::scope_exit([&] { (void)SetTextColor(hdc.get(), bk_color); }) };
-            SetTextColor(hdc.get(), RGB(255, 255, 255));
+            HDC hdc = m_hdcBitmap.get();
+            RECT rect{ 0, 0, size.cx, size.cy };
+            FillRect(hdc, &rect, (HBRUSH)GetStockObject(GRAY_BRUSH));
+            SetBkMode(hdc, TRANSPARENT);
+            SetTextColor(hdc, RGB(255, 255, 255));
 
-            auto hFontOld{ SelectObject(hdc.get(), m_hfont.get()) };
-            auto font{ wil::scope_exit([&] { (void)SelectObject(hdc.get(), hFontOld); }) };
-            DrawText(hdc.get(), L"Copied!", -1, &rect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
+            auto hFontOld{ SelectObject(hdc, m_hfont.get()) };
+            auto font{ wil::scope_exit([&] { (void)SelectObject(hdc, hFontOld); }) };
+            DrawText(hdc, L"Copied!", -1, &rect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
+            GdiFlush();
         }
 
-        HWND m_hWnd{};
-        UINT_PTR m_nRedrawTimerId{};
-        UINT_PTR m_nCloseTimerId{};
-        wil::unique_hfont m_hfont;
+        static POINT position() noexcept
+        {
+            POINT center{};
+            POINT pos{};
+            if (GetCursorPos(&pos)) {
+                auto hMonitor = MonitorFromPoint(pos, MONITOR_DEFAULTTONEAREST);
+                MONITORINFO mi{
+                    DESIGNATED_INIT(.cbSize =) sizeof(mi),
+                };
+
+                if (GetMonitorInfo(hMonitor, &mi)) {
+                    center = centerOfRect(mi.rcWork);
+                }
+            }
+            return { center.x - size.cx / 2, center.y - size.cy / 2 };
+        }
+
+        void setTimer(std::uint64_t ms) noexcept
+        {
+            SetTimer(m_hWnd, timerId, static_cast<UINT>(std::max<std::uint64_t>(ms, USER_TIMER_MINIMUM)), nullptr);
+        }
+
+        void apply(SplashState::Action action)
+        {
+            switch (action)
+            {
+            case SplashState::Action::Show:
+            {
+                // The bitmap ignores per-pixel alpha (GDI text leaves it at zero), so blend with a constant alpha.
+                POINT dst{ position() };
+                POINT src{};
+                SIZE sz{ size };
+                BLENDFUNCTION blend{ AC_SRC_OVER, 0, 255, 0 };
+                THROW_IF_WIN32_BOOL_FALSE(UpdateLayeredWindow(m_hWnd, nullptr, &dst, &sz, m_hdcBitmap.get(), &src, 0, &blend, ULW_ALPHA));
+                ShowWindow(m_hWnd, SW_SHOWNOACTIVATE);
+                setTimer(visibleMs);
+                break;
+            }
+            case SplashState::Action::Reposition:
+            {
+                POINT dst{ position() };
+                SetWindowPos(m_hWnd, HWND_TOPMOST, dst.x, dst.y, 0, 0, SWP_NOSIZE | SWP_NOACTIVATE);
+                setTimer(visibleMs);
+                break;
+            }
+            case SplashState::Action::Fade:
+                setTimer(m_state.frameInterval(m_clock.nextPresent().second));
+                break;
+            case SplashState::Action::Hide:
+                KillTimer(m_hWnd, timerId);
+                ShowWindow(m_hWnd, SW_HIDE);
+                break;
+            case SplashState::Action::None:
+                break;
+            }
+        }
+
+        // Changes only the constant alpha; the cached image and position stay as they are.
+        void present(std::uint8_t alpha) noexcept
+        {
+            BLENDFUNCTION blend{ AC_SRC_OVER, 0, alpha, 0 };
+            LOG_IF_WIN32_BOOL_FALSE(UpdateLayeredWindow(m_hWnd, nullptr, nullptr, nullptr, nullptr, nullptr, 0, &blend, ULW_ALPHA));
+        }
+
+        void onTimer()
+        {
+            const auto now = m_clock.now();
+            if (m_state.fading())
+            {
+                if (auto alpha = m_state.fadeFrame(m_clock.nextPresent().first))
+                    present(*alpha);
+            }
+            else if (m_state.visible() && now < m_state.deadline())
+            {
+                // Retriggered since the timer was set.
+                setTimer(m_state.deadline() - now);
+                return;
+            }
+            apply(m_state.expire(now));
+        }
 
         static LRESULT CALLBACK wndProcSplash(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) noexcept
         {
-            my::DbgPrint(__FUNCTIONW__ L"(hWnd={:p}, {})\n", (void*)hWnd, DebugPrintWndProc(message, wParam, lParam));
+#if QFC_TRACE_LEVEL >= 2
+            wchar_t messageText[256];
+            my::DbgPrint(__FUNCTIONW__ L"(hWnd={:p}, {})\n", (void*)hWnd, DebugPrintWndProc(messageText, message, wParam, lParam));
+#endif
 
             switch (message)
             {
@@ -54,34 +211,23 @@ namespace
                 SetWindowLongPtr(hWnd, GWLP_USERDATA, LONG_PTR(((LPCREATESTRUCT)lParam)->lpCreateParams));
                 getSelf(hWnd)->m_hWnd = hWnd;
                 return DefWindowProc(hWnd, message, wParam, lParam);
-            case WM_CREATE:
-                getSelf(hWnd)->m_nRedrawTimerId = SetTimer(hWnd, 1, USER_TIMER_MINIMUM, nullptr);
-                getSelf(hWnd)->m_nCloseTimerId = SetTimer(hWnd, 2, 500, nullptr);
+            case WM_LBUTTONDOWN:
+                try
                 {
-                    auto hFont = CreateFont(40, 20, 0,
-                        FW_BOLD, FALSE, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_DEFAULT_PRECIS, CLIP_DEFAULT_PRECIS, PROOF_QUALITY, DEFAULT_PITCH, nullptr);
-                    getSelf(hWnd)->m_hfont.reset(hFont);
+                    getSelf(hWnd)->apply(getSelf(hWnd)->m_state.dismiss());
                 }
-
-                return DefWindowProcW(hWnd, message, wParam, lParam);
-            case WM_LBUTTONDOWN:
-                DestroyWindow(hWnd);
-                break;
-            case WM_PAINT:
-                getSelf(hWnd)->onPaint(wil::BeginPaint(hWnd));
+                CATCH_LOG();
                 break;
-            case WM_ERASEBKGND:
-                return TRUE;
             case WM_TIMER:
-                if (wParam == getSelf(hWnd)->m_nCloseTimerId)
+                if (wParam == timerId)
                 {
-                    DestroyWindow(hWnd);
+                    try
+                    {
+                        getSelf(hWnd)->onTimer();
+                    }
+                    CATCH_LOG();
                 }
                 break;
-            case WM_DESTROY:
-                KillTimer(hWnd, getSelf(hWnd)->m_nRedrawTimerId);
-                KillTimer(hWnd, getSelf(hWnd)->m_nCloseTimerId);
-                return DefWindowProc(hWnd, message, wParam, lParam);
             case WM_NCDESTROY:
                 getSelf(hWnd)->m_hWnd = nullptr;
                 return DefWindowProc(hWnd, message, wParam, lParam);
@@ -96,17 +242,17 @@ namespace
         [[nodiscard]]
         static WNDCLASSEXW wndClass() noexcept
         {
-            
+
             WNDCLASSEXW wndClassSplash{
                 DESIGNATED_INIT(.cbSize =) sizeof(wndClassSplash),
-                DESIGNATED_INIT(.style =) CS_HREDRAW | CS_VREDRAW,
+                DESIGNATED_INIT(.style =) 0,
                 DESIGNATED_INIT(.lpfnWndProc =) &wndProcSplash,
                 DESIGNATED_INIT(.cbClsExtra =) 0,
                 DESIGNATED_INIT(.cbWndExtra =) 0,
                 DESIGNATED_INIT(.hInstance =) getHinstance(),
                 DESIGNATED_INIT(.hIcon =) nullptr,
                 DESIGNATED_INIT(.hCursor =) nullptr,
-                DESIGNATED_INIT(.hbrBackground =) (HBRUSH)(COLOR_3DSHADOW),
+                DESIGNATED_INIT(.hbrBackground =) nullptr,
                 DESIGNATED_INIT(.lpszMenuName =) nullptr,
                 DESIGNATED_INIT(.lpszClassName =) szWindowClassSplash,
             };
@@ -122,43 +268,36 @@ namespace
             }
         }
 
-        void show(HINSTANCE hInstance, std::wstring_view g_szTitle)
+        // Creates the hidden window and renders its image. Call once at startup after registering wndClass().
+        // fadeMs of 0 hides the splash in one step; otherwise at most frameBudget frames are rendered per copy.
+        void create(HINSTANCE hInstance, std::wstring_view g_szTitle, UINT fadeMs, UINT frameBudget)
         {
             TRACE();
 
-            if (m_hWnd != nullptr)
-                close();
-
-            POINT center{ CW_USEDEFAULT , CW_USEDEFAULT };
-            {
-                POINT pos{};
-                if (GetCursorPos(&pos)) {
-                    auto hMonitor = MonitorFromPoint(pos, MONITOR_DEFAULTTONEAREST);
-                    MONITORINFO mi{
-                        DESIGNATED_INIT(.cbSize =) sizeof(mi),
-                    };
-
-                    if (GetMonitorInfo(hMonitor, &mi)) {
-                        center = centerOfRect(mi.rcWork);
-                    }
-                }
-            }
-
-            const int width = 400;
-            const int height = 400;
+            m_state = SplashState{ visibleMs, fadeMs, frameBudget };
+            render();
 
             HWND hWnd = CreateWindowEx(
-                WS_EX_NOACTIVATE | WS_EX_COMPOSITED | WS_EX_LAYERED | WS_EX_TOPMOST,
-                szWindowClassSplash, g_szTitle.data(), WS_POPUP | WS_VISIBLE,
-                center.x - width / 2, center.y - height / 2,
-                width, height, nullptr, nullptr, hInstance, this);
+                WS_EX_NOACTIVATE | WS_EX_LAYERED | WS_EX_TOPMOST | WS_EX_TOOLWINDOW,
+                szWindowClassSplash, g_szTitle.data(), WS_POPUP,
+                0, 0, size.cx, size.cy, nullptr, nullptr, hInstance, this);
             THROW_LAST_ERROR_IF_NULL(hWnd);
         }
 
-        void close()
+        void show()
+        {
+            TRACE();
+
+            if (m_hWnd == nullptr)
+                return;
+
+            apply(m_state.trigger(m_clock.now()));
+        }
+
+        void destroy()
         {
             if (m_hWnd != nullptr)
                 DestroyWindow(m_hWnd);
         }
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace
+{
+    // Bounded lock-free queue for exactly one producer thread and one consumer thread.
+    // Neither side ever blocks: try_push fails when full and try_pop fails when empty.
+    template <class T, std::size_t Capacity>
+    class SpscQueue
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        static_assert(std::is_trivially_copyable<T>::value, "T is copied in and out of the ring");
+
+        static constexpr std::size_t cacheLineSize = 64;
+
+        alignas(cacheLineSize) std::atomic<std::size_t> m_head{ 0 }; // next slot to pop, owned by the consumer
+        alignas(cacheLineSize) std::atomic<std::size_t> m_tail{ 0 }; // next slot to push, owned by the producer
+        alignas(cacheLineSize) std::array<T, Capacity> m_items{};
+
+    public:
+        [[nodiscard]]
+        bool try_push(const T& item) noexcept
+        {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+                return false;
+
+            m_items[tail & (Capacity - 1)] = item;
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        [[nodiscard]]
+        bool try_pop(T& item) noexcept
+        {
+            const auto head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire))
+                return false;
+
+            item = m_items[head & (Capacity - 1)];
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept
+        {
+            return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+        }
+
+        static constexpr std::size_t capacity() noexcept
+        {
+            return Capacity;
+        }
+    };
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <version>
+
+// std::format where the standard library has it; {fmt}, which it is modeled on, elsewhere
+// (C++17, or a libstdc++ older than GCC 13 on the portable builds).
+#if __cpp_lib_format
+#include <format>
+#else
+#ifndef FMT_HEADER_ONLY
+#define FMT_HEADER_ONLY
+#endif
+#include "fmt/format.h"
+#if __has_include("fmt/xchar.h")
+#include "fmt/xchar.h" // wide strings moved here in fmt 8
+#endif
+
+namespace std {
+    using namespace ::fmt;
+}
+#endif
@@ -0,0 +1,289 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "SpscQueue.hpp"
+#include "StdFormat.hpp"
+
+// 0: tracing compiled out, 1: DBGPRINTLN events, 2: also TRACE() function entries.
+#ifndef QFC_TRACE_LEVEL
+#ifdef _DEBUG
+#define QFC_TRACE_LEVEL 2
+#else
+#define QFC_TRACE_LEVEL 0
+#endif
+#endif
+
+namespace
+{
+    // Static description of a trace call site. Records only point at it.
+    struct TraceSite
+    {
+        const char* file;
+        int line;
+        const char* function;
+        const char* format;
+    };
+
+    // Every trace argument is stored, and formatted, as a 64-bit integer.
+    template <class T>
+    using TraceArg = std::uint64_t;
+
+    // The format string of a trace call, checked at compile time against its arguments where the format
+    // library can (P2216); elsewhere a bad format string is reported in the trace instead of the message.
+#if defined(__cpp_lib_format) && __cpp_lib_format >= 202106L
+    template <class... T>
+    using TraceFormat = std::format_string<TraceArg<T>...>;
+#elif defined(FMT_VERSION) && FMT_VERSION >= 80000
+    template <class... T>
+    using TraceFormat = fmt::format_string<TraceArg<T>...>;
+#else
+    template <class... T>
+    using TraceFormat = const char*;
+#endif
+
+    struct TraceRecord
+    {
+        std::int64_t timestamp; // steady clock, in nanoseconds
+        const TraceSite* site;
+        std::uint64_t args[4];
+        std::uint8_t argCount;
+    };
+
+    // Fixed-size binary trace records collected in per-thread lock-free rings.
+    // Formatting is deferred to a background flusher, so a record costs a clock read and a few stores.
+    class TraceLog
+    {
+        using Ring = SpscQueue<TraceRecord, 1024>;
+
+        struct ThreadRing
+        {
+            Ring ring;
+            std::atomic<std::uint32_t> dropped{ 0 };
+        };
+
+        std::mutex m_mutex;
+        std::vector<std::shared_ptr<ThreadRing>> m_rings;
+        std::condition_variable m_cv;
+        bool m_stopping{ false };
+        std::thread m_flusher;
+        std::function<void(const std::string&)> m_sink;
+        std::int64_t m_origin{}; // timestamps are written relative to start()
+        // Records of threads whose ring could not be allocated.
+        std::atomic<std::uint32_t> m_lost{ 0 };
+
+        static std::int64_t now() noexcept
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // The calling thread's ring, registered with the log; nullptr if it could not be allocated.
+        // The log keeps the ring alive after the thread exits, so the flusher can still drain it.
+        ThreadRing* attachThread() noexcept
+        {
+            try
+            {
+                auto ring = std::make_shared<ThreadRing>();
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_rings.push_back(ring);
+                return ring.get();
+            }
+            catch (...)
+            {
+                return nullptr;
+            }
+        }
+
+        static ThreadRing* threadRing() noexcept
+        {
+            thread_local ThreadRing* ring = instance().attachThread();
+            return ring;
+        }
+
+        template <class T>
+        static std::uint64_t toArg(const T& value) noexcept
+        {
+            if constexpr (std::is_pointer<T>::value)
+                return reinterpret_cast<std::uintptr_t>(value);
+            else if constexpr (std::is_enum<T>::value)
+                return static_cast<std::uint64_t>(static_cast<std::underlying_type_t<T>>(value));
+            else
+            {
+                static_assert(std::is_integral<T>::value, "trace arguments must be integers, enums or pointers");
+                return static_cast<std::uint64_t>(value);
+            }
+        }
+
+        static std::string message(const TraceRecord& r)
+        {
+            const auto& a = r.args;
+            try
+            {
+                switch (r.argCount)
+                {
+                case 0: return r.site->format;
+                case 1: return std::vformat(r.site->format, std::make_format_args(a[0]));
+                case 2: return std::vformat(r.site->format, std::make_format_args(a[0], a[1]));
+                case 3: return std::vformat(r.site->format, std::make_format_args(a[0], a[1], a[2]));
+                default: return std::vformat(r.site->format, std::make_format_args(a[0], a[1], a[2], a[3]));
+                }
+            }
+            catch (const std::exception& e)
+            {
+                return std::format("bad trace format \"{}\": {}", r.site->format, e.what());
+            }
+        }
+
+        // "file(line): [µs since start] function: message"
+        std::string format(const TraceRecord& r) const
+        {
+            return std::format("{}({}): [{:.1f}us] {}: {}\n", r.site->file, r.site->line,
+                static_cast<double>(r.timestamp - m_origin) / 1000.0, r.site->function, message(r));
+        }
+
+        void drain()
+        {
+            std::vector<std::shared_ptr<ThreadRing>> rings;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                rings = m_rings;
+            }
+
+            // Nothing may escape the flusher thread: that would end the process.
+            for (auto& ring : rings)
+            {
+                TraceRecord record{};
+                while (ring->ring.try_pop(record))
+                {
+                    try
+                    {
+                        m_sink(format(record));
+                    }
+                    catch (...)
+                    {
+                    }
+                }
+                if (auto dropped = ring->dropped.exchange(0))
+                {
+                    try
+                    {
+                        m_sink(std::format("trace: {} records dropped\n", dropped));
+                    }
+                    catch (...)
+                    {
+                    }
+                }
+            }
+            if (auto lost = m_lost.exchange(0))
+            {
+                try
+                {
+                    m_sink(std::format("trace: {} records lost, no ring for their thread\n", lost));
+                }
+                catch (...)
+                {
+                }
+            }
+        }
+
+    public:
+        ~TraceLog() noexcept
+        {
+            stop();
+        }
+
+        static TraceLog& instance() noexcept
+        {
+            static TraceLog log;
+            return log;
+        }
+
+        // Allocates the calling thread's ring ahead of its first record, for threads that must not allocate later.
+        static void prepareThread() noexcept
+        {
+            threadRing();
+        }
+
+        // format is site.format, passed again to be checked against the arguments; QFC_TRACE_RECORD does both.
+        template <class... T>
+        static void record(const TraceSite& site, TraceFormat<T...> format, const T&... args) noexcept
+        {
+            static_assert(sizeof...(T) <= 4, "at most four trace arguments");
+            (void)format;
+
+            TraceRecord r{ now(), &site, { toArg(args)... }, sizeof...(T) };
+            auto* ring = threadRing();
+            if (ring == nullptr)
+                instance().m_lost.fetch_add(1, std::memory_order_relaxed);
+            else if (!ring->ring.try_push(r))
+                ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void start(std::function<void(const std::string&)> sink)
+        {
+            m_sink = std::move(sink);
+            m_origin = now();
+            m_stopping = false;
+            m_flusher = std::thread([this] {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (!m_stopping)
+                {
+                    m_cv.wait_for(lock, std::chrono::milliseconds(50));
+                    lock.unlock();
+                    drain();
+                    lock.lock();
+                }
+            });
+        }
+
+        void stop()
+        {
+            if (!m_flusher.joinable())
+                return;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_cv.notify_all();
+            m_flusher.join();
+            drain();
+        }
+    };
+}
+
+// ", args" or nothing when there are no arguments.
+#if defined(_MSC_VER) && (!defined(_MSVC_TRADITIONAL) || _MSVC_TRADITIONAL)
+#define QFC_TRACE_ARGS(...) , __VA_ARGS__
+#else
+#define QFC_TRACE_ARGS(...) __VA_OPT__(, ) __VA_ARGS__
+#endif
+
+#define QFC_TRACE_RECORD(fmt, ...)                                                          \
+    do                                                                                      \
+    {                                                                                       \
+        static constexpr TraceSite traceSite_{ __FILE__, __LINE__, __FUNCTION__, fmt };     \
+        TraceLog::record(traceSite_, fmt QFC_TRACE_ARGS(__VA_ARGS__));                      \
+    } while (0)
+
+#if QFC_TRACE_LEVEL >= 2
+#define TRACE() QFC_TRACE_RECORD("enter")
+#else
+#define TRACE() ((void)0)
+#endif
+
+#if QFC_TRACE_LEVEL >= 1
+#define DBGPRINTLN(fmt, ...) QFC_TRACE_RECORD(fmt, __VA_ARGS__)
+#else
+#define DBGPRINTLN(fmt, ...) ((void)0)
+#endif
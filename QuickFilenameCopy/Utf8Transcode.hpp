@@ -0,0 +1,223 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define UTF8_TRANSCODE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // UTF-16 to UTF-8 in two passes over the text: utf8Length() sizes the destination exactly, then
+    // writeUtf8() fills it without bounds checks. Surrogate pairs become one 4-byte sequence; unpaired
+    // surrogates become U+FFFD. Blocks of 8 units below U+0800 are handled with SSE2: ASCII, which is most of
+    // a path list, is narrowed with one pack, and Latin, Greek, Cyrillic, Hebrew and Arabic get both bytes of
+    // each unit built at once. Blocks with anything from U+0800 up go through the scalar code.
+    namespace utf8_detail
+    {
+        constexpr bool isHighSurrogate(std::uint32_t c) noexcept { return c >= 0xD800 && c < 0xDC00; }
+        constexpr bool isLowSurrogate(std::uint32_t c) noexcept { return c >= 0xDC00 && c < 0xE000; }
+
+        // Reads the code point at s[i] and advances i past it.
+        template <class Char>
+        std::uint32_t nextCodePoint(const Char* s, std::size_t n, std::size_t& i) noexcept
+        {
+            auto c = static_cast<std::uint32_t>(s[i++]);
+            if (c < 0xD800 || c >= 0xE000)
+                return c; // a 32-bit wchar_t may hold a code point above U+FFFF directly
+            if (isHighSurrogate(c) && i < n && isLowSurrogate(static_cast<std::uint32_t>(s[i])))
+                return 0x10000 + ((c - 0xD800) << 10) + (static_cast<std::uint32_t>(s[i++]) - 0xDC00);
+            return 0xFFFD;
+        }
+
+        constexpr std::size_t lengthOf(std::uint32_t c) noexcept
+        {
+            return c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+        }
+
+        inline char* put(std::uint32_t c, char* dest) noexcept
+        {
+            if (c < 0x80)
+            {
+                *dest++ = static_cast<char>(c);
+            }
+            else if (c < 0x800)
+            {
+                *dest++ = static_cast<char>(0xC0 | (c >> 6));
+                *dest++ = static_cast<char>(0x80 | (c & 0x3F));
+            }
+            else if (c < 0x10000)
+            {
+                *dest++ = static_cast<char>(0xE0 | (c >> 12));
+                *dest++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                *dest++ = static_cast<char>(0x80 | (c & 0x3F));
+            }
+            else
+            {
+                *dest++ = static_cast<char>(0xF0 | (c >> 18));
+                *dest++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+                *dest++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                *dest++ = static_cast<char>(0x80 | (c & 0x3F));
+            }
+            return dest;
+        }
+
+        template <class Char>
+        std::size_t lengthScalar(const Char* s, std::size_t n) noexcept
+        {
+            std::size_t cb = 0;
+            for (std::size_t i = 0; i < n;)
+            {
+                cb += lengthOf(nextCodePoint(s, n, i));
+            }
+            return cb;
+        }
+
+        template <class Char>
+        char* writeScalar(const Char* s, std::size_t n, char* dest) noexcept
+        {
+            for (std::size_t i = 0; i < n;)
+            {
+                dest = put(nextCodePoint(s, n, i), dest);
+            }
+            return dest;
+        }
+
+#if UTF8_TRANSCODE_SSE2
+        // Char must be a 16-bit code unit: wchar_t on Windows, char16_t elsewhere.
+        // A block without surrogates needs 1 byte per unit, plus 1 from U+0080 and another from U+0800;
+        // a block with surrogates is counted code point by code point, and may end one unit late.
+        template <class Char>
+        std::size_t lengthSse2(const Char* s, std::size_t n) noexcept
+        {
+            static_assert(sizeof(Char) == 2);
+            const auto bias = _mm_set1_epi16(static_cast<short>(0x8000));
+            const auto above7F = _mm_set1_epi16(static_cast<short>(0x8000 + 0x7F));
+            const auto above7FF = _mm_set1_epi16(static_cast<short>(0x8000 + 0x7FF));
+            const auto surrogateMask = _mm_set1_epi16(static_cast<short>(0xF800));
+            const auto surrogate = _mm_set1_epi16(static_cast<short>(0xD800));
+
+            std::size_t cb = 0;
+            std::size_t i = 0;
+            while (i + 8 <= n)
+            {
+                auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, surrogateMask), surrogate)) != 0)
+                {
+                    for (const auto end = i + 8; i < end;)
+                    {
+                        cb += lengthOf(nextCodePoint(s, n, i));
+                    }
+                    continue;
+                }
+
+                auto biased = _mm_xor_si128(v, bias);
+                auto twoOrMore = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi16(biased, above7F)));
+                auto three = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi16(biased, above7FF)));
+                cb += 8 + (std::popcount(twoOrMore) + std::popcount(three)) / 2;
+                i += 8;
+            }
+            return cb + lengthScalar(s + i, n - i);
+        }
+
+        template <class Char>
+        char* writeSse2(const Char* s, std::size_t n, char* dest) noexcept
+        {
+            static_assert(sizeof(Char) == 2);
+            const auto nonAscii = _mm_set1_epi16(static_cast<short>(0xFF80));
+            const auto threeBytes = _mm_set1_epi16(static_cast<short>(0xF800));
+            const auto lowSix = _mm_set1_epi16(0x3F);
+            const auto leadTag = _mm_set1_epi16(0xC0);
+            const auto continuationTag = _mm_set1_epi16(0x80);
+
+            std::size_t i = 0;
+            while (i + 8 <= n)
+            {
+                auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+                auto ascii = _mm_cmpeq_epi16(_mm_and_si128(v, nonAscii), _mm_setzero_si128());
+                const auto asciiMask = static_cast<unsigned>(_mm_movemask_epi8(ascii));
+                if (asciiMask == 0xFFFF)
+                {
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(v, v));
+                    dest += 8;
+                    i += 8;
+                    continue;
+                }
+
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, threeBytes), _mm_setzero_si128())) == 0xFFFF)
+                {
+                    // 110xxxxx 10xxxxxx as one little-endian word per unit; ASCII units keep their own byte.
+                    auto lead = _mm_or_si128(_mm_srli_epi16(v, 6), leadTag);
+                    auto continuation = _mm_slli_epi16(_mm_or_si128(_mm_and_si128(v, lowSix), continuationTag), 8);
+                    auto words = _mm_or_si128(_mm_and_si128(ascii, v), _mm_andnot_si128(ascii, _mm_or_si128(lead, continuation)));
+                    if (asciiMask == 0)
+                    {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), words);
+                        dest += 16;
+                        i += 8;
+                        continue;
+                    }
+
+                    // Mixed: every unit stores a whole word and advances by its length, so the spare byte of an
+                    // ASCII unit is overwritten by the next unit. The last one stores only what it owns.
+                    alignas(16) std::uint16_t units[8];
+                    _mm_store_si128(reinterpret_cast<__m128i*>(units), words);
+                    for (int k = 0; k < 7; k++)
+                    {
+                        const auto length = 2 - ((asciiMask >> (2 * k)) & 1);
+                        dest[0] = static_cast<char>(units[k]);
+                        dest[1] = static_cast<char>(units[k] >> 8);
+                        dest += length;
+                    }
+                    *dest++ = static_cast<char>(units[7]);
+                    if (!(asciiMask & 0x4000))
+                        *dest++ = static_cast<char>(units[7] >> 8);
+                    i += 8;
+                    continue;
+                }
+
+                for (const auto end = i + 8; i < end;)
+                {
+                    dest = put(nextCodePoint(s, n, i), dest);
+                }
+            }
+            return writeScalar(s + i, n - i, dest);
+        }
+#endif
+
+        template <class Char>
+        std::size_t length(const Char* s, std::size_t n) noexcept
+        {
+#if UTF8_TRANSCODE_SSE2
+            if constexpr (sizeof(Char) == 2)
+                return lengthSse2(s, n);
+#endif
+            return lengthScalar(s, n);
+        }
+
+        template <class Char>
+        char* write(const Char* s, std::size_t n, char* dest) noexcept
+        {
+#if UTF8_TRANSCODE_SSE2
+            if constexpr (sizeof(Char) == 2)
+                return writeSse2(s, n, dest);
+#endif
+            return writeScalar(s, n, dest);
+        }
+    }
+
+    // Number of bytes writeUtf8(s, dest) stores, without terminator.
+    inline std::size_t utf8Length(std::wstring_view s) noexcept
+    {
+        return utf8_detail::length(s.data(), s.size());
+    }
+
+    // Writes exactly utf8Length(s) bytes to dest and returns the end.
+    inline char* writeUtf8(std::wstring_view s, char* dest) noexcept
+    {
+        return utf8_detail::write(s.data(), s.size(), dest);
+    }
+}
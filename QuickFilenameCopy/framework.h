@@ -13,6 +13,7 @@
 #include <shlwapi.h> 
 #include <combaseapi.h> 
 #include <shlobj.h>
+#include <commdlg.h>
 
 #pragma warning(disable : 4471)
 //#import <mshtml.tlb> no_implementation
@@ -23,13 +24,4 @@
 #include <unordered_set> 
 #include <string>
 #include <tuple> 
-#if __cpp_lib_format
-#include <format>
-#else
-#define FMT_HEADER_ONLY 
-#include "fmt/format.h"
-
-namespace std {
-    using namespace ::fmt;
-}
-#endif
+#include "StdFormat.hpp"
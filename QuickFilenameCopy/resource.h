@@ -11,6 +11,8 @@
 #define ID_ROOT_EXIT                    32771
 #define ID_ROOT_ABOUT                   32772
 #define ID_ROOT_REGISTERTOSTARTUPPROGRAM 32773
+#define ID_ROOT_LATENCYSTATISTICS       32774
+#define ID_ROOT_SAVELATENCYSTATISTICS   32775
 #define IDC_STATIC                      -1
 #define IDC_STATIC_VERSION              -1
 
@@ -20,7 +22,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NO_MFC                     1
 #define _APS_NEXT_RESOURCE_VALUE        131
-#define _APS_NEXT_COMMAND_VALUE         32774
+#define _APS_NEXT_COMMAND_VALUE         32776
 #define _APS_NEXT_CONTROL_VALUE         1001
 #define _APS_NEXT_SYMED_VALUE           110
 #endif
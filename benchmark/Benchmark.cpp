@@ -0,0 +1,248 @@
+// The copy pipeline benchmark on its own: the portable parts of QuickFilenameCopy (item snapshot, sort keys,
+// output formats, extra clipboard formats, UTF-8, chord engine, CIDA parser) replayed against SimulatedShell.
+// With components=1 it also traces window messages with DebugPrintWndProc, which only builds here against the
+// windows.h stand-in of the tests.
+// Takes the key=value options of QuickFilenameCopy's /benchmark mode, and these for the settings it would read:
+//   format=names|paths|quoted|csv|json|powershell  template=<template>  separator=<separator>
+//   sort=none|name|natural|extension  itemChunkSize=<n>  formatChunkSize=<n>  formats=hdrop,html,markdown,utf8
+#include <clocale>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cwchar>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ClipboardEncoders.hpp"
+#include "DebugPrintWndProc.hpp"
+#include "DebugPrintWndProcSwitch.hpp"
+#include "OutputFormat.hpp"
+#include "PipelineBenchmark.hpp"
+#include "RenderPlan.hpp"
+#include "SortOrder.hpp"
+#include "StdFormat.hpp"
+#include "Utf8Transcode.hpp"
+
+namespace
+{
+    struct Settings
+    {
+        OutputFormat format;
+        SortMode sortMode = SortMode::None;
+        unsigned clipboardFormats = 0;
+        PipelineBenchmarkConfig config;
+    };
+
+    std::wstring widen(const char* s)
+    {
+        std::wstring result;
+        for (; *s; s++)
+        {
+            result.push_back(static_cast<wchar_t>(static_cast<unsigned char>(*s)));
+        }
+        return result;
+    }
+
+    std::wstring unescape(std::wstring_view s)
+    {
+        std::wstring result;
+        for (std::size_t i = 0; i < s.size(); i++)
+        {
+            if (s[i] == L'\\' && i + 1 < s.size() && (s[i + 1] == L'n' || s[i + 1] == L't' || s[i + 1] == L'\\'))
+            {
+                result.push_back(s[i + 1] == L'n' ? L'\n' : s[i + 1] == L't' ? L'\t' : L'\\');
+                i++;
+                continue;
+            }
+            result.push_back(s[i]);
+        }
+        return result;
+    }
+
+    Settings parseSettings(const std::vector<std::wstring_view>& args)
+    {
+        Settings settings;
+        std::wstring_view templ;
+        std::wstring separator = L"\n";
+        for (auto arg : args)
+        {
+            auto eq = arg.find(L'=');
+            if (eq == std::wstring_view::npos)
+                continue;
+
+            auto key = arg.substr(0, eq);
+            auto value = arg.substr(eq + 1);
+            auto number = [&] { return static_cast<std::uint32_t>(std::wcstoul(std::wstring{ value }.c_str(), nullptr, 10)); };
+
+            if (key == L"format"sv)
+            {
+                if (value == L"paths"sv) settings.format = OutputFormat{ BuiltinFormat::Paths };
+                else if (value == L"quoted"sv) settings.format = OutputFormat{ BuiltinFormat::Quoted };
+                else if (value == L"csv"sv) settings.format = OutputFormat{ BuiltinFormat::Csv };
+                else if (value == L"json"sv) settings.format = OutputFormat{ BuiltinFormat::Json };
+                else if (value == L"powershell"sv) settings.format = OutputFormat{ BuiltinFormat::PowerShell };
+                else settings.format = OutputFormat{ BuiltinFormat::Names };
+            }
+            else if (key == L"template"sv) templ = value;
+            else if (key == L"separator"sv) separator = unescape(value);
+            else if (key == L"sort"sv)
+            {
+                if (value == L"name"sv) settings.sortMode = SortMode::Name;
+                else if (value == L"natural"sv) settings.sortMode = SortMode::Natural;
+                else if (value == L"extension"sv) settings.sortMode = SortMode::Extension;
+                else settings.sortMode = SortMode::None;
+            }
+            else if (key == L"itemChunkSize"sv) settings.config.itemChunkSize = std::max<std::uint32_t>(number(), 1);
+            else if (key == L"formatChunkSize"sv) settings.config.formatChunkSize = number();
+            else if (key == L"formats"sv)
+            {
+                settings.clipboardFormats = 0;
+                if (value.find(L"hdrop"sv) != std::wstring_view::npos) settings.clipboardFormats |= CBF_HDROP;
+                if (value.find(L"html"sv) != std::wstring_view::npos) settings.clipboardFormats |= CBF_HTML;
+                if (value.find(L"markdown"sv) != std::wstring_view::npos) settings.clipboardFormats |= CBF_MARKDOWN;
+                if (value.find(L"utf8"sv) != std::wstring_view::npos) settings.clipboardFormats |= CBF_UTF8;
+            }
+        }
+        if (!templ.empty())
+        {
+            if (auto format = OutputFormat::compile(templ, separator))
+                settings.format = *format;
+        }
+        settings.config.fields = settings.format.requiredFields() | requiredFieldsOf(settings.clipboardFormats);
+        settings.config.chords = { Chord{ CHM_CONTROL | CHM_SHIFT, 'C' } };
+        return settings;
+    }
+
+    // What publishItems does on Windows, into memory: sort, render the text and encode the extra formats.
+    class Renderer
+    {
+        const Settings& m_settings;
+        std::vector<wchar_t> m_text;
+        std::vector<char> m_utf8;
+        std::vector<std::byte> m_hdrop;
+        std::vector<char> m_html;
+        std::vector<char> m_markdown;
+
+        template <class Items>
+        std::size_t render(const Items& items, LatencyStats& stats)
+        {
+            ScopedLatency latency{ stats, LatencyStage::Format };
+
+            RenderPlan plan{ m_settings.format, items, m_settings.config.formatChunkSize };
+            m_text.resize(plan.size() + 1);
+            *plan.write(m_text.data()) = L'\0';
+
+            if (m_settings.clipboardFormats & CBF_UTF8)
+            {
+                const std::wstring_view text{ m_text.data(), plan.size() };
+                m_utf8.resize(utf8Length(text) + 1);
+                *writeUtf8(text, m_utf8.data()) = '\0';
+            }
+            if (const auto formats = m_settings.clipboardFormats & (CBF_HDROP | CBF_HTML | CBF_MARKDOWN))
+            {
+                auto encoding = ClipboardEncodingPlan::measure(items, formats);
+                m_hdrop.resize(encoding.hdropBytes);
+                m_html.resize(encoding.htmlBytes);
+                m_markdown.resize(encoding.markdownBytes);
+                encoding.write(items, m_hdrop.data(), m_html.data(), m_markdown.data());
+            }
+            return plan.size();
+        }
+
+    public:
+        explicit Renderer(const Settings& settings) noexcept
+            : m_settings(settings)
+        {}
+
+        std::size_t operator()(const SelectionSnapshot& items, LatencyStats& stats)
+        {
+            if (m_settings.sortMode == SortMode::None || items.size() < 2)
+                return render(items, stats);
+
+            std::vector<std::uint32_t> order;
+            {
+                ScopedLatency latency{ stats, LatencyStage::Sort };
+                order = sortedOrder(items.size(), m_settings.config.formatChunkSize, [&](std::size_t i, std::vector<wchar_t>& key) {
+                    appendSortKey(m_settings.sortMode, sortTextOf(items, i), key);
+                });
+            }
+            return render(SortedItems<SelectionSnapshot>{ items, std::move(order) }, stats);
+        }
+    };
+
+    // The message trace of the splash window: DebugPrintWndProc into a fixed buffer against the switch it
+    // replaced, which returns a new std::wstring. The mix is mostly the redraw timer, as while the splash is up,
+    // with the mouse, private and unknown messages that take the other paths.
+    std::wstring messageTraceReport()
+    {
+        using namespace component_benchmark_detail;
+
+        constexpr UINT mix[] = { WM_TIMER, WM_TIMER, WM_TIMER, WM_TIMER, WM_TIMER, WM_TIMER, WM_PAINT, WM_NCHITTEST,
+            WM_SETCURSOR, WM_MOUSEMOVE, WM_USER + 1, WM_APP + 2, 0xC123 };
+        constexpr std::uint32_t count = 100000;
+
+        wchar_t buffer[512];
+        std::size_t tableChars{};
+        const auto table = fastestOf(5, [&] {
+            for (std::uint32_t i = 0; i < count; i++)
+            {
+                tableChars += DebugPrintWndProc(buffer, mix[i % std::size(mix)], i, -static_cast<LPARAM>(i)).size();
+            }
+        });
+        std::size_t switchChars{};
+        const auto switched = fastestOf(5, [&] {
+            for (std::uint32_t i = 0; i < count; i++)
+            {
+                switchChars += switchDebugPrintWndProc(mix[i % std::size(mix)], i, -static_cast<LPARAM>(i)).size();
+            }
+        });
+
+        return std::format(L"message trace, table into a buffer vs switch into a new string:\r\n"
+                           L"  table {:.1f} ns/message, switch {:.1f} ns/message, {:.2f}x{}\r\n"sv,
+            perItem(table, count), perItem(switched, count), speedup(switched, table),
+            tableChars == switchChars ? L""sv : L" (texts differ)"sv);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::setlocale(LC_ALL, "C.UTF-8");
+
+    std::vector<std::wstring> storage;
+    for (int i = 1; i < argc; i++)
+    {
+        storage.push_back(widen(argv[i]));
+    }
+    const std::vector<std::wstring_view> args{ storage.begin(), storage.end() };
+
+    const auto options = BenchmarkOptions::parse(args);
+    const auto settings = parseSettings(args);
+    Renderer renderer{ settings };
+    auto report = runPipelineBenchmark(options, settings.config, renderer);
+    if (options.components)
+    {
+        report += L"\r\n"sv;
+        report += messageTraceReport();
+    }
+
+    std::string utf8(utf8Length(report), '\0');
+    writeUtf8(report, utf8.data());
+
+    FILE* out = stdout;
+    if (!options.output.empty())
+    {
+        std::string path(utf8Length(options.output), '\0');
+        writeUtf8(options.output, path.data());
+        out = std::fopen(path.c_str(), "wb");
+        if (out == nullptr)
+        {
+            std::perror(path.c_str());
+            return 1;
+        }
+    }
+    std::fwrite(utf8.data(), 1, utf8.size(), out);
+    if (out != stdout)
+        std::fclose(out);
+    return 0;
+}
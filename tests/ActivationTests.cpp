@@ -0,0 +1,138 @@
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Activation.hpp"
+
+namespace
+{
+    // The system's hotkey table: ids we registered, and chords other applications hold.
+    struct FakeHotKeys
+    {
+        std::map<int, Chord> registered;
+        std::set<std::uint8_t> takenKeys; // by vk, modifiers aside
+        int registrations{};
+    };
+
+    // Stands in for Win32HotKeyApi.
+    struct FakeHotKeyApi
+    {
+        FakeHotKeys* system;
+
+        bool registerHotKey(int id, const Chord& chord) const noexcept
+        {
+            system->registrations++;
+            if (system->takenKeys.count(chord.vk) || system->registered.count(id))
+                return false;
+            // A chord is registered once, even by the same window.
+            for (const auto& [other, registered] : system->registered)
+            {
+                if (registered.vk == chord.vk && registered.modifiers == chord.modifiers)
+                    return false;
+            }
+            system->registered[id] = chord;
+            return true;
+        }
+
+        void unregisterHotKey(int id) const noexcept { system->registered.erase(id); }
+    };
+
+    const std::vector<Chord> chords{ *parseChord(L"Ctrl+Shift+C"), *parseChord(L"Ctrl+Alt+V") };
+}
+
+TEST(HotKeyActivation, RegistersOnlyWhileATargetIsInFront)
+{
+    FakeHotKeys system;
+    HotKeyActivation<FakeHotKeyApi> hotKeys{ { &system } };
+    ASSERT_TRUE(hotKeys.start(chords));
+    EXPECT_TRUE(system.registered.empty());
+    EXPECT_EQ(hotKeys.onHotKey(0), ChordEngine::noBinding);
+
+    EXPECT_TRUE(hotKeys.onTargetChanged(true));
+    EXPECT_EQ(system.registered.size(), 2u);
+    EXPECT_EQ(hotKeys.onHotKey(1), 1);
+    EXPECT_EQ(hotKeys.onHotKey(2), ChordEngine::noBinding);
+
+    EXPECT_TRUE(hotKeys.onTargetChanged(false));
+    EXPECT_TRUE(system.registered.empty());
+    EXPECT_EQ(hotKeys.onHotKey(1), ChordEngine::noBinding);
+}
+
+TEST(HotKeyActivation, StartFailsWhenAChordIsTaken)
+{
+    FakeHotKeys system;
+    system.takenKeys.insert('V');
+    HotKeyActivation<FakeHotKeyApi> hotKeys{ { &system } };
+    EXPECT_FALSE(hotKeys.start(chords));
+    EXPECT_TRUE(system.registered.empty());
+}
+
+TEST(HotKeyActivation, ReportsAChordTakenAfterStart)
+{
+    FakeHotKeys system;
+    HotKeyActivation<FakeHotKeyApi> hotKeys{ { &system } };
+    ASSERT_TRUE(hotKeys.start(chords));
+
+    system.takenKeys.insert('V');
+    EXPECT_FALSE(hotKeys.onTargetChanged(true));
+    EXPECT_TRUE(system.registered.empty()); // all or none
+    EXPECT_EQ(hotKeys.onHotKey(0), ChordEngine::noBinding);
+}
+
+TEST(HotKeyActivation, StopUnregisters)
+{
+    FakeHotKeys system;
+    {
+        HotKeyActivation<FakeHotKeyApi> hotKeys{ { &system } };
+        ASSERT_TRUE(hotKeys.start(chords));
+        hotKeys.onTargetChanged(true);
+        hotKeys.stop();
+        EXPECT_TRUE(system.registered.empty());
+
+        // Stopped: foreground changes do nothing.
+        const auto registrations = system.registrations;
+        EXPECT_TRUE(hotKeys.onTargetChanged(true));
+        EXPECT_EQ(system.registrations, registrations);
+
+        ASSERT_TRUE(hotKeys.start(chords));
+        hotKeys.onTargetChanged(true);
+    }
+    EXPECT_TRUE(system.registered.empty());
+}
+
+TEST(HotKeyActivation, RepeatedTargetsRegisterOnce)
+{
+    FakeHotKeys system;
+    HotKeyActivation<FakeHotKeyApi> hotKeys{ { &system } };
+    ASSERT_TRUE(hotKeys.start(chords));
+    const auto registrations = system.registrations;
+    EXPECT_TRUE(hotKeys.onTargetChanged(true));
+    EXPECT_TRUE(hotKeys.onTargetChanged(true));
+    EXPECT_EQ(system.registrations, registrations + 2);
+}
+
+TEST(HotKeyActivation, SharedChordsRegisterOnceForTheFirstBinding)
+{
+    FakeHotKeys system;
+    HotKeyActivation<FakeHotKeyApi> hotKeys{ { &system } };
+    const std::vector<Chord> shared{ *parseChord(L"Ctrl+Shift+C"), *parseChord(L"Ctrl+Alt+V"),
+        *parseChord(L"Shift+Ctrl+c"), *parseChord(L"Win+F5"), *parseChord(L"Ctrl+Alt+V") };
+    ASSERT_TRUE(hotKeys.start(shared));
+    ASSERT_TRUE(hotKeys.onTargetChanged(true));
+    ASSERT_EQ(system.registered.size(), 3u);
+
+    // Each registered chord reports the first binding that has it.
+    std::vector<int> bindings;
+    for (const auto& [id, chord] : system.registered)
+    {
+        bindings.push_back(hotKeys.onHotKey(id));
+    }
+    EXPECT_EQ(bindings, (std::vector<int>{ 0, 1, 3 }));
+    EXPECT_EQ(hotKeys.onHotKey(3), ChordEngine::noBinding);
+
+    EXPECT_TRUE(hotKeys.onTargetChanged(false));
+    EXPECT_TRUE(system.registered.empty());
+}
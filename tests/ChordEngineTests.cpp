@@ -0,0 +1,262 @@
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ChordEngine.hpp"
+
+namespace
+{
+    constexpr std::uint8_t vkLShift = 0xA0;
+    constexpr std::uint8_t vkRShift = 0xA1;
+    constexpr std::uint8_t vkLControl = 0xA2;
+    constexpr std::uint8_t vkRControl = 0xA3;
+    constexpr std::uint8_t vkLMenu = 0xA4;
+    constexpr std::uint8_t vkLWin = 0x5B;
+
+    // The engine behind a hook, with the system's key state beside it. Events can reach the system without
+    // reaching the hook, as they do while the secure desktop is up. Events the hook sees are 50 ms apart.
+    class Keyboard
+    {
+        std::array<bool, 256> m_state{};
+
+    public:
+        ChordEngine engine;
+        int resyncs{};
+        std::uint32_t now{ 5000 };
+
+        Keyboard()
+        {
+            engine.bind({ *parseChord(L"Ctrl+Shift+C"), *parseChord(L"Ctrl+C"), *parseChord(L"Win+F5") });
+        }
+
+        // What lowLevelKeyboardProc does with an event.
+        int hook(std::uint8_t vk, bool down)
+        {
+            now += 50;
+            auto binding = engine.onKey(vk, down, now);
+            if (binding == ChordEngine::needsResync)
+            {
+                resyncs++;
+                engine.resync([&](std::uint8_t key) { return m_state[key]; });
+                binding = engine.onKey(vk, down, now);
+            }
+            m_state[vk] = down;
+            return binding;
+        }
+
+        // An event the hook never sees.
+        void lose(std::uint8_t vk, bool down) { m_state[vk] = down; }
+
+        // No event for a while, longer than the engine trusts its state across.
+        void pause() { now += ChordEngine::staleAfterMs + 1; }
+
+        // A Ctrl+C, which confirms the state the first time the engine is asked.
+        void warmUp()
+        {
+            hook(vkLControl, true);
+            hook('C', true);
+            hook('C', false);
+            hook(vkLControl, false);
+        }
+    };
+}
+
+TEST(ChordEngine, ParsesChords)
+{
+    auto chord = parseChord(L" ctrl + Shift+c");
+    ASSERT_TRUE(chord);
+    EXPECT_EQ(chord->modifiers, CHM_CONTROL | CHM_SHIFT);
+    EXPECT_EQ(chord->vk, 'C');
+    EXPECT_EQ(parseChord(L"Alt+F12")->vk, 0x70 + 11);
+    EXPECT_EQ(parseChord(L"Win+PageDown")->vk, 0x22);
+    EXPECT_FALSE(parseChord(L"Ctrl+Shift"));
+    EXPECT_FALSE(parseChord(L"Ctrl+C+D"));
+    EXPECT_FALSE(parseChord(L"F25"));
+    EXPECT_FALSE(parseChord(L"Ctrl+Enter"));
+}
+
+TEST(ChordEngine, MatchesBindings)
+{
+    Keyboard keyboard;
+    EXPECT_EQ(keyboard.hook('C', true), ChordEngine::noBinding);
+    keyboard.hook('C', false);
+    keyboard.hook(vkRControl, true);
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    keyboard.hook('C', false);
+    keyboard.hook(vkLShift, true);
+    EXPECT_EQ(keyboard.hook('C', true), 0);
+    EXPECT_FALSE(keyboard.engine.repeated());
+    keyboard.hook('C', false);
+    keyboard.hook(vkRControl, false);
+    keyboard.hook(vkLShift, false);
+    keyboard.hook(vkLWin, true);
+    EXPECT_EQ(keyboard.hook(0x74, true), 2);
+    EXPECT_EQ(keyboard.hook('X', true), ChordEngine::noBinding);
+}
+
+TEST(ChordEngine, UnboundKeysNeverAskTheSystem)
+{
+    Keyboard keyboard;
+    for (std::uint8_t vk : { std::uint8_t{ 'A' }, std::uint8_t{ 'Z' }, std::uint8_t{ ' ' }, vkLShift, vkLControl })
+    {
+        keyboard.hook(vk, true);
+        keyboard.hook(vk, false);
+    }
+    EXPECT_EQ(keyboard.resyncs, 0);
+}
+
+TEST(ChordEngine, MatchingAChordDoesNotAskTheSystem)
+{
+    Keyboard keyboard;
+    keyboard.warmUp();
+    ASSERT_EQ(keyboard.resyncs, 1);
+
+    for (int i = 0; i < 100; i++)
+    {
+        keyboard.hook(vkLControl, true);
+        keyboard.hook(vkLShift, true);
+        EXPECT_EQ(keyboard.hook('C', true), 0);
+        keyboard.hook('C', false);
+        keyboard.hook(vkLShift, false);
+        EXPECT_EQ(keyboard.hook('C', true), 1);
+        keyboard.hook('C', false);
+        keyboard.hook(vkLControl, false);
+
+        // Shift+C and Alt+C hold modifiers no binding of C is contained in.
+        keyboard.hook(vkLShift, true);
+        EXPECT_EQ(keyboard.hook('C', true), ChordEngine::noBinding);
+        keyboard.hook('C', false);
+        keyboard.hook(vkLShift, false);
+        keyboard.hook(vkLMenu, true);
+        EXPECT_EQ(keyboard.hook('C', true), ChordEngine::noBinding);
+        keyboard.hook('C', false);
+        keyboard.hook(vkLMenu, false);
+    }
+    EXPECT_EQ(keyboard.resyncs, 1);
+}
+
+TEST(ChordEngine, AutorepeatOfAChord)
+{
+    Keyboard keyboard;
+    keyboard.hook(vkLControl, true);
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    EXPECT_FALSE(keyboard.engine.repeated());
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    EXPECT_TRUE(keyboard.engine.repeated());
+    keyboard.hook('C', false);
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    EXPECT_FALSE(keyboard.engine.repeated());
+    EXPECT_EQ(keyboard.resyncs, 1);
+}
+
+TEST(ChordEngine, AutorepeatOfAModifierDoesNotAskTheSystem)
+{
+    Keyboard keyboard;
+    keyboard.warmUp();
+    for (int i = 0; i < 30; i++)
+    {
+        keyboard.hook(vkLControl, true);
+    }
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    EXPECT_EQ(keyboard.resyncs, 1);
+}
+
+TEST(ChordEngine, LostChordKeyUpAfterAPauseIsANewPress)
+{
+    Keyboard keyboard;
+    keyboard.hook(vkLControl, true);
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    keyboard.lose('C', false);
+    keyboard.pause();
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    EXPECT_FALSE(keyboard.engine.repeated());
+}
+
+TEST(ChordEngine, LostModifierKeyUp)
+{
+    Keyboard keyboard;
+    keyboard.warmUp();
+    keyboard.hook(vkLControl, true);
+    keyboard.hook(vkLMenu, true);
+    keyboard.lose(vkLMenu, false);
+
+    // Nothing is bound on Ctrl+Alt+C, but on Ctrl+C, which it contains.
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    EXPECT_EQ(keyboard.engine.modifiers(), CHM_CONTROL);
+    EXPECT_EQ(keyboard.resyncs, 2);
+}
+
+TEST(ChordEngine, LostModifierKeyUpAfterAPause)
+{
+    Keyboard keyboard;
+    keyboard.warmUp();
+    keyboard.hook(vkLControl, true);
+    keyboard.hook(vkLShift, true);
+    keyboard.lose(vkLShift, false);
+    keyboard.pause();
+    EXPECT_EQ(keyboard.hook('C', true), 1); // Ctrl+C, not Ctrl+Shift+C
+    EXPECT_EQ(keyboard.engine.modifiers(), CHM_CONTROL);
+}
+
+TEST(ChordEngine, LostModifierKeyDownAfterAPause)
+{
+    Keyboard keyboard;
+    keyboard.warmUp();
+    keyboard.lose(vkLControl, true);
+    keyboard.pause();
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    keyboard.hook('C', false);
+
+    // A lost key-down on top of one that was seen picks the other binding.
+    keyboard.lose(vkRShift, true);
+    keyboard.pause();
+    EXPECT_EQ(keyboard.hook('C', true), 0);
+    EXPECT_EQ(keyboard.resyncs, 3);
+}
+
+TEST(ChordEngine, InvalidateAsksAtTheNextBoundKey)
+{
+    Keyboard keyboard;
+    keyboard.warmUp();
+    keyboard.lose(vkLControl, true);
+    keyboard.engine.invalidate();
+
+    EXPECT_EQ(keyboard.hook('X', true), ChordEngine::noBinding);
+    EXPECT_EQ(keyboard.resyncs, 1);
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    EXPECT_EQ(keyboard.resyncs, 2);
+}
+
+TEST(ChordEngine, PauseSeenOnAnUnboundKeyIsKept)
+{
+    Keyboard keyboard;
+    keyboard.warmUp();
+    keyboard.lose(vkLControl, true);
+    keyboard.pause();
+    keyboard.hook('X', true);
+    keyboard.hook('X', false);
+    EXPECT_EQ(keyboard.hook('C', true), 1);
+    EXPECT_EQ(keyboard.resyncs, 2);
+}
+
+TEST(ChordEngine, TimestampsThatWrapAreNoPause)
+{
+    Keyboard keyboard;
+    keyboard.now = 0xFFFFFFFFu - 60;
+    keyboard.warmUp();
+    ASSERT_LT(keyboard.now, 1000u);
+    EXPECT_EQ(keyboard.resyncs, 1);
+}
+
+TEST(ChordEngine, SidesAreTrackedApart)
+{
+    Keyboard keyboard;
+    keyboard.hook(vkLControl, true);
+    keyboard.hook(vkRControl, true);
+    keyboard.hook(vkLControl, false);
+    EXPECT_EQ(keyboard.engine.modifiers(), CHM_CONTROL);
+    keyboard.hook(vkRControl, false);
+    EXPECT_EQ(keyboard.engine.modifiers(), 0);
+}
@@ -0,0 +1,194 @@
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "CidaParser.hpp"
+
+namespace
+{
+    using IdList = std::vector<std::string>; // the items of an ID list, each with its size prefix
+
+    std::string item(std::string_view payload)
+    {
+        const auto cb = static_cast<std::uint16_t>(payload.size() + sizeof(std::uint16_t));
+        std::string bytes(sizeof(cb), '\0');
+        std::memcpy(bytes.data(), &cb, sizeof(cb));
+        return bytes.append(payload);
+    }
+
+    std::string bytesOf(const IdList& list)
+    {
+        std::string bytes;
+        for (const auto& i : list)
+        {
+            bytes += i;
+        }
+        return bytes.append(2, '\0');
+    }
+
+    void put32(std::string& block, std::size_t at, std::uint32_t value)
+    {
+        std::memcpy(block.data() + at, &value, sizeof(value));
+    }
+
+    // A block laid out as Explorer lays it out, with the ID lists in order behind the offsets.
+    std::string blockOf(const IdList& folder, const std::vector<IdList>& children)
+    {
+        std::string block((children.size() + 2) * sizeof(std::uint32_t), '\0');
+        put32(block, 0, static_cast<std::uint32_t>(children.size()));
+        put32(block, sizeof(std::uint32_t), static_cast<std::uint32_t>(block.size()));
+        block += bytesOf(folder);
+        for (std::size_t i = 0; i < children.size(); i++)
+        {
+            put32(block, (i + 2) * sizeof(std::uint32_t), static_cast<std::uint32_t>(block.size()));
+            block += bytesOf(children[i]);
+        }
+        return block;
+    }
+
+    IdList randomIdList(std::mt19937& random, unsigned maxItems)
+    {
+        IdList list(random() % (maxItems + 1));
+        for (auto& i : list)
+        {
+            i = item(std::string(random() % 40, static_cast<char>('a' + random() % 26)));
+        }
+        return list;
+    }
+
+    // Parses a copy of bytes in a heap block of exactly that size, so that any read past it is a real overrun.
+    bool parseExact(const std::string& bytes, Cida& cida, std::unique_ptr<char[]>& storage)
+    {
+        storage = std::make_unique<char[]>(bytes.size());
+        std::memcpy(storage.get(), bytes.data(), bytes.size());
+        return parseCida(storage.get(), bytes.size(), cida);
+    }
+
+    // A view that parseCida returned: inside the block, a chain of items ending with exactly one terminator.
+    void expectWellFormed(std::string_view list, const char* block, std::size_t size)
+    {
+        ASSERT_GE(list.data(), block);
+        ASSERT_LE(list.data() + list.size(), block + size);
+        std::size_t at = 0;
+        for (;;)
+        {
+            ASSERT_LE(at + 2, list.size());
+            std::uint16_t cb;
+            std::memcpy(&cb, list.data() + at, sizeof(cb));
+            if (cb == 0)
+                break;
+            ASSERT_GE(cb, 2);
+            at += cb;
+        }
+        EXPECT_EQ(at + 2, list.size());
+    }
+}
+
+TEST(CidaParser, ParsesWellFormedBlocks)
+{
+    std::mt19937 random{ 7 };
+    for (int round = 0; round < 2000; round++)
+    {
+        const auto folder = randomIdList(random, 4);
+        std::vector<IdList> children(random() % 20);
+        for (auto& child : children)
+        {
+            child = randomIdList(random, 3);
+            if (child.empty())
+                child.push_back(item("x"));
+        }
+
+        std::unique_ptr<char[]> storage;
+        Cida cida;
+        ASSERT_TRUE(parseExact(blockOf(folder, children), cida, storage));
+        EXPECT_EQ(cida.folder, bytesOf(folder));
+        ASSERT_EQ(cida.children.size(), children.size());
+        for (std::size_t i = 0; i < children.size(); i++)
+        {
+            EXPECT_EQ(cida.children[i], bytesOf(children[i]));
+        }
+    }
+}
+
+TEST(CidaParser, DamagedBlocksAreRejectedOrStayInBounds)
+{
+    std::mt19937 random{ 11 };
+    Cida cida;
+    for (int round = 0; round < 20000; round++)
+    {
+        std::vector<IdList> children(random() % 6 + 1);
+        for (auto& child : children)
+        {
+            child = randomIdList(random, 3);
+        }
+        auto block = blockOf(randomIdList(random, 3), children);
+
+        // Flip bytes, overwrite sizes and offsets, or cut the block short.
+        switch (random() % 4)
+        {
+        case 0:
+            for (auto flips = random() % 4 + 1; flips; flips--)
+            {
+                block[random() % block.size()] = static_cast<char>(random());
+            }
+            break;
+        case 1:
+            put32(block, sizeof(std::uint32_t) * (random() % (children.size() + 2)), static_cast<std::uint32_t>(random() % (block.size() + 8)));
+            break;
+        case 2:
+            put32(block, 0, random() % 2 ? 0xFFFFFFFF : static_cast<std::uint32_t>(random() % 1000));
+            break;
+        default:
+            block.resize(random() % block.size());
+            break;
+        }
+
+        std::unique_ptr<char[]> storage;
+        if (!parseExact(block, cida, storage))
+        {
+            EXPECT_TRUE(cida.folder.empty());
+            EXPECT_TRUE(cida.children.empty());
+            continue;
+        }
+        expectWellFormed(cida.folder, storage.get(), block.size());
+        for (auto child : cida.children)
+        {
+            expectWellFormed(child, storage.get(), block.size());
+        }
+    }
+}
+
+TEST(CidaParser, RejectsDegenerateBlocks)
+{
+    Cida cida;
+    EXPECT_FALSE(parseCida(nullptr, 0, cida));
+    const std::string tiny(3, '\0');
+    EXPECT_FALSE(parseCida(tiny.data(), tiny.size(), cida));
+
+    // An item whose size is 1 would never advance.
+    auto block = blockOf({ item("f") }, { { item("c") } });
+    block[block.size() - 2 - 3] = 1;
+    EXPECT_FALSE(parseCida(block.data(), block.size(), cida));
+}
+
+TEST(CidaParser, AbsoluteIdList)
+{
+    const auto block = blockOf({ item("drive"), item("dir") }, { { item("file") }, { item("sub"), item("deep") } });
+    Cida cida;
+    ASSERT_TRUE(parseCida(block.data(), block.size(), cida));
+
+    std::vector<char> buffer;
+    EXPECT_EQ(absoluteIdList(cida, cida.children[0], buffer), bytesOf({ item("drive"), item("dir"), item("file") }));
+    EXPECT_EQ(absoluteIdList(cida, cida.children[1], buffer), bytesOf({ item("drive"), item("dir"), item("sub"), item("deep") }));
+
+    // The desktop: an empty folder list leaves the child as it is.
+    const auto desktop = blockOf({}, { { item("file") } });
+    ASSERT_TRUE(parseCida(desktop.data(), desktop.size(), cida));
+    EXPECT_EQ(absoluteIdList(cida, cida.children[0], buffer), bytesOf({ item("file") }));
+}
@@ -0,0 +1,202 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ClipboardEncoders.hpp"
+#include "SelectionSnapshot.hpp"
+#include "SortOrder.hpp"
+#include "TestItems.hpp"
+
+namespace
+{
+    struct Encoded
+    {
+        ClipboardEncodingPlan plan;
+        std::vector<std::byte> hdrop;
+        std::vector<char> html;
+        std::vector<char> markdown;
+    };
+
+    template <class Items>
+    Encoded encode(const Items& items, unsigned formats)
+    {
+        Encoded encoded{ ClipboardEncodingPlan::measure(items, formats) };
+        // One guard byte past each block, so that writing beyond the measured size is noticed.
+        encoded.hdrop.assign(encoded.plan.hdropBytes + 1, std::byte{ 0xCD });
+        encoded.html.assign(encoded.plan.htmlBytes + 1, '\xCD');
+        encoded.markdown.assign(encoded.plan.markdownBytes + 1, '\xCD');
+        encoded.plan.write(items, encoded.hdrop.data(), encoded.html.data(), encoded.markdown.data());
+        EXPECT_EQ(encoded.hdrop.back(), std::byte{ 0xCD });
+        EXPECT_EQ(encoded.html.back(), '\xCD');
+        EXPECT_EQ(encoded.markdown.back(), '\xCD');
+        return encoded;
+    }
+
+    std::uint32_t uint32At(const std::vector<std::byte>& block, std::size_t at)
+    {
+        std::uint32_t v{};
+        for (int i = 3; i >= 0; i--)
+        {
+            v = v << 8 | std::to_integer<std::uint32_t>(block[at + i]);
+        }
+        return v;
+    }
+
+    // The file list of a DROPFILES block, read the way the shell reads it: up to the first empty string.
+    std::vector<std::wstring> droppedFiles(const std::vector<std::byte>& block)
+    {
+        std::vector<std::wstring> files;
+        std::wstring list(reinterpret_cast<const wchar_t*>(block.data() + uint32At(block, 0)),
+            (block.size() - 1 - uint32At(block, 0)) / sizeof(wchar_t));
+        for (std::size_t at = 0; at < list.size() && list[at] != L'\0';)
+        {
+            const auto end = list.find(L'\0', at);
+            files.push_back(list.substr(at, end - at));
+            at = end + 1;
+        }
+        return files;
+    }
+
+    std::string htmlField(const std::string& html, std::string_view key)
+    {
+        const auto at = html.find(key) + key.size();
+        return html.substr(at, 10);
+    }
+}
+
+TEST(ClipboardEncoders, HdropListsFileSystemPaths)
+{
+    TestItems items;
+    items.add(L"a.txt", L"C:\\Docs\\a.txt");
+    items.add(L"b", L"\\\\server\\share\\b");
+
+    const auto encoded = encode(items, CBF_HDROP);
+    ASSERT_EQ(encoded.plan.formats, CBF_HDROP);
+    EXPECT_EQ(uint32At(encoded.hdrop, 0), 20u);
+    EXPECT_EQ(uint32At(encoded.hdrop, 16), 1u); // fWide
+    EXPECT_EQ(droppedFiles(encoded.hdrop), (std::vector<std::wstring>{ L"C:\\Docs\\a.txt", L"\\\\server\\share\\b" }));
+
+    // Exactly one terminator after the last file: the list ends with two NULs and nothing follows.
+    const auto* chars = reinterpret_cast<const wchar_t*>(encoded.hdrop.data() + 20);
+    const auto count = (encoded.plan.hdropBytes - 20) / sizeof(wchar_t);
+    EXPECT_EQ(chars[count - 1], L'\0');
+    EXPECT_EQ(chars[count - 2], L'\0');
+    EXPECT_NE(chars[count - 3], L'\0');
+}
+
+TEST(ClipboardEncoders, HdropSkipsItemsOutsideTheFileSystem)
+{
+    TestItems items;
+    items.add(L"Control Panel", L"::{26EE0668-A00A-44D7-9371-BEB064C98683}", SIF_NAME | SIF_PATH);
+    items.add(L"a.txt", L"C:\\a.txt");
+    items.add(L"empty", L"", SIF_NAME | SIF_FILESYSTEM);
+    items.add(L"b.txt", L"C:\\b.txt");
+    items.add(L"Recycle Bin", L"::{645FF040-5081-101B-9F08-00AA002F954E}", SIF_NAME | SIF_PATH);
+
+    const auto encoded = encode(items, CBF_HDROP);
+    // Neither the virtual items nor the empty path end the list early.
+    EXPECT_EQ(droppedFiles(encoded.hdrop), (std::vector<std::wstring>{ L"C:\\a.txt", L"C:\\b.txt" }));
+    EXPECT_EQ(encoded.plan.hdropBytes, 20 + (9 + 9 + 1) * sizeof(wchar_t));
+}
+
+TEST(ClipboardEncoders, HdropIsOmittedWithoutFiles)
+{
+    TestItems items;
+    items.add(L"Control Panel", L"::{26EE0668-A00A-44D7-9371-BEB064C98683}", SIF_NAME | SIF_PATH);
+
+    const auto encoded = encode(items, CBF_HDROP | CBF_HTML);
+    EXPECT_EQ(encoded.plan.formats, CBF_HTML);
+    EXPECT_EQ(encoded.plan.hdropBytes, 0u);
+    EXPECT_NE(encoded.plan.htmlBytes, 0u);
+}
+
+TEST(ClipboardEncoders, HtmlOffsetsPointAtTheFragment)
+{
+    TestItems items;
+    items.add(L"a&b <c>.txt", L"C:\\a&b <c>.txt");
+    items.add(L"\u00e9t\u00e9 \"q\".md", L"C:\\\u00e9t\u00e9.md");
+
+    const auto encoded = encode(items, CBF_HTML);
+    const std::string html(encoded.html.data());
+    EXPECT_EQ(html.size() + 1, encoded.plan.htmlBytes);
+
+    const auto startHtml = std::stoul(htmlField(html, "StartHTML:"));
+    const auto endHtml = std::stoul(htmlField(html, "EndHTML:"));
+    const auto startFragment = std::stoul(htmlField(html, "StartFragment:"));
+    const auto endFragment = std::stoul(htmlField(html, "EndFragment:"));
+    EXPECT_EQ(html.compare(startHtml, 6, "<html>"), 0);
+    EXPECT_EQ(endHtml, html.size());
+    EXPECT_EQ(html.substr(startFragment, endFragment - startFragment),
+        "<ul>\r\n<li>a&amp;b &lt;c&gt;.txt</li>\r\n<li>\xc3\xa9t\xc3\xa9 &quot;q&quot;.md</li>\r\n</ul>");
+}
+
+TEST(ClipboardEncoders, MarkdownListEscapesMarkup)
+{
+    TestItems items;
+    items.add(L"plain.txt", L"C:\\plain.txt");
+    items.add(L"my_file *v2*.md", L"C:\\x");
+    items.add(L"[draft] <b> & `x` ~y~ a\\b", L"C:\\x");
+    items.add(L"# notes", L"C:\\x");
+    items.add(L"-dash+", L"C:\\x");
+    items.add(L"+plus", L"C:\\x");
+    items.add(L"2024. report", L"C:\\x");
+    items.add(L"1) first.txt", L"C:\\x");
+    items.add(L"v1.2 (final).txt", L"C:\\x");
+    items.add(L"1234567890. long", L"C:\\x");
+    items.add(L"\u00e9t\u00e9", L"C:\\x");
+
+    const auto encoded = encode(items, CBF_MARKDOWN);
+    const std::string markdown(encoded.markdown.data());
+    EXPECT_EQ(markdown.size() + 1, encoded.plan.markdownBytes);
+    EXPECT_EQ(markdown,
+        "- plain.txt\r\n"
+        "- my\\_file \\*v2\\*.md\r\n"
+        "- \\[draft\\] \\<b\\> \\& \\`x\\` \\~y\\~ a\\\\b\r\n"
+        "- \\# notes\r\n"
+        "- \\-dash+\r\n"
+        "- \\+plus\r\n"
+        "- 2024\\. report\r\n"
+        "- 1\\) first.txt\r\n"
+        "- v1.2 (final).txt\r\n"
+        "- 1234567890. long\r\n"
+        "- \xc3\xa9t\xc3\xa9\r\n");
+}
+
+TEST(ClipboardEncoders, AllFormatsInOnePassOverASnapshot)
+{
+    TestItems items;
+    items.add(L"b.txt", L"C:\\Docs\\b.txt");
+    items.add(L"Network", L"::{F02C1A0D-BE21-4350-88B0-7367FC96EF3C}", SIF_NAME | SIF_PATH);
+    items.add(L"a.txt", L"C:\\Docs\\a.txt");
+
+    SelectionSnapshot snapshot;
+    for (std::size_t i = 0; i < items.size(); i++)
+    {
+        snapshot.append(items.name(i), items.path(i), items.flags(i));
+    }
+    SortedItems<SelectionSnapshot> sorted{ snapshot, { 2, 1, 0 } };
+
+    const auto formats = CBF_HDROP | CBF_HTML | CBF_MARKDOWN;
+    const auto fromItems = encode(items, formats);
+    const auto fromSnapshot = encode(snapshot, formats);
+    EXPECT_EQ(fromSnapshot.hdrop, fromItems.hdrop);
+    EXPECT_EQ(fromSnapshot.html, fromItems.html);
+    EXPECT_EQ(fromSnapshot.markdown, fromItems.markdown);
+
+    const auto fromSorted = encode(sorted, formats);
+    EXPECT_EQ(droppedFiles(fromSorted.hdrop), (std::vector<std::wstring>{ L"C:\\Docs\\a.txt", L"C:\\Docs\\b.txt" }));
+    EXPECT_EQ(std::string(fromSorted.markdown.data()), "- a.txt\r\n- Network\r\n- b.txt\r\n");
+}
+
+TEST(ClipboardEncoders, RequiredFields)
+{
+    EXPECT_EQ(requiredFieldsOf(CBF_HDROP), IFF_PATH | IFF_FILESYSPATH);
+    EXPECT_EQ(requiredFieldsOf(CBF_HTML), IFF_NAME);
+    EXPECT_EQ(requiredFieldsOf(CBF_MARKDOWN), IFF_NAME);
+    EXPECT_EQ(requiredFieldsOf(CBF_SHELLIDLIST | CBF_UTF8), 0u);
+}
@@ -0,0 +1,108 @@
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "CopyScheduler.hpp"
+
+namespace
+{
+    struct Request
+    {
+        int hWnd;
+        std::uint8_t binding;
+        bool repeat;
+    };
+}
+
+TEST(CopyScheduler, RunsRequestsInTurn)
+{
+    CopyScheduler<Request> scheduler;
+    EXPECT_FALSE(scheduler.next());
+    EXPECT_TRUE(scheduler.submit({ 1, 0, false }));
+    auto request = scheduler.next();
+    ASSERT_TRUE(request);
+    EXPECT_EQ(request->hWnd, 1);
+    EXPECT_FALSE(scheduler.next());
+    EXPECT_FALSE(scheduler.superseded());
+    scheduler.finished();
+}
+
+TEST(CopyScheduler, DropsAutorepeats)
+{
+    CopyScheduler<Request> scheduler;
+    EXPECT_FALSE(scheduler.submit({ 1, 0, true }));
+    EXPECT_FALSE(scheduler.next());
+}
+
+TEST(CopyScheduler, FoldsIntoTheWaitingRequest)
+{
+    CopyScheduler<Request> scheduler;
+    EXPECT_TRUE(scheduler.submit({ 1, 0, false }));
+    EXPECT_FALSE(scheduler.submit({ 1, 0, false }));
+    EXPECT_TRUE(scheduler.submit({ 1, 1, false }));
+    EXPECT_EQ(scheduler.next()->binding, 1);
+    EXPECT_FALSE(scheduler.next());
+}
+
+TEST(CopyScheduler, SameAsARunningCopyThatHasNotReadTheSelectionIsDropped)
+{
+    CopyScheduler<Request> scheduler;
+    scheduler.submit({ 1, 0, false });
+    scheduler.next();
+    EXPECT_FALSE(scheduler.submit({ 1, 0, false }));
+    EXPECT_FALSE(scheduler.superseded());
+    EXPECT_FALSE(scheduler.next());
+
+    // Once it finished, the same chord copies again.
+    scheduler.finished();
+    EXPECT_TRUE(scheduler.submit({ 1, 0, false }));
+}
+
+TEST(CopyScheduler, SameAsARunningCopyThatReadTheSelectionSupersedesIt)
+{
+    CopyScheduler<Request> scheduler;
+    scheduler.submit({ 1, 0, false });
+    scheduler.next();
+    scheduler.readingSelection();
+
+    // The selection may have changed since the running copy read it.
+    EXPECT_TRUE(scheduler.submit({ 1, 0, false }));
+    EXPECT_TRUE(scheduler.superseded());
+    EXPECT_FALSE(scheduler.submit({ 1, 0, false }));
+    scheduler.finished();
+
+    auto request = scheduler.next();
+    ASSERT_TRUE(request);
+    EXPECT_EQ(request->hWnd, 1);
+    EXPECT_FALSE(scheduler.superseded());
+
+    // The next copy has not read the selection yet.
+    EXPECT_FALSE(scheduler.submit({ 1, 0, false }));
+}
+
+TEST(CopyScheduler, OtherRequestsSupersedeTheRunningCopy)
+{
+    CopyScheduler<Request> scheduler;
+    scheduler.submit({ 1, 0, false });
+    scheduler.next();
+    EXPECT_TRUE(scheduler.submit({ 2, 0, false }));
+    EXPECT_TRUE(scheduler.superseded());
+
+    // The running copy is checked against the waiting request only, so going back to it waits again.
+    EXPECT_TRUE(scheduler.submit({ 1, 0, false }));
+    EXPECT_TRUE(scheduler.superseded());
+    scheduler.finished();
+    EXPECT_FALSE(scheduler.superseded());
+
+    auto request = scheduler.next();
+    ASSERT_TRUE(request);
+    EXPECT_EQ(request->hWnd, 1);
+    EXPECT_FALSE(scheduler.superseded());
+}
+
+TEST(CopyScheduler, NothingRunningIsNeverSuperseded)
+{
+    CopyScheduler<Request> scheduler;
+    scheduler.submit({ 1, 0, false });
+    EXPECT_FALSE(scheduler.superseded());
+}
@@ -0,0 +1,55 @@
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include "DebugPrintWndProc.hpp"
+#include "DebugPrintWndProcSwitch.hpp"
+
+TEST(DebugPrintWndProc, MatchesTheSwitchForEveryMessage)
+{
+    wchar_t buffer[512];
+    std::size_t named = 0;
+    for (std::uint64_t m = 0; m <= 0x10000; m++)
+    {
+        const auto message = static_cast<UINT>(m);
+        if (message == WM_CREATE)
+            continue;
+
+        const WPARAM wParam = m * 0x9E3779B9u;
+        const LPARAM lParam = -static_cast<LPARAM>(m);
+        const auto expected = switchDebugPrintWndProc(message, wParam, lParam);
+        ASSERT_EQ(DebugPrintWndProc(buffer, message, wParam, lParam), expected) << "message 0x" << std::hex << m;
+        named += !windowMessageName(message).empty();
+    }
+    for (UINT message : { 0xBFFFu, 0xC000u, 0xC123u, 0xFFFFFFFFu })
+    {
+        ASSERT_EQ(DebugPrintWndProc(buffer, message, 1, 2), switchDebugPrintWndProc(message, 1, 2)) << "message 0x" << std::hex << message;
+    }
+
+    // Every name in the table was reached, each by its own message.
+    EXPECT_EQ(named, windowMessageNames.size());
+}
+
+TEST(DebugPrintWndProc, FormatsCreateStruct)
+{
+    CREATESTRUCTW cs{};
+    cs.lpCreateParams = &cs;
+    cs.hInstance = reinterpret_cast<HINSTANCE>(std::uintptr_t{ 0x10000 });
+    cs.cy = 480;
+    cs.cx = 640;
+    cs.x = -8;
+    cs.y = 16;
+    const auto lParam = reinterpret_cast<LPARAM>(&cs);
+
+    wchar_t buffer[512];
+    EXPECT_EQ(DebugPrintWndProc(buffer, WM_CREATE, 0, lParam), switchDebugPrintWndProc(WM_CREATE, 0, lParam));
+}
+
+TEST(DebugPrintWndProc, TruncatesToTheBuffer)
+{
+    const auto full = switchDebugPrintWndProc(WM_DWMSENDICONICLIVEPREVIEWBITMAP, 0x1234, 0x5678);
+    wchar_t small[16];
+    EXPECT_EQ(DebugPrintWndProc(small, WM_DWMSENDICONICLIVEPREVIEWBITMAP, 0x1234, 0x5678), std::wstring_view(full).substr(0, 16));
+}
@@ -0,0 +1,151 @@
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "DeferredRender.hpp"
+
+namespace
+{
+    // The clipboard as far as delayed rendering sees it: emptying it tells the previous owner, which may be
+    // the same window, that its data is gone (WM_DESTROYCLIPBOARD); a paste asks the owner to render
+    // (WM_RENDERFORMAT), at most once per publication.
+    class FakeClipboard
+    {
+        DeferredRender<std::function<std::string()>>* m_owner{};
+        std::optional<std::string> m_text;
+        bool m_delayed{};
+
+    public:
+        void empty(DeferredRender<std::function<std::string()>>& owner)
+        {
+            if (m_owner != nullptr)
+                m_owner->discard();
+            m_owner = &owner;
+            m_text.reset();
+            m_delayed = false;
+        }
+
+        void setDelayed() noexcept
+        {
+            m_delayed = true;
+        }
+
+        std::optional<std::string> paste()
+        {
+            if (!m_text && m_delayed && m_owner != nullptr)
+            {
+                if (auto render = m_owner->take())
+                    m_text = (*render)();
+                m_delayed = false;
+            }
+            return m_text;
+        }
+    };
+}
+
+TEST(DeferredRender, RendersOnceWhenPasted)
+{
+    DeferredRender<std::function<std::string()>> owner;
+    FakeClipboard clipboard;
+    int renders = 0;
+
+    clipboard.empty(owner);
+    owner.offer([&] { renders++; return std::string{ "a\nb" }; });
+    clipboard.setDelayed();
+    EXPECT_TRUE(owner.pending());
+    EXPECT_EQ(renders, 0);
+
+    EXPECT_EQ(clipboard.paste(), std::optional<std::string>{ "a\nb" });
+    EXPECT_EQ(clipboard.paste(), std::optional<std::string>{ "a\nb" });
+    EXPECT_EQ(renders, 1);
+    EXPECT_FALSE(owner.pending());
+}
+
+TEST(DeferredRender, RepublishingReplacesThePendingData)
+{
+    DeferredRender<std::function<std::string()>> owner;
+    FakeClipboard clipboard;
+
+    clipboard.empty(owner);
+    owner.offer([] { return std::string{ "first" }; });
+    clipboard.setDelayed();
+
+    // A second copy before anything was pasted: emptying discards the first offer, then the second is made.
+    clipboard.empty(owner);
+    EXPECT_FALSE(owner.pending());
+    owner.offer([] { return std::string{ "second" }; });
+    clipboard.setDelayed();
+
+    EXPECT_EQ(clipboard.paste(), std::optional<std::string>{ "second" });
+}
+
+TEST(DeferredRender, OfferBeforeEmptyIsLost)
+{
+    // Why the publisher offers after EmptyClipboard: the other order discards the new data.
+    DeferredRender<std::function<std::string()>> owner;
+    FakeClipboard clipboard;
+
+    clipboard.empty(owner);
+    owner.offer([] { return std::string{ "early" }; });
+    clipboard.empty(owner);
+    EXPECT_FALSE(owner.pending());
+    EXPECT_FALSE(owner.take().has_value());
+}
+
+TEST(DeferredRender, AnotherOwnerDiscardsOurs)
+{
+    DeferredRender<std::function<std::string()>> ours;
+    DeferredRender<std::function<std::string()>> theirs;
+    FakeClipboard clipboard;
+
+    clipboard.empty(ours);
+    ours.offer([] { return std::string{ "ours" }; });
+    clipboard.setDelayed();
+    clipboard.empty(theirs);
+    EXPECT_FALSE(ours.pending());
+    EXPECT_EQ(clipboard.paste(), std::nullopt);
+}
+
+TEST(DeferredRender, HandsOutEachOfferOnceAcrossThreads)
+{
+    constexpr int offers = 20000;
+
+    DeferredRender<int> render;
+    std::atomic<bool> done{ false };
+    std::vector<int> taken;
+    std::thread window{ [&] {
+        while (true)
+        {
+            const bool last = done.load();
+            if (auto payload = render.take())
+                taken.push_back(*payload);
+            else if (last)
+                break;
+            else
+                std::this_thread::yield();
+        }
+    } };
+    for (int i = 1; i <= offers; i++)
+    {
+        render.offer(i);
+        if (i % 3 == 0)
+            render.discard();
+    }
+    done = true;
+    window.join();
+
+    // Offers may be replaced or discarded before they are taken, but none is handed out twice
+    // and the last one is not lost.
+    for (std::size_t i = 1; i < taken.size(); i++)
+    {
+        ASSERT_LT(taken[i - 1], taken[i]);
+    }
+    ASSERT_FALSE(taken.empty());
+    EXPECT_EQ(taken.back(), offers);
+    EXPECT_FALSE(render.pending());
+}
@@ -0,0 +1,104 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "EscapeScan.hpp"
+
+namespace
+{
+    // Code units around everything the escapes test for: the characters themselves, their neighbours,
+    // the control character boundary, the typographic quotes and the ends of the signed and unsigned ranges.
+    constexpr char16_t interesting[] = {
+        u'"', u'\\', u'`', u'$', u'#', u'%', u'!', u'a', u'Z', u' ', u'~',
+        0x00, 0x01, 0x1F, 0x20, 0x21, 0x7F, 0x80, 0xFF,
+        0x201B, 0x201C, 0x201D, 0x201E, 0x201F, 0x3000,
+        0x7FFF, 0x8000, 0x8020, 0x8022, 0xD800, 0xDFFF, 0xFFFF,
+    };
+
+    std::vector<char16_t> randomText(std::mt19937& random, std::size_t length, unsigned specialPercent)
+    {
+        std::vector<char16_t> text(length);
+        for (auto& c : text)
+        {
+            if (random() % 100 < specialPercent)
+                c = interesting[random() % std::size(interesting)];
+            else
+                c = static_cast<char16_t>(u'a' + random() % 26);
+        }
+        return text;
+    }
+
+    template <Escape E>
+    void fuzz()
+    {
+        using namespace escape_detail;
+
+        std::mt19937 random{ 1234 + static_cast<unsigned>(E) };
+#if ESCAPE_SCAN_X86
+        const bool avx2 = scanLevel() == ScanLevel::Avx2;
+        const bool sse2 = scanLevel() != ScanLevel::Scalar;
+#endif
+        for (int round = 0; round < 20000; round++)
+        {
+            // Mostly clean text, the way paths are, with the odd string full of specials.
+            const auto text = randomText(random, random() % 80, round % 10 == 0 ? 30 : 1);
+            const std::size_t offset = text.empty() ? 0 : random() % (text.size() + 1);
+            const auto* s = text.data() + offset; // any alignment
+            const auto n = text.size() - offset;
+
+            const auto expected = scanScalar<E>(s, n);
+            ASSERT_EQ(findEscape<E>(s, n), expected) << "round " << round;
+#if ESCAPE_SCAN_X86
+            if (sse2)
+            {
+                ASSERT_EQ(scanSse2<E>(s, n), expected) << "round " << round;
+            }
+            if (avx2)
+            {
+                ASSERT_EQ(scanAvx2<E>(s, n), expected) << "round " << round;
+            }
+#endif
+        }
+    }
+}
+
+TEST(EscapeScan, CsvMatchesScalar) { fuzz<Escape::Csv>(); }
+TEST(EscapeScan, JsonMatchesScalar) { fuzz<Escape::Json>(); }
+TEST(EscapeScan, PowerShellMatchesScalar) { fuzz<Escape::PowerShell>(); }
+
+TEST(EscapeScan, EveryCodeUnitInEveryLane)
+{
+    // Each code unit at each position of a 16-unit block and of the 8-unit tail behind it.
+    for (std::uint32_t c = 0; c <= 0xFFFF; c++)
+    {
+        for (std::size_t at : { 0u, 5u, 15u, 16u, 23u })
+        {
+            std::vector<char16_t> text(24, u'x');
+            text[at] = static_cast<char16_t>(c);
+            const auto* s = text.data();
+            ASSERT_EQ(findEscape<Escape::Csv>(s, text.size()), escape_detail::scanScalar<Escape::Csv>(s, text.size())) << c;
+            ASSERT_EQ(findEscape<Escape::Json>(s, text.size()), escape_detail::scanScalar<Escape::Json>(s, text.size())) << c;
+            ASSERT_EQ(findEscape<Escape::PowerShell>(s, text.size()), escape_detail::scanScalar<Escape::PowerShell>(s, text.size())) << c;
+        }
+    }
+}
+
+TEST(EscapeScan, QuoteAndNoneNeverStop)
+{
+    const char16_t text[] = u"\"\\`$\u201C";
+    EXPECT_EQ(findEscape<Escape::None>(text, 5), 5u);
+    EXPECT_EQ(findEscape<Escape::Quote>(text, 5), 5u);
+}
+
+TEST(EscapeScan, WideStringsScanAlike)
+{
+    const wchar_t text[] = L"C:\\Program Files\\say \"hi\" $HOME \u201Cq\u201D";
+    const auto n = std::size(text) - 1;
+    EXPECT_EQ(findEscape<Escape::Csv>(text, n), 21u);
+    EXPECT_EQ(findEscape<Escape::Json>(text, n), 2u);
+    EXPECT_EQ(findEscape<Escape::PowerShell>(text, n), 21u);
+    EXPECT_EQ(findEscape<Escape::PowerShell>(text + 22, n - 22), 2u);
+}
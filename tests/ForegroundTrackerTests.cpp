@@ -0,0 +1,139 @@
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ForegroundTracker.hpp"
+
+namespace
+{
+    struct FakeWindow {};
+    using Handle = FakeWindow*;
+
+    Handle window(std::uintptr_t id) { return reinterpret_cast<Handle>(id * 16); }
+
+    // Stands in for isTargetWindow and IsWindow: a set of target windows, a count of how often it was asked,
+    // and the windows that were destroyed.
+    struct FakeClassifier
+    {
+        std::set<Handle> targets;
+        int calls{};
+        std::set<Handle> destroyed;
+
+        auto isTarget()
+        {
+            return [this](Handle hWnd) {
+                calls++;
+                return targets.count(hWnd) != 0;
+            };
+        }
+
+        auto isAlive()
+        {
+            return [this](Handle hWnd) { return destroyed.count(hWnd) == 0; };
+        }
+    };
+}
+
+TEST(ForegroundTracker, FollowsTheForeground)
+{
+    ForegroundTracker<Handle> tracker;
+    FakeClassifier classifier{ { window(1) } };
+    EXPECT_EQ(tracker.target(), nullptr);
+
+    tracker.onForeground(window(1), classifier.isTarget(), classifier.isAlive());
+    EXPECT_EQ(tracker.target(), window(1));
+    tracker.onForeground(window(2), classifier.isTarget(), classifier.isAlive());
+    EXPECT_EQ(tracker.target(), nullptr);
+    tracker.onForeground(window(1), classifier.isTarget(), classifier.isAlive());
+    EXPECT_EQ(tracker.target(), window(1));
+    tracker.onForeground(nullptr, classifier.isTarget(), classifier.isAlive());
+    EXPECT_EQ(tracker.target(), nullptr);
+}
+
+TEST(ForegroundTracker, ClassifiesEachWindowOnce)
+{
+    ForegroundTracker<Handle> tracker;
+    FakeClassifier classifier{ { window(1) } };
+    for (int i = 0; i < 10; i++)
+    {
+        tracker.onForeground(window(1), classifier.isTarget(), classifier.isAlive());
+        tracker.onForeground(window(2), classifier.isTarget(), classifier.isAlive());
+    }
+    EXPECT_EQ(classifier.calls, 2);
+}
+
+TEST(ForegroundTracker, FullCacheDropsDestroyedWindows)
+{
+    ForegroundTracker<Handle> tracker;
+    FakeClassifier classifier{ { window(1) } };
+    for (std::uintptr_t id = 1; id <= 4096; id++)
+    {
+        tracker.onForeground(window(id), classifier.isTarget(), classifier.isAlive());
+    }
+    for (std::uintptr_t id = 2; id <= 4096; id += 2)
+    {
+        classifier.destroyed.insert(window(id));
+    }
+    ASSERT_EQ(classifier.calls, 4096);
+
+    // A new window makes room by dropping the destroyed ones; the others stay classified.
+    tracker.onForeground(window(5000), classifier.isTarget(), classifier.isAlive());
+    EXPECT_EQ(classifier.calls, 4097);
+    for (std::uintptr_t id = 1; id <= 4096; id += 2)
+    {
+        tracker.onForeground(window(id), classifier.isTarget(), classifier.isAlive());
+    }
+    EXPECT_EQ(classifier.calls, 4097);
+    EXPECT_EQ(tracker.target(), nullptr);
+    tracker.onForeground(window(1), classifier.isTarget(), classifier.isAlive());
+    EXPECT_EQ(tracker.target(), window(1));
+
+    // A handle that was dropped is classified again when it is reused.
+    classifier.destroyed.erase(window(2));
+    classifier.targets.insert(window(2));
+    tracker.onForeground(window(2), classifier.isTarget(), classifier.isAlive());
+    EXPECT_EQ(classifier.calls, 4098);
+    EXPECT_EQ(tracker.target(), window(2));
+}
+
+TEST(ForegroundTracker, CacheIsBounded)
+{
+    ForegroundTracker<Handle> tracker;
+    FakeClassifier classifier{ { window(1) } };
+    tracker.onForeground(window(1), classifier.isTarget(), classifier.isAlive());
+    for (std::uintptr_t id = 2; id < 5000; id++)
+    {
+        tracker.onForeground(window(id), classifier.isTarget(), classifier.isAlive());
+    }
+    const auto calls = classifier.calls;
+
+    // None was destroyed, so window 1 fell out when the cache was cleared and is classified again,
+    // with the same answer.
+    tracker.onForeground(window(1), classifier.isTarget(), classifier.isAlive());
+    EXPECT_EQ(classifier.calls, calls + 1);
+    EXPECT_EQ(tracker.target(), window(1));
+}
+
+TEST(ForegroundTracker, HookThreadReadsWhileNotificationsArrive)
+{
+    ForegroundTracker<Handle> tracker;
+    FakeClassifier classifier{ { window(1), window(3) } };
+    std::atomic<bool> done{};
+    std::thread hook{ [&] {
+        while (!done.load())
+        {
+            auto target = tracker.target();
+            ASSERT_TRUE(target == nullptr || target == window(1) || target == window(3));
+        }
+    } };
+    for (int i = 0; i < 100000; i++)
+    {
+        tracker.onForeground(window(1 + i % 4), classifier.isTarget(), classifier.isAlive());
+    }
+    done = true;
+    hook.join();
+}
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ItemNameSource.hpp"
+#include "OutputFormat.hpp"
+#include "SimulatedShell.hpp"
+
+namespace
+{
+    // Items "item<i>" in C:\Dir<i % 3>\, handed out at most `limit` at a time, as an enumerator may return
+    // fewer than asked. The strings are rewritten on every call, so a reader that kept views would see it.
+    class FakeNameSource final : public ItemNameSource
+    {
+        std::uint32_t m_count;
+        std::uint32_t m_limit;
+        std::uint32_t m_next{};
+        std::vector<std::wstring> m_names;
+        std::vector<std::wstring> m_paths;
+
+    public:
+        std::vector<std::uint32_t> requested;
+
+        FakeNameSource(std::uint32_t count, std::uint32_t limit)
+            : m_count(count), m_limit(limit)
+        {}
+
+        std::uint32_t count() override
+        {
+            return m_count;
+        }
+
+        std::uint32_t next(SelectionItem* items, std::uint32_t count) override
+        {
+            requested.push_back(count);
+            count = std::min({ count, m_limit, m_count - m_next });
+            m_names.assign(count, std::wstring{});
+            m_paths.assign(count, std::wstring{});
+            for (std::uint32_t i = 0; i < count; i++)
+            {
+                const auto n = m_next + i;
+                m_names[i] = L"item" + std::to_wstring(n);
+                m_paths[i] = L"C:\\Dir" + std::to_wstring(n % 3) + L"\\" + m_names[i];
+                items[i] = { m_names[i], m_paths[i], SIF_NAME | SIF_PATH };
+            }
+            m_next += count;
+            return count;
+        }
+    };
+
+    void expectItems(const SelectionSnapshot& snapshot, std::uint32_t count)
+    {
+        ASSERT_EQ(snapshot.size(), count);
+        for (std::uint32_t i = 0; i < count; i++)
+        {
+            const auto name = L"item" + std::to_wstring(i);
+            EXPECT_EQ(snapshot.name(i), name);
+            auto [prefix, leaf] = snapshot.pathParts(i);
+            EXPECT_EQ(std::wstring{ prefix } + std::wstring{ leaf }, L"C:\\Dir" + std::to_wstring(i % 3) + L"\\" + name);
+            EXPECT_EQ(snapshot.flags(i), SIF_NAME | SIF_PATH);
+        }
+    }
+}
+
+TEST(ItemNameSource, ReadsInChunksOfTheGivenSize)
+{
+    FakeNameSource source{ 10, 100 };
+    auto snapshot = readAllItems(source, 4);
+    expectItems(snapshot, 10);
+    EXPECT_EQ(source.requested, (std::vector<std::uint32_t>{ 4, 4, 2 }));
+}
+
+TEST(ItemNameSource, ChunkNeverExceedsTheSelection)
+{
+    FakeNameSource source{ 3, 100 };
+    auto snapshot = readAllItems(source, 256);
+    expectItems(snapshot, 3);
+    EXPECT_EQ(source.requested, (std::vector<std::uint32_t>{ 3 }));
+}
+
+TEST(ItemNameSource, ZeroChunkSizeReadsOneAtATime)
+{
+    FakeNameSource source{ 3, 100 };
+    auto snapshot = readAllItems(source, 0);
+    expectItems(snapshot, 3);
+    EXPECT_EQ(source.requested, (std::vector<std::uint32_t>{ 1, 1, 1 }));
+}
+
+TEST(ItemNameSource, ShortChunksAreFollowedUp)
+{
+    FakeNameSource source{ 10, 3 };
+    auto snapshot = readAllItems(source, 8);
+    expectItems(snapshot, 10);
+    EXPECT_EQ(source.requested, (std::vector<std::uint32_t>{ 8, 7, 4, 1 }));
+}
+
+TEST(ItemNameSource, EmptySelection)
+{
+    FakeNameSource source{ 0, 100 };
+    auto snapshot = readAllItems(source, 8);
+    EXPECT_TRUE(snapshot.empty());
+    EXPECT_TRUE(source.requested.empty());
+}
+
+TEST(ItemNameSource, CancellationStopsBetweenChunks)
+{
+    FakeNameSource source{ 100, 100 };
+    int asked = 0;
+    auto snapshot = readAllItems(source, 10, [&] { return ++asked == 3; });
+    // Asked before the second and third chunk, not before the first.
+    EXPECT_EQ(asked, 3);
+    expectItems(snapshot, 30);
+}
+
+TEST(ItemNameSource, SimulatedSourceHonorsFields)
+{
+    BenchmarkOptions options;
+    options.items = 50;
+    options.folders = 5;
+    options.depth = 2;
+
+    SimulatedNameSource names{ options, IFF_NAME };
+    auto snapshot = readAllItems(names, 7);
+    ASSERT_EQ(snapshot.size(), 50u);
+    for (std::size_t i = 0; i < snapshot.size(); i++)
+    {
+        EXPECT_EQ(snapshot.flags(i), SIF_NAME);
+        EXPECT_GE(snapshot.name(i).size(), options.minNameLength);
+        EXPECT_TRUE(snapshot.pathParts(i).second.empty());
+    }
+
+    SimulatedNameSource paths{ options, IFF_PATH };
+    snapshot = readAllItems(paths, 7);
+    ASSERT_EQ(snapshot.size(), 50u);
+    EXPECT_EQ(snapshot.folderCount(), 5u);
+    auto [prefix, leaf] = snapshot.pathParts(49);
+    EXPECT_EQ(prefix, L"C:\\Bench\\Level1\\Folder4\\");
+    EXPECT_FALSE(leaf.empty());
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "LatencyHistogram.hpp"
+
+TEST(LatencyHistogram, BucketsCoverEveryValue)
+{
+    std::mt19937_64 random{ 7 };
+    std::vector<std::uint64_t> values{ 0, 1, 31, 32, 33, 63, 64, 65, 1000, 1ull << 32, UINT64_MAX - 1, UINT64_MAX };
+    for (int i = 0; i < 100000; i++)
+    {
+        values.push_back(random() >> (random() % 64));
+    }
+
+    for (auto v : values)
+    {
+        const auto bucket = LatencyHistogram::bucketOf(v);
+        ASSERT_LE(LatencyHistogram::lowerBoundOf(bucket), v) << v;
+        ASSERT_GE(LatencyHistogram::upperBoundOf(bucket), v) << v;
+        // A bucket is at most 1/16 of its lower bound wide.
+        const auto width = LatencyHistogram::upperBoundOf(bucket) - LatencyHistogram::lowerBoundOf(bucket);
+        ASSERT_LE(width, LatencyHistogram::lowerBoundOf(bucket) / 16) << v;
+    }
+}
+
+TEST(LatencyHistogram, BucketsAreContiguous)
+{
+    for (std::size_t bucket = 1; LatencyHistogram::upperBoundOf(bucket - 1) != UINT64_MAX; bucket++)
+    {
+        ASSERT_EQ(LatencyHistogram::lowerBoundOf(bucket), LatencyHistogram::upperBoundOf(bucket - 1) + 1) << bucket;
+        ASSERT_EQ(LatencyHistogram::bucketOf(LatencyHistogram::lowerBoundOf(bucket)), bucket);
+    }
+}
+
+TEST(LatencyHistogram, PercentilesAreWithinOneBucket)
+{
+    std::mt19937_64 random{ 11 };
+    std::lognormal_distribution<double> latency{ 10.0, 1.5 };
+    std::vector<std::uint64_t> values(20000);
+    LatencyHistogram histogram;
+    std::uint64_t sum = 0;
+    for (auto& v : values)
+    {
+        v = static_cast<std::uint64_t>(latency(random));
+        histogram.record(v);
+        sum += v;
+    }
+    std::sort(values.begin(), values.end());
+
+    EXPECT_EQ(histogram.count(), values.size());
+    EXPECT_EQ(histogram.max(), values.back());
+    EXPECT_EQ(histogram.mean(), sum / values.size());
+    for (double p : { 1.0, 50.0, 90.0, 99.0, 99.9, 100.0 })
+    {
+        const auto exact = values[std::max<std::size_t>(static_cast<std::size_t>(p / 100.0 * values.size() + 0.5), 1) - 1];
+        const auto reported = histogram.percentile(p);
+        EXPECT_GE(reported, exact) << p;
+        EXPECT_LE(reported, exact + exact / 16 + 1) << p;
+    }
+}
+
+TEST(LatencyHistogram, EmptyAndReset)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(50), 0u);
+    EXPECT_EQ(histogram.mean(), 0u);
+
+    histogram.record(500);
+    EXPECT_EQ(histogram.percentile(50), 500u);
+    histogram.reset();
+    EXPECT_EQ(histogram.count(), 0u);
+    EXPECT_EQ(histogram.max(), 0u);
+    EXPECT_EQ(histogram.percentile(99), 0u);
+}
+
+TEST(LatencyHistogram, RecordsFromSeveralThreads)
+{
+    constexpr int threads = 4;
+    constexpr std::uint64_t records = 50000;
+
+    LatencyHistogram histogram;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t] {
+            for (std::uint64_t i = 0; i < records; i++)
+            {
+                histogram.record(i * threads + t);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(histogram.count(), threads * records);
+    EXPECT_EQ(histogram.max(), threads * records - 1);
+    EXPECT_EQ(histogram.mean(), (threads * records - 1) / 2);
+}
+
+TEST(LatencyStats, ReportHasEveryStage)
+{
+    LatencyStats stats;
+    stats[LatencyStage::Format].record(2500);
+    const auto report = stats.report();
+
+    for (auto stage : { L"Hook", L"Lookup", L"Selection", L"Sort", L"Format", L"Clipboard", L"Total" })
+    {
+        EXPECT_NE(report.find(stage), std::wstring::npos) << stage;
+    }
+    EXPECT_NE(report.find(L"2.5"), std::wstring::npos);
+}
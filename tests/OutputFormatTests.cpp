@@ -0,0 +1,129 @@
+#include <optional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "OutputFormat.hpp"
+#include "TestItems.hpp"
+
+namespace
+{
+    TestItems sampleItems()
+    {
+        TestItems items;
+        items.add(L"readme.txt", L"C:\\Docs\\readme.txt");
+        items.add(L"say \"hi\".md", L"C:\\Docs\\say \"hi\".md");
+        items.add(L".profile", L"C:\\Users\\me\\.profile");
+        items.add(L"archive.tar.gz", L"D:\\archive.tar.gz");
+        return items;
+    }
+
+    std::wstring renderTemplate(std::wstring_view templ, std::wstring_view separator, const TestItems& items)
+    {
+        auto format = OutputFormat::compile(templ, separator);
+        EXPECT_TRUE(format);
+        return format ? render(*format, items) : std::wstring{};
+    }
+}
+
+TEST(OutputFormat, Builtins)
+{
+    auto items = sampleItems();
+    items.names.resize(2);
+    items.paths.resize(2);
+    items.itemFlags.resize(2);
+
+    EXPECT_EQ(render(OutputFormat{ BuiltinFormat::Names }, items), L"readme.txt\nsay \"hi\".md");
+    EXPECT_EQ(render(OutputFormat{ BuiltinFormat::Paths }, items), L"C:\\Docs\\readme.txt\nC:\\Docs\\say \"hi\".md");
+    EXPECT_EQ(render(OutputFormat{ BuiltinFormat::Quoted }, items), L"\"C:\\Docs\\readme.txt\" \"C:\\Docs\\say \"hi\".md\"");
+    EXPECT_EQ(render(OutputFormat{ BuiltinFormat::Csv }, items),
+        L"\"readme.txt\",\"C:\\Docs\\readme.txt\"\r\n\"say \"\"hi\"\".md\",\"C:\\Docs\\say \"\"hi\"\".md\"\r\n");
+    EXPECT_EQ(render(OutputFormat{ BuiltinFormat::Json }, items),
+        L"[\"C:\\\\Docs\\\\readme.txt\",\"C:\\\\Docs\\\\say \\\"hi\\\".md\"]");
+    EXPECT_EQ(render(OutputFormat{ BuiltinFormat::PowerShell }, items),
+        L"\"C:\\Docs\\readme.txt\", \"C:\\Docs\\say `\"hi`\".md\"");
+}
+
+TEST(OutputFormat, EmptySelectionKeepsTheFrame)
+{
+    TestItems items;
+    EXPECT_EQ(render(OutputFormat{ BuiltinFormat::Json }, items), L"[]");
+    EXPECT_EQ(render(OutputFormat{ BuiltinFormat::Names }, items), L"");
+}
+
+TEST(OutputFormat, TemplateFields)
+{
+    auto items = sampleItems();
+    EXPECT_EQ(renderTemplate(L"{dir}|{filename}|{stem}|{ext}", L";", items),
+        L"C:\\Docs|readme.txt|readme|.txt;"
+        L"C:\\Docs|say \"hi\".md|say \"hi\"|.md;"
+        L"C:\\Users\\me|.profile|.profile|;"
+        L"D:|archive.tar.gz|archive.tar|.gz");
+}
+
+TEST(OutputFormat, TemplateEscapesAndBraces)
+{
+    TestItems items;
+    items.add(L"a$b", L"C:\\x\ty\\a$b");
+    EXPECT_EQ(renderTemplate(L"{{{name:powershell}}}", L"\n", items), L"{\"a`$b\"}");
+    EXPECT_EQ(renderTemplate(L"{path:json}", L"\n", items), L"\"C:\\\\x\\ty\\\\a$b\"");
+    EXPECT_EQ(renderTemplate(L"{path:quote}", L"\n", items), L"\"C:\\x\ty\\a$b\"");
+}
+
+TEST(OutputFormat, JsonEscapesControlCharacters)
+{
+    TestItems items;
+    items.add(std::wstring{ L"a\x01" L"b\r\n" }, L"");
+    EXPECT_EQ(renderTemplate(L"{name:json}", L"\n", items), L"\"a\\u0001b\\r\\n\"");
+}
+
+TEST(OutputFormat, MalformedTemplates)
+{
+    EXPECT_FALSE(OutputFormat::compile(L"{name", L"\n"));
+    EXPECT_FALSE(OutputFormat::compile(L"name}", L"\n"));
+    EXPECT_FALSE(OutputFormat::compile(L"{size}", L"\n"));
+    EXPECT_FALSE(OutputFormat::compile(L"{name:xml}", L"\n"));
+    EXPECT_TRUE(OutputFormat::compile(L"", L"\n"));
+}
+
+TEST(OutputFormat, RequiredFields)
+{
+    EXPECT_EQ(OutputFormat{ BuiltinFormat::Names }.requiredFields(), unsigned{ IFF_NAME });
+    EXPECT_EQ(OutputFormat{ BuiltinFormat::Json }.requiredFields(), unsigned{ IFF_PATH });
+    EXPECT_EQ(OutputFormat{ BuiltinFormat::Csv }.requiredFields(), unsigned{ IFF_NAME | IFF_PATH });
+    EXPECT_EQ(OutputFormat::compile(L"{stem}", L"")->requiredFields(), unsigned{ IFF_PATH });
+    EXPECT_EQ(OutputFormat::compile(L"x", L"")->requiredFields(), 0u);
+}
+
+TEST(OutputFormat, TemplateOutlivesItsSource)
+{
+    auto items = sampleItems();
+    std::optional<OutputFormat> format;
+    {
+        std::wstring templ = L"<{name}>";
+        std::wstring separator = L", ";
+        format = OutputFormat::compile(templ, separator);
+    }
+    ASSERT_TRUE(format);
+    auto copy = *format;
+    EXPECT_EQ(render(copy, items), L"<readme.txt>, <say \"hi\".md>, <.profile>, <archive.tar.gz>");
+}
+
+TEST(OutputFormat, RangesConcatenateToTheWhole)
+{
+    auto items = sampleItems();
+    for (auto kind : { BuiltinFormat::Names, BuiltinFormat::Csv, BuiltinFormat::Json, BuiltinFormat::PowerShell })
+    {
+        OutputFormat format{ kind };
+        const auto whole = render(format, items);
+        // Non-empty ranges, as RenderPlan makes them.
+        for (std::size_t split = 1; split < items.size(); split++)
+        {
+            std::wstring text(format.measure(items, 0, split) + format.measure(items, split, items.size()), L'\0');
+            auto end = format.write(items, 0, split, text.data());
+            end = format.write(items, split, items.size(), end);
+            EXPECT_EQ(static_cast<std::size_t>(end - text.data()), text.size());
+            EXPECT_EQ(text, whole);
+        }
+    }
+}
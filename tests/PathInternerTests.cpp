@@ -0,0 +1,69 @@
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "PathInterner.hpp"
+
+TEST(PathInterner, SplitsAfterTheLastSeparator)
+{
+    EXPECT_EQ(leafPosOf(L"C:\\dir\\file.txt"), 7u);
+    EXPECT_EQ(leafPosOf(L"C:/dir/sub/"), 11u);
+    EXPECT_EQ(leafPosOf(L"file.txt"), 0u);
+    EXPECT_EQ(leafPosOf(L""), 0u);
+    EXPECT_EQ(leafPosOf(L"\\\\server\\share"), 9u);
+}
+
+TEST(PathInterner, StoresEachFolderOnce)
+{
+    PathInterner interner;
+    const std::vector<std::wstring> paths{
+        L"C:\\a\\1.txt", L"C:\\a\\2.txt", L"C:\\b\\1.txt", L"C:\\a\\3.txt", L"plain", L"C:\\b\\2.txt", L"other",
+    };
+
+    std::vector<std::uint32_t> ids;
+    for (const auto& path : paths)
+    {
+        auto [id, leaf] = interner.intern(path);
+        EXPECT_EQ(std::wstring{ interner.prefix(id) } + std::wstring{ leaf }, path);
+        ids.push_back(id);
+    }
+    EXPECT_EQ(interner.size(), 3u);
+    EXPECT_EQ(ids, (std::vector<std::uint32_t>{ 0, 0, 1, 0, 2, 1, 2 }));
+    EXPECT_EQ(interner.prefix(0), L"C:\\a\\");
+    EXPECT_EQ(interner.folder(0), L"C:\\a");
+    EXPECT_EQ(interner.prefix(2), L"");
+    EXPECT_EQ(interner.folder(2), L"");
+}
+
+TEST(PathInterner, LeafIsAViewOfThePath)
+{
+    PathInterner interner;
+    const std::wstring path = L"C:\\dir\\name";
+    auto split = interner.intern(path);
+    EXPECT_EQ(split.leaf.data(), path.data() + 7);
+}
+
+TEST(PathInterner, PrefixesSurviveGrowthAndMoves)
+{
+    PathInterner interner;
+    std::vector<std::wstring> folders;
+    for (int i = 0; i < 2000; i++)
+    {
+        // Short folders fit the small string buffer, long ones do not; both must stay put.
+        folders.push_back((i % 2 ? L"C:\\f" : L"C:\\a rather long folder name that is allocated\\") + std::to_wstring(i) + L"\\");
+        interner.intern(folders.back() + L"leaf");
+    }
+    const auto first = interner.prefix(0);
+
+    PathInterner moved = std::move(interner);
+    ASSERT_EQ(moved.size(), folders.size());
+    EXPECT_EQ(moved.prefix(0).data(), first.data());
+    for (std::uint32_t id = 0; id < folders.size(); id++)
+    {
+        ASSERT_EQ(moved.prefix(id), folders[id]);
+    }
+    EXPECT_GT(moved.bytes(), 0u);
+}
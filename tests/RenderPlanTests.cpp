@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "OutputFormat.hpp"
+#include "RenderPlan.hpp"
+#include "SelectionSnapshot.hpp"
+#include "TestItems.hpp"
+
+namespace
+{
+    // Names with the characters the escapes rewrite mixed in, spread over a few folders.
+    TestItems randomItems(std::size_t count, unsigned seed)
+    {
+        constexpr std::wstring_view alphabet = L"abcxyz019 ._-\"\\$`\x201C\x00E9\x4E2D\t"sv;
+        std::mt19937 random{ seed };
+        TestItems items;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            std::wstring name;
+            for (auto length = random() % 24; length > 0; length--)
+            {
+                name.push_back(alphabet[random() % alphabet.size()]);
+            }
+            items.add(name, L"C:\\Folder" + std::to_wstring(random() % 4) + L"\\" + name);
+        }
+        return items;
+    }
+
+    std::vector<OutputFormat> allFormats()
+    {
+        std::vector<OutputFormat> formats;
+        for (auto kind : { BuiltinFormat::Names, BuiltinFormat::Paths, BuiltinFormat::Quoted, BuiltinFormat::Csv,
+                 BuiltinFormat::Json, BuiltinFormat::PowerShell })
+        {
+            formats.emplace_back(kind);
+        }
+        formats.push_back(*OutputFormat::compile(L"{dir:json}/{stem:csv}{ext:powershell} {name:quote}", L"\r\n"));
+        return formats;
+    }
+
+    template <class Items>
+    std::wstring renderPlan(const OutputFormat& format, const Items& items, std::size_t itemsPerChunk, std::size_t& chunks)
+    {
+        RenderPlan plan{ format, items, itemsPerChunk };
+        chunks = plan.chunkCount();
+        // One guard character past the end catches a chunk writing beyond its share.
+        std::wstring text(plan.size() + 1, L'#');
+        auto end = plan.write(text.data());
+        EXPECT_EQ(static_cast<std::size_t>(end - text.data()), plan.size());
+        EXPECT_EQ(text.back(), L'#');
+        text.pop_back();
+        return text;
+    }
+}
+
+TEST(RenderPlan, SerialAndParallelMatchTheFormat)
+{
+    const auto items = randomItems(1000, 1);
+    for (const auto& format : allFormats())
+    {
+        const auto expected = render(format, items);
+        for (std::size_t itemsPerChunk : { 0, 1, 7, 64, 999, 1000, 100000 })
+        {
+            std::size_t chunks{};
+            EXPECT_EQ(renderPlan(format, items, itemsPerChunk, chunks), expected) << "itemsPerChunk=" << itemsPerChunk;
+            EXPECT_EQ(chunks, itemsPerChunk >= 1000 ? 1u : (1000 + std::max<std::size_t>(itemsPerChunk, 1) - 1) / std::max<std::size_t>(itemsPerChunk, 1));
+        }
+    }
+}
+
+TEST(RenderPlan, EmptySelectionIsOneChunk)
+{
+    TestItems items;
+    for (const auto& format : allFormats())
+    {
+        std::size_t chunks{};
+        EXPECT_EQ(renderPlan(format, items, 16, chunks), render(format, items));
+        EXPECT_EQ(chunks, 1u);
+    }
+}
+
+TEST(RenderPlan, SnapshotRendersLikeThePlainItems)
+{
+    const auto items = randomItems(5000, 2);
+    SelectionSnapshot snapshot;
+    for (std::size_t i = 0; i < items.size(); i++)
+    {
+        snapshot.append(items.name(i), items.path(i), SIF_NAME | SIF_PATH);
+    }
+
+    for (const auto& format : allFormats())
+    {
+        const auto expected = render(format, items);
+        std::size_t chunks{};
+        EXPECT_EQ(renderPlan(format, snapshot, 5000, chunks), expected);
+        EXPECT_EQ(renderPlan(format, snapshot, 128, chunks), expected);
+        EXPECT_GT(chunks, 1u);
+    }
+}
@@ -0,0 +1,158 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SelectionDiffCache.hpp"
+
+namespace
+{
+    // Resolves a key to its upper-case form and remembers which keys it was asked for.
+    struct FakeResolver
+    {
+        const std::vector<std::string>* keys{};
+        std::vector<std::string> resolved;
+
+        std::string operator()(std::size_t i)
+        {
+            resolved.push_back((*keys)[i]);
+            std::string value = (*keys)[i];
+            for (auto& c : value)
+            {
+                c = static_cast<char>(c - 'a' + 'A');
+            }
+            return value;
+        }
+    };
+
+    std::vector<std::string> valuesOf(const SelectionDiffCache<std::string>& cache)
+    {
+        std::vector<std::string> values;
+        for (std::size_t i = 0; i < cache.size(); i++)
+        {
+            values.push_back(cache[i]);
+        }
+        return values;
+    }
+
+    using Strings = std::vector<std::string>;
+}
+
+TEST(SelectionDiffCache, ResolvesOnlyNewItems)
+{
+    SelectionDiffCache<std::string> cache;
+    FakeResolver resolver;
+
+    const Strings first{ "a", "b", "c" };
+    resolver.keys = &first;
+    auto stats = cache.update(first, resolver);
+    EXPECT_EQ(stats.resolved, 3u);
+    EXPECT_EQ(stats.reused, 0u);
+    EXPECT_EQ(valuesOf(cache), (Strings{ "A", "B", "C" }));
+
+    const Strings second{ "c", "d", "a" };
+    resolver.keys = &second;
+    resolver.resolved.clear();
+    stats = cache.update(second, resolver);
+    EXPECT_EQ(resolver.resolved, (Strings{ "d" }));
+    EXPECT_EQ(stats.reused, 2u);
+    EXPECT_EQ(stats.resolved, 1u);
+    EXPECT_EQ(stats.evicted, 1u);
+    EXPECT_FALSE(stats.cancelled);
+    EXPECT_EQ(valuesOf(cache), (Strings{ "C", "D", "A" }));
+}
+
+TEST(SelectionDiffCache, EvictedItemsAreResolvedAgain)
+{
+    SelectionDiffCache<std::string> cache;
+    FakeResolver resolver;
+
+    const Strings first{ "a", "b" };
+    const Strings second{ "b" };
+    resolver.keys = &first;
+    cache.update(first, resolver);
+    resolver.keys = &second;
+    cache.update(second, resolver);
+    resolver.keys = &first;
+    resolver.resolved.clear();
+    cache.update(first, resolver);
+    EXPECT_EQ(resolver.resolved, (Strings{ "a" }));
+}
+
+TEST(SelectionDiffCache, KeysAreComparedByBytes)
+{
+    // Keys are ID lists: binary, with embedded NULs.
+    const Strings keys{ std::string("a\0b", 3), std::string("a\0c", 3), std::string("a", 1) };
+    SelectionDiffCache<std::string> cache;
+    std::size_t resolved = 0;
+    cache.update(keys, [&](std::size_t i) { resolved++; return std::to_string(i); });
+    EXPECT_EQ(resolved, 3u);
+    EXPECT_EQ(valuesOf(cache), (Strings{ "0", "1", "2" }));
+
+    const auto stats = cache.update(keys, [&](std::size_t i) { resolved++; return std::to_string(i); });
+    EXPECT_EQ(stats.reused, 3u);
+    EXPECT_EQ(resolved, 3u);
+}
+
+TEST(SelectionDiffCache, CancelledUpdateKeepsWhatWasResolved)
+{
+    SelectionDiffCache<std::string> cache;
+    FakeResolver resolver;
+
+    const Strings first{ "a", "b" };
+    resolver.keys = &first;
+    cache.update(first, resolver);
+
+    // Cancelled before the third new item: "c" and "d" are resolved, "e" and "f" are not.
+    const Strings second{ "a", "c", "d", "e", "f" };
+    resolver.keys = &second;
+    resolver.resolved.clear();
+    int asked = 0;
+    auto stats = cache.update(second, resolver, [&] { return ++asked > 2; });
+    EXPECT_TRUE(stats.cancelled);
+    EXPECT_EQ(stats.resolved, 2u);
+    EXPECT_EQ(stats.evicted, 0u);
+    EXPECT_TRUE(cache.empty());
+
+    // The next update resolves only what the cancelled one did not reach, and still evicts "b".
+    resolver.resolved.clear();
+    stats = cache.update(second, resolver);
+    EXPECT_FALSE(stats.cancelled);
+    EXPECT_EQ(resolver.resolved, (Strings{ "e", "f" }));
+    EXPECT_EQ(stats.reused, 3u);
+    EXPECT_EQ(stats.evicted, 1u);
+    EXPECT_EQ(valuesOf(cache), (Strings{ "A", "C", "D", "E", "F" }));
+}
+
+TEST(SelectionDiffCache, CancellationIsNotAskedForReusedItems)
+{
+    SelectionDiffCache<std::string> cache;
+    FakeResolver resolver;
+
+    const Strings keys{ "a", "b", "c" };
+    resolver.keys = &keys;
+    cache.update(keys, resolver);
+
+    int asked = 0;
+    const auto stats = cache.update(keys, resolver, [&] { asked++; return true; });
+    EXPECT_EQ(asked, 0);
+    EXPECT_FALSE(stats.cancelled);
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST(SelectionDiffCache, ClearForgetsEverything)
+{
+    SelectionDiffCache<std::string> cache;
+    FakeResolver resolver;
+
+    const Strings keys{ "a" };
+    resolver.keys = &keys;
+    cache.update(keys, resolver);
+    cache.clear();
+    EXPECT_TRUE(cache.empty());
+
+    resolver.resolved.clear();
+    cache.update(keys, resolver);
+    EXPECT_EQ(resolver.resolved, keys);
+}
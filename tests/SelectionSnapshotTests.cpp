@@ -0,0 +1,70 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SelectionSnapshot.hpp"
+
+TEST(SelectionSnapshot, KeepsItemsInOrder)
+{
+    SelectionSnapshot snapshot;
+    snapshot.reserve(4, 64);
+    snapshot.append(L"a.txt", L"C:\\Docs\\a.txt", SIF_NAME | SIF_PATH | SIF_FILESYSTEM);
+    snapshot.append(L"Control Panel", L"::{26EE0668-A00A-44D7-9371-BEB064C98683}", SIF_NAME | SIF_PATH);
+    snapshot.append(L"b.txt", L"C:\\Docs\\b.txt", SIF_NAME | SIF_PATH | SIF_FILESYSTEM);
+    snapshot.append(L"", L"", 0);
+
+    ASSERT_EQ(snapshot.size(), 4u);
+    EXPECT_EQ(snapshot.name(0), L"a.txt");
+    EXPECT_EQ(snapshot.name(1), L"Control Panel");
+    EXPECT_EQ(snapshot.name(3), L"");
+
+    auto [prefix, leaf] = snapshot.pathParts(2);
+    EXPECT_EQ(prefix, L"C:\\Docs\\");
+    EXPECT_EQ(leaf, L"b.txt");
+    EXPECT_EQ(snapshot.pathParts(1).first, L"");
+    EXPECT_EQ(snapshot.pathParts(1).second, L"::{26EE0668-A00A-44D7-9371-BEB064C98683}");
+
+    EXPECT_EQ(snapshot.flags(1), SIF_NAME | SIF_PATH);
+    EXPECT_EQ(snapshot.flags(3), 0);
+}
+
+TEST(SelectionSnapshot, InternsParentFolders)
+{
+    SelectionSnapshot snapshot;
+    for (int i = 0; i < 1000; i++)
+    {
+        const auto name = L"file" + std::to_wstring(i);
+        snapshot.append(name, (i % 10 == 0 ? L"D:\\other\\" : L"C:\\Docs\\") + name, SIF_NAME | SIF_PATH);
+    }
+
+    EXPECT_EQ(snapshot.folderCount(), 2u);
+    EXPECT_EQ(snapshot.folder(snapshot.parentId(0)), L"D:\\other");
+    EXPECT_EQ(snapshot.folder(snapshot.parentId(1)), L"C:\\Docs");
+    for (std::size_t i = 0; i < snapshot.size(); i++)
+    {
+        auto [prefix, leaf] = snapshot.pathParts(i);
+        ASSERT_EQ(leaf, snapshot.name(i));
+        ASSERT_EQ(prefix, i % 10 == 0 ? L"D:\\other\\" : L"C:\\Docs\\");
+    }
+}
+
+TEST(SelectionSnapshot, ViewsStayValidAsTheArenaGrows)
+{
+    // Items are read back by offset, so growing the arena past its reservation must not matter.
+    SelectionSnapshot snapshot;
+    snapshot.reserve(1, 1);
+    std::vector<std::wstring> names;
+    for (int i = 0; i < 5000; i++)
+    {
+        names.push_back(std::wstring(static_cast<std::size_t>(i % 50 + 1), static_cast<wchar_t>(L'a' + i % 26)));
+        snapshot.append(names.back(), L"C:\\x\\" + names.back(), SIF_NAME | SIF_PATH);
+    }
+    for (std::size_t i = 0; i < names.size(); i++)
+    {
+        ASSERT_EQ(snapshot.name(i), names[i]);
+        ASSERT_EQ(snapshot.pathParts(i).second, names[i]);
+    }
+    EXPECT_GT(snapshot.bytes(), 0u);
+}
@@ -0,0 +1,189 @@
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "ShellWindowIndex.hpp"
+#include "SimulatedShell.hpp"
+
+namespace
+{
+    using Index = ShellWindowIndex<SimulatedShellWindows>;
+}
+
+TEST(ShellWindowIndex, RebuildFindsEveryWindow)
+{
+    Index index{ 3u, 0u };
+    index.rebuild();
+    EXPECT_EQ(index.size(), 3u);
+    for (std::uint32_t i = 0; i < 3; i++)
+    {
+        auto entry = index.find(SimulatedShellWindows::windowOf(i));
+        ASSERT_TRUE(entry);
+        EXPECT_EQ(*entry, i);
+    }
+    EXPECT_EQ(index.backend().runPosted(), 0u);
+}
+
+TEST(ShellWindowIndex, RegistrationAddsTheNewWindow)
+{
+    Index index{ 2u, 0u };
+    index.rebuild();
+
+    auto cookie = index.backend().open();
+    index.onRegistered(cookie);
+    EXPECT_EQ(index.size(), 2u); // resolved on the posted work
+    EXPECT_EQ(index.backend().runPosted(), 1u);
+    EXPECT_EQ(index.size(), 3u);
+    auto entry = index.find(SimulatedShellWindows::windowOf(2));
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(*entry, 2u);
+}
+
+TEST(ShellWindowIndex, RegistrationFindsTheWindowAnywhereInTheEnumeration)
+{
+    Index index{ 3u, 0u };
+    index.rebuild();
+
+    // Not the last window of IShellWindows: the cookie must still name the new one.
+    auto cookie = index.backend().open(1);
+    index.onRegistered(cookie);
+    index.backend().runPosted();
+    ASSERT_EQ(index.size(), 4u);
+
+    index.backend().close(cookie, false);
+    index.onRevoked(cookie);
+    EXPECT_EQ(index.size(), 3u);
+    EXPECT_FALSE(index.find(SimulatedShellWindows::windowOf(3)));
+    EXPECT_TRUE(index.find(SimulatedShellWindows::windowOf(2)));
+}
+
+TEST(ShellWindowIndex, RegistrationsThatArriveTogetherAddEveryWindow)
+{
+    Index index{ 1u, 0u };
+    index.rebuild();
+
+    auto first = index.backend().open(0);
+    auto second = index.backend().open();
+    index.onRegistered(first);
+    index.onRegistered(second);
+    index.backend().runPosted();
+    EXPECT_EQ(index.size(), 3u);
+
+    // Which cookie is whose is unknown, so revoking falls back to dropping destroyed windows.
+    index.backend().close(first);
+    index.onRevoked(first);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_FALSE(index.find(SimulatedShellWindows::windowOf(1)));
+    EXPECT_TRUE(index.find(SimulatedShellWindows::windowOf(2)));
+}
+
+TEST(ShellWindowIndex, RevocationEvictsByCookie)
+{
+    Index index{ 1u, 0u };
+    index.rebuild();
+
+    auto first = index.backend().open();
+    index.onRegistered(first);
+    index.backend().runPosted();
+    auto second = index.backend().open();
+    index.onRegistered(second);
+    index.backend().runPosted();
+    ASSERT_EQ(index.size(), 3u);
+
+    // The window is still there when the revocation arrives; the cookie alone identifies it.
+    index.backend().close(first, false);
+    index.onRevoked(first);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_TRUE(index.find(SimulatedShellWindows::windowOf(0)));
+    EXPECT_TRUE(index.find(SimulatedShellWindows::windowOf(2)));
+    EXPECT_EQ(index.backend().runPosted(), 0u);
+}
+
+TEST(ShellWindowIndex, UnknownRevocationDropsDestroyedWindows)
+{
+    // Windows found by enumeration have no cookie to match.
+    Index index{ 3u, 0u };
+    index.rebuild();
+
+    index.backend().close(2);
+    index.onRevoked(2);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_TRUE(index.find(SimulatedShellWindows::windowOf(0)));
+    EXPECT_TRUE(index.find(SimulatedShellWindows::windowOf(2)));
+    EXPECT_EQ(index.backend().runPosted(), 0u);
+}
+
+TEST(ShellWindowIndex, MissRebuildsAndLooksAgain)
+{
+    Index index{ 1u, 0u };
+    index.rebuild();
+
+    // Opened without the registration event reaching the index: the first copy in it still finds it.
+    index.backend().open();
+    const auto window = SimulatedShellWindows::windowOf(1);
+    auto entry = index.find(window);
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(*entry, 1u);
+    EXPECT_EQ(index.size(), 2u);
+
+    EXPECT_FALSE(index.find(SimulatedShellWindows::windowOf(7)));
+    EXPECT_EQ(index.backend().runPosted(), 0u);
+}
+
+TEST(ShellWindowIndex, RegistrationOfAnUnknownCookieAddsNothing)
+{
+    Index index{ 1u, 0u };
+    index.rebuild();
+
+    index.onRegistered(42);
+    index.backend().runPosted();
+    EXPECT_EQ(index.size(), 1u);
+}
+
+TEST(ShellWindowIndex, RebuildKeepsWindowsRegisteredWhileItEnumerates)
+{
+    Index index{ 2u, 0u };
+    index.rebuild();
+
+    // The registration is resolved after the rebuild read the windows, before it takes the lock.
+    long cookie{};
+    index.backend().duringEnumerate = [&] {
+        cookie = index.backend().open();
+        index.onRegistered(cookie);
+        index.backend().runPosted();
+    };
+    index.rebuild();
+    EXPECT_EQ(index.size(), 3u);
+    EXPECT_TRUE(index.find(SimulatedShellWindows::windowOf(2)));
+
+    // Its cookie survived as well.
+    index.backend().close(cookie, false);
+    index.onRevoked(cookie);
+    EXPECT_EQ(index.size(), 2u);
+}
+
+TEST(ShellWindowIndex, RebuildKeepsCookiesOfOpenWindows)
+{
+    Index index{ 0u, 0u };
+    auto a = index.backend().open();
+    index.onRegistered(a);
+    index.backend().runPosted();
+    auto b = index.backend().open();
+    index.onRegistered(b);
+    index.backend().runPosted();
+
+    index.rebuild();
+    index.backend().close(b, false);
+    index.onRevoked(b);
+    EXPECT_EQ(index.size(), 1u);
+    EXPECT_TRUE(index.find(SimulatedShellWindows::windowOf(0)));
+    EXPECT_EQ(index.backend().runPosted(), 0u);
+}
+
+TEST(ShellWindowIndex, ClearEmptiesTheIndex)
+{
+    Index index{ 4u, 0u };
+    index.rebuild();
+    index.clear();
+    EXPECT_EQ(index.size(), 0u);
+}
@@ -0,0 +1,83 @@
+#include <clocale>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SortOrder.hpp"
+#include "TestItems.hpp"
+
+namespace
+{
+    // Non-ASCII letters fold only in a locale that knows them, as the benchmark sets up.
+    class SortOrder : public testing::Test
+    {
+    protected:
+        static void SetUpTestSuite() { std::setlocale(LC_CTYPE, "C.UTF-8"); }
+        static void TearDownTestSuite() { std::setlocale(LC_CTYPE, "C"); }
+    };
+
+    std::vector<std::wstring> sorted(SortMode mode, const std::vector<std::wstring>& names, std::size_t itemsPerChunk = 16384)
+    {
+        auto order = sortedOrder(names.size(), itemsPerChunk, [&](std::size_t i, std::vector<wchar_t>& key) {
+            appendSortKey(mode, names[i], key);
+        });
+        std::vector<std::wstring> result;
+        for (auto i : order)
+        {
+            result.push_back(names[i]);
+        }
+        return result;
+    }
+
+    using Names = std::vector<std::wstring>;
+}
+
+TEST_F(SortOrder, NameIgnoresCase)
+{
+    EXPECT_EQ(sorted(SortMode::Name, { L"b.txt", L"A.txt", L"a.txt", L"C.txt" }),
+        (Names{ L"A.txt", L"a.txt", L"b.txt", L"C.txt" }));
+}
+
+TEST_F(SortOrder, NameFoldsBeyondAscii)
+{
+    EXPECT_EQ(sorted(SortMode::Name, { L"\u00E9t\u00E9", L"\u00C9T\u00C9", L"\u0431", L"\u0410" }),
+        (Names{ L"\u00E9t\u00E9", L"\u00C9T\u00C9", L"\u0410", L"\u0431" }));
+}
+
+TEST_F(SortOrder, NaturalComparesNumbersByValue)
+{
+    EXPECT_EQ(sorted(SortMode::Natural, { L"file10", L"file2", L"File1", L"file02b", L"file", L"file002" }),
+        (Names{ L"file", L"File1", L"file2", L"file002", L"file02b", L"file10" }));
+}
+
+TEST_F(SortOrder, ExtensionThenNatural)
+{
+    EXPECT_EQ(sorted(SortMode::Extension, { L"b10.txt", L"a.md", L"b9.TXT", L"noext", L".profile" }),
+        (Names{ L".profile", L"noext", L"a.md", L"b9.TXT", L"b10.txt" }));
+}
+
+TEST_F(SortOrder, ParallelMatchesSequential)
+{
+    Names names;
+    for (int i = 0; i < 5000; i++)
+    {
+        names.push_back(L"item" + std::to_wstring((i * 7919) % 1000) + (i % 3 ? L".txt" : L".MD"));
+    }
+    for (auto mode : { SortMode::Name, SortMode::Natural, SortMode::Extension })
+    {
+        EXPECT_EQ(sorted(mode, names, 64), sorted(mode, names)) << static_cast<int>(mode);
+    }
+}
+
+TEST_F(SortOrder, SortedItemsFollowTheOrder)
+{
+    TestItems items;
+    items.add(L"b", L"C:\\x\\b");
+    items.add(L"a", L"C:\\x\\a");
+    SortedItems view{ items, { 1, 0 } };
+    EXPECT_EQ(view.name(0), L"a");
+    EXPECT_EQ(view.pathParts(1).second, L"b");
+    EXPECT_EQ(sortTextOf(items, 0), L"b");
+}
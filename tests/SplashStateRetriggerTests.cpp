@@ -0,0 +1,104 @@
+// Showing, hiding and retriggering the splash; the fade-out is tested in SplashStateTests.cpp.
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SplashState.hpp"
+
+namespace
+{
+    using Action = SplashState::Action;
+
+    // The clock the splash window would read; tests move it by hand.
+    struct FakeClock
+    {
+        std::uint64_t now = 1000;
+
+        std::uint64_t advance(std::uint64_t ms) noexcept
+        {
+            return now += ms;
+        }
+    };
+}
+
+TEST(SplashState, ShowsOnceAndHidesAtTheDeadline)
+{
+    FakeClock clock;
+    SplashState state{ 500 };
+
+    EXPECT_EQ(state.trigger(clock.now), Action::Show);
+    EXPECT_TRUE(state.visible());
+    EXPECT_EQ(state.deadline(), clock.now + 500);
+
+    EXPECT_EQ(state.expire(clock.advance(499)), Action::None);
+    EXPECT_EQ(state.expire(clock.advance(1)), Action::Hide);
+    EXPECT_FALSE(state.visible());
+    EXPECT_EQ(state.framesRendered(), 1u);
+    EXPECT_EQ(state.expire(clock.advance(1000)), Action::None);
+}
+
+TEST(SplashState, RetriggersWhileVisibleOnlyMoveTheDeadline)
+{
+    FakeClock clock;
+    SplashState state{ 500 };
+
+    EXPECT_EQ(state.trigger(clock.now), Action::Show);
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(state.trigger(clock.advance(100)), Action::Reposition);
+    }
+    EXPECT_EQ(state.framesRendered(), 1u);
+
+    // The timer set by the first trigger fires; the deadline has moved on since.
+    EXPECT_EQ(state.expire(1500), Action::None);
+    EXPECT_EQ(state.expire(clock.advance(500)), Action::Hide);
+}
+
+TEST(SplashState, RapidFireRetriggersShowOnceAndHideOnce)
+{
+    FakeClock clock;
+    SplashState state{ 500 };
+
+    // A copy every millisecond, with the countdown of each earlier copy still firing when it comes due,
+    // as if the window's timer had not been restarted.
+    std::vector<std::uint64_t> deadlines;
+    int shows = 0;
+    int repositions = 0;
+    for (int i = 0; i < 2000; i++)
+    {
+        const auto now = clock.advance(1);
+        const auto action = state.trigger(now);
+        shows += action == Action::Show;
+        repositions += action == Action::Reposition;
+        deadlines.push_back(state.deadline());
+        while (!deadlines.empty() && deadlines.front() <= now)
+        {
+            ASSERT_EQ(state.expire(deadlines.front()), Action::None) << i;
+            deadlines.erase(deadlines.begin());
+        }
+    }
+    EXPECT_EQ(shows, 1);
+    EXPECT_EQ(repositions, 1999);
+    EXPECT_EQ(state.framesRendered(), 1u);
+    EXPECT_EQ(state.deadline(), clock.now + 500);
+
+    // The burst is over: only the last countdown hides, and the next copy shows the same window again.
+    EXPECT_EQ(state.expire(clock.advance(499)), Action::None);
+    EXPECT_EQ(state.expire(clock.advance(1)), Action::Hide);
+    EXPECT_EQ(state.expire(clock.advance(1)), Action::None);
+    EXPECT_EQ(state.trigger(clock.advance(1)), Action::Show);
+    EXPECT_EQ(state.framesRendered(), 1u);
+}
+
+TEST(SplashState, DismissHidesOnce)
+{
+    FakeClock clock;
+    SplashState state{ 500 };
+
+    EXPECT_EQ(state.dismiss(), Action::None);
+    state.trigger(clock.now);
+    EXPECT_EQ(state.dismiss(), Action::Hide);
+    EXPECT_EQ(state.dismiss(), Action::None);
+    EXPECT_EQ(state.expire(clock.advance(500)), Action::None);
+}
@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "SplashState.hpp"
+
+namespace
+{
+    using Action = SplashState::Action;
+
+    // The clock the splash window would read; tests move it by hand.
+    struct FakeClock
+    {
+        std::uint64_t now = 1000;
+
+        std::uint64_t advance(std::uint64_t ms) noexcept
+        {
+            return now += ms;
+        }
+    };
+
+    // What SplashWindow does from the fade-out on: pulls a frame every frameInterval and expires the state
+    // when the timer fires. Returns the opacities rendered.
+    std::vector<std::uint8_t> runFade(SplashState& state, FakeClock& clock, std::uint64_t refreshPeriod)
+    {
+        std::vector<std::uint8_t> frames;
+        const auto interval = state.frameInterval(refreshPeriod);
+        while (state.fading())
+        {
+            if (auto alpha = state.fadeFrame(clock.now + refreshPeriod))
+                frames.push_back(*alpha);
+            clock.advance(interval);
+            if (state.expire(clock.now) == Action::Hide)
+                break;
+        }
+        return frames;
+    }
+}
+
+TEST(SplashState, FadeStaysWithinTheFrameBudget)
+{
+    for (unsigned budget : { 1u, 2u, 4u, 8u, 60u })
+    {
+        FakeClock clock;
+        SplashState state{ 500, 300, budget };
+
+        ASSERT_EQ(state.trigger(clock.now), Action::Show);
+        const auto expected = budget > 1 ? Action::Fade : Action::Hide;
+        ASSERT_EQ(state.expire(clock.advance(500)), expected) << budget;
+
+        const auto frames = runFade(state, clock, 16);
+        EXPECT_FALSE(state.visible()) << budget;
+        EXPECT_LE(state.framesRendered(), budget);
+        EXPECT_EQ(frames.size() + 1, state.framesRendered());
+        for (std::size_t i = 1; i < frames.size(); i++)
+        {
+            EXPECT_LT(frames[i], frames[i - 1]) << budget;
+        }
+    }
+}
+
+TEST(SplashState, FadeEndsWhenItsTimeIsUp)
+{
+    FakeClock clock;
+    SplashState state{ 500, 300, 8 };
+
+    state.trigger(clock.now);
+    ASSERT_EQ(state.expire(clock.advance(500)), Action::Fade);
+    EXPECT_EQ(state.expire(clock.advance(299)), Action::None);
+    EXPECT_EQ(state.expire(clock.advance(1)), Action::Hide);
+}
+
+TEST(SplashState, RetriggerDuringFadeShowsOpaqueAgain)
+{
+    FakeClock clock;
+    SplashState state{ 500, 300, 8 };
+
+    state.trigger(clock.now);
+    ASSERT_EQ(state.expire(clock.advance(500)), Action::Fade);
+    ASSERT_TRUE(state.fadeFrame(clock.advance(100)).has_value());
+
+    EXPECT_EQ(state.trigger(clock.now), Action::Show);
+    EXPECT_FALSE(state.fading());
+    EXPECT_EQ(state.framesRendered(), 1u);
+    EXPECT_FALSE(state.fadeFrame(clock.now).has_value());
+    EXPECT_EQ(state.expire(clock.advance(500)), Action::Fade);
+}
+
+TEST(SplashState, FadeSkipsFramesThatChangeNothing)
+{
+    FakeClock clock;
+    SplashState state{ 500, 300, 8 };
+
+    state.trigger(clock.now);
+    ASSERT_EQ(state.expire(clock.advance(500)), Action::Fade);
+    // Presented at the start of the fade, the frame would still be opaque.
+    EXPECT_FALSE(state.fadeFrame(clock.now).has_value());
+    EXPECT_EQ(state.fadeFrame(clock.now + 300), std::optional<std::uint8_t>{ 0 });
+    EXPECT_FALSE(state.fadeFrame(clock.now + 400).has_value());
+}
+
+TEST(SplashState, FrameIntervalSpreadsTheBudgetButNotFasterThanTheDisplay)
+{
+    EXPECT_EQ(SplashState(500, 300, 4).frameInterval(16), 100u);
+    EXPECT_EQ(SplashState(500, 300, 61).frameInterval(16), 16u);
+    EXPECT_EQ(SplashState(500, 300, 1).frameInterval(16), 300u);
+    EXPECT_EQ(SplashState(500, 0, 8).frameInterval(0), 1u);
+}
@@ -0,0 +1,110 @@
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "SpscQueue.hpp"
+
+namespace
+{
+    // Two fields written separately, so that a torn or stale slot shows up as a mismatch.
+    struct Item
+    {
+        std::uint64_t sequence;
+        std::uint64_t check;
+    };
+
+    constexpr std::uint64_t checkOf(std::uint64_t sequence) noexcept
+    {
+        return sequence * 0x9E3779B97F4A7C15ull;
+    }
+
+    template <std::size_t Capacity>
+    void stress(std::uint64_t count)
+    {
+        SpscQueue<Item, Capacity> queue;
+        std::uint64_t expected = 0;
+        bool ordered = true;
+        std::thread consumer{ [&] {
+            Item item{};
+            while (expected < count)
+            {
+                if (!queue.try_pop(item))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                ordered = ordered && item.sequence == expected && item.check == checkOf(expected);
+                expected++;
+            }
+        } };
+
+        for (std::uint64_t i = 0; i < count; i++)
+        {
+            while (!queue.try_push({ i, checkOf(i) }))
+            {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+
+        EXPECT_TRUE(ordered);
+        EXPECT_EQ(expected, count);
+        EXPECT_TRUE(queue.empty());
+    }
+}
+
+TEST(SpscQueue, PushFailsWhenFullAndPopWhenEmpty)
+{
+    SpscQueue<int, 4> queue;
+    int item{};
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.try_pop(item));
+
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_FALSE(queue.try_push(4));
+
+    for (int i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(queue.try_pop(item));
+        EXPECT_EQ(item, i);
+    }
+    EXPECT_FALSE(queue.try_pop(item));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueue, WrapsAroundTheRing)
+{
+    SpscQueue<int, 2> queue;
+    int item{};
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_TRUE(queue.try_push(i));
+        ASSERT_TRUE(queue.try_push(-i));
+        ASSERT_TRUE(queue.try_pop(item));
+        EXPECT_EQ(item, i);
+        ASSERT_TRUE(queue.try_pop(item));
+        EXPECT_EQ(item, -i);
+    }
+}
+
+TEST(SpscQueue, StressSmallRing)
+{
+    stress<2>(200000);
+}
+
+TEST(SpscQueue, StressWorkerRing)
+{
+    // The capacity CopyWorker uses.
+    stress<16>(1000000);
+}
+
+TEST(SpscQueue, StressTraceRing)
+{
+    // The capacity of a Trace ring.
+    stress<1024>(1000000);
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "OutputFormat.hpp"
+#include "SelectionSnapshot.hpp"
+
+namespace
+{
+    // The Items interface of OutputFormat over plain strings: the path is split where it is asked for.
+    // Items are file system items unless added with other SelectionItemFlags.
+    struct TestItems
+    {
+        std::vector<std::wstring> names;
+        std::vector<std::wstring> paths;
+        std::vector<std::uint8_t> itemFlags;
+
+        void add(std::wstring name, std::wstring path, std::uint8_t flags = SIF_NAME | SIF_PATH | SIF_FILESYSTEM)
+        {
+            names.push_back(std::move(name));
+            paths.push_back(std::move(path));
+            itemFlags.push_back(flags);
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept { return names.size(); }
+        [[nodiscard]] bool empty() const noexcept { return names.empty(); }
+        [[nodiscard]] std::wstring_view name(std::size_t i) const noexcept { return names[i]; }
+        [[nodiscard]] std::wstring_view path(std::size_t i) const noexcept { return paths[i]; }
+        [[nodiscard]] std::uint8_t flags(std::size_t i) const noexcept { return itemFlags[i]; }
+    };
+
+    // The whole selection rendered in one piece, the way the formats are specified.
+    template <class Items>
+    std::wstring render(const OutputFormat& format, const Items& items)
+    {
+        std::wstring text(format.measure(items, 0, items.size()), L'\0');
+        auto end = format.write(items, 0, items.size(), text.data());
+        text.resize(static_cast<std::size_t>(end - text.data()));
+        return text;
+    }
+}
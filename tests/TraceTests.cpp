@@ -0,0 +1,128 @@
+#define QFC_TRACE_LEVEL 2
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Trace.hpp"
+
+namespace
+{
+    // Runs the log for the lifetime of the object and collects what it writes.
+    class CollectedTrace
+    {
+        std::mutex m_mutex;
+        std::vector<std::string> m_lines;
+
+    public:
+        CollectedTrace()
+        {
+            TraceLog::instance().start([this](const std::string& line) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_lines.push_back(line);
+            });
+        }
+
+        ~CollectedTrace()
+        {
+            TraceLog::instance().stop();
+        }
+
+        std::vector<std::string> stop()
+        {
+            TraceLog::instance().stop();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_lines;
+        }
+    };
+
+    std::size_t countContaining(const std::vector<std::string>& lines, const std::string& text)
+    {
+        std::size_t count = 0;
+        for (const auto& line : lines)
+        {
+            count += line.find(text) != std::string::npos;
+        }
+        return count;
+    }
+}
+
+TEST(Trace, FormatsArgumentsWithSiteAndMicroseconds)
+{
+    CollectedTrace trace;
+    enum class Mode : std::uint8_t { Copy = 3 };
+    DBGPRINTLN("copied {} items in mode {} to {:x}", 42, Mode::Copy, 0xBEEFu);
+    TRACE();
+    const auto lines = trace.stop();
+
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_NE(lines[0].find("TraceTests.cpp("), std::string::npos);
+    EXPECT_NE(lines[0].find(": copied 42 items in mode 3 to beef\n"), std::string::npos);
+    EXPECT_NE(lines[0].find("us] "), std::string::npos);
+    EXPECT_NE(lines[1].find(": enter\n"), std::string::npos);
+}
+
+TEST(Trace, TimestampsAreMicrosecondsSinceStart)
+{
+    CollectedTrace trace;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    DBGPRINTLN("late");
+    const auto lines = trace.stop();
+
+    ASSERT_EQ(lines.size(), 1u);
+    const auto open = lines[0].find(": [");
+    ASSERT_NE(open, std::string::npos);
+    const double us = std::stod(lines[0].substr(open + 3));
+    EXPECT_GE(us, 20000.0);
+    EXPECT_LT(us, 20000000.0);
+}
+
+TEST(Trace, BadFormatIsReportedInsteadOfEndingTheFlusher)
+{
+    CollectedTrace trace;
+    // A site whose format does not match its arguments, which QFC_TRACE_RECORD would not compile.
+    static constexpr TraceSite site{ __FILE__, __LINE__, "test", "{} and {}" };
+    TraceLog::record(site, "{}", 1);
+    DBGPRINTLN("still {}", 2);
+    const auto lines = trace.stop();
+
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_NE(lines[0].find("bad trace format \"{} and {}\""), std::string::npos);
+    EXPECT_NE(lines[1].find(": still 2\n"), std::string::npos);
+}
+
+TEST(Trace, CollectsEveryThread)
+{
+    constexpr int threads = 4;
+    constexpr int records = 200;
+
+    CollectedTrace trace;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([t] {
+            TraceLog::prepareThread();
+            for (int i = 0; i < records; i++)
+            {
+                DBGPRINTLN("worker {} record {}", t, i);
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    const auto lines = trace.stop();
+
+    // Each ring holds more than one thread writes, so nothing is dropped.
+    EXPECT_EQ(countContaining(lines, "dropped"), 0u);
+    EXPECT_EQ(countContaining(lines, ": worker "), static_cast<std::size_t>(threads * records));
+    for (int t = 0; t < threads; t++)
+    {
+        EXPECT_EQ(countContaining(lines, std::format(": worker {} record {}\n", t, records - 1)), 1u);
+    }
+}
@@ -0,0 +1,154 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Utf8Transcode.hpp"
+
+namespace
+{
+    // The transcoder spelled out the long way: decode UTF-16 with unpaired surrogates as U+FFFD, then encode.
+    std::string referenceUtf8(const std::u16string& s)
+    {
+        std::string out;
+        for (std::size_t i = 0; i < s.size(); i++)
+        {
+            std::uint32_t c = s[i];
+            if (c >= 0xD800 && c <= 0xDBFF && i + 1 < s.size() && s[i + 1] >= 0xDC00 && s[i + 1] <= 0xDFFF)
+                c = 0x10000 + ((c - 0xD800) << 10) + (s[++i] - 0xDC00);
+            else if (c >= 0xD800 && c <= 0xDFFF)
+                c = 0xFFFD;
+
+            if (c < 0x80)
+            {
+                out += static_cast<char>(c);
+            }
+            else if (c < 0x800)
+            {
+                out += static_cast<char>(0xC0 | (c >> 6));
+                out += static_cast<char>(0x80 | (c & 0x3F));
+            }
+            else if (c < 0x10000)
+            {
+                out += static_cast<char>(0xE0 | (c >> 12));
+                out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (c & 0x3F));
+            }
+            else
+            {
+                out += static_cast<char>(0xF0 | (c >> 18));
+                out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (c & 0x3F));
+            }
+        }
+        return out;
+    }
+
+    // Runs of one script at a time, the way names are written, with the odd stray unit.
+    std::u16string randomText(std::mt19937& random, std::size_t length)
+    {
+        struct Range { char16_t first, last; };
+        constexpr Range ranges[] = {
+            { 0x20, 0x7E },     // ASCII
+            { 0x80, 0xFF },     // Latin-1
+            { 0x400, 0x4FF },   // Cyrillic
+            { 0x7C0, 0x7FF },   // the top of two bytes
+            { 0x800, 0x8FF },   // the bottom of three
+            { 0x4E00, 0x9FFF }, // CJK
+            { 0xD800, 0xDBFF }, // high surrogates
+            { 0xDC00, 0xDFFF }, // low surrogates
+            { 0xE000, 0xFFFF },
+        };
+
+        std::u16string text;
+        while (text.size() < length)
+        {
+            const auto& range = ranges[random() % std::size(ranges)];
+            for (auto run = random() % 24 + 1; run && text.size() < length; run--)
+            {
+                if (random() % 8 == 0)
+                {
+                    // A proper pair.
+                    text += static_cast<char16_t>(0xD800 + random() % 0x400);
+                    text += static_cast<char16_t>(0xDC00 + random() % 0x400);
+                }
+                else if (random() % 16 == 0)
+                {
+                    text += static_cast<char16_t>(u'a' + random() % 26);
+                }
+                else
+                {
+                    text += static_cast<char16_t>(range.first + random() % (range.last - range.first + 1));
+                }
+            }
+        }
+        text.resize(length);
+        return text;
+    }
+
+    // Transcodes s into a buffer with guard bytes behind the exact length.
+    std::string transcode(const char16_t* s, std::size_t n)
+    {
+        const auto length = utf8_detail::length(s, n);
+        std::string buffer(length + 16, '\x5A');
+        auto end = utf8_detail::write(s, n, buffer.data());
+        EXPECT_EQ(static_cast<std::size_t>(end - buffer.data()), length);
+        EXPECT_EQ(buffer.substr(length), std::string(16, '\x5A'));
+        buffer.resize(length);
+        return buffer;
+    }
+}
+
+TEST(Utf8Transcode, MatchesReference)
+{
+    std::mt19937 random{ 42 };
+    for (int round = 0; round < 20000; round++)
+    {
+        const auto text = randomText(random, random() % 70);
+        const auto offset = text.empty() ? 0 : random() % text.size(); // any alignment
+        const auto expected = referenceUtf8(text.substr(offset));
+
+        ASSERT_EQ(transcode(text.data() + offset, text.size() - offset), expected) << "round " << round;
+        ASSERT_EQ(utf8_detail::lengthScalar(text.data() + offset, text.size() - offset), expected.size());
+    }
+}
+
+TEST(Utf8Transcode, MixedTwoByteBlocks)
+{
+    // Every mix of ASCII and two-byte units across one block, so each unit is the last of its kind somewhere.
+    for (unsigned mix = 0; mix < 256; mix++)
+    {
+        std::u16string text;
+        for (int k = 0; k < 8; k++)
+        {
+            text += (mix >> k) & 1 ? static_cast<char16_t>(0x430 + k * 0x3F) : static_cast<char16_t>(u'A' + k);
+        }
+        text += u"tail";
+        ASSERT_EQ(transcode(text.data(), text.size()), referenceUtf8(text)) << mix;
+    }
+}
+
+TEST(Utf8Transcode, SurrogatesAcrossBlocks)
+{
+    // A pair split over two blocks, and unpaired halves at either end of a block.
+    std::u16string pair = u"abcdefg\U0001F600hijklmn";
+    EXPECT_EQ(transcode(pair.data(), pair.size()), "abcdefg\xF0\x9F\x98\x80hijklmn");
+
+    std::u16string lone = u"\xDC00" u"bcdefg" u"\xD800" u"ijklmnop";
+    EXPECT_EQ(transcode(lone.data(), lone.size()), "\xEF\xBF\xBD" "bcdefg" "\xEF\xBF\xBD" "ijklmnop");
+
+    std::u16string trailing = u"abcdefgh\xD83D";
+    EXPECT_EQ(transcode(trailing.data(), trailing.size()), "abcdefgh\xEF\xBF\xBD");
+}
+
+TEST(Utf8Transcode, WideStrings)
+{
+    std::wstring text = L"C:\\Users\\\u0411\u043E\u0440\u0438\u0441\\\u6587\u4EF6.txt";
+    std::string utf8(utf8Length(text), '\0');
+    EXPECT_EQ(writeUtf8(text, utf8.data()), utf8.data() + utf8.size());
+    EXPECT_EQ(utf8, "C:\\Users\\\xD0\x91\xD0\xBE\xD1\x80\xD0\xB8\xD1\x81\\\xE6\x96\x87\xE4\xBB\xB6.txt");
+}